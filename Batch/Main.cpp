@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 10:04:51pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <JuceHeader.h>
+#include "../Source/BatchRenderer.h"
+
+namespace
+{
+    struct NamedParameter
+    {
+        const char* name;
+        float SynthParameters::* field;
+    };
+
+    // The same names as the plugin's parameter IDs.
+    #define NAMED_PARAMETER(name) { #name, &SynthParameters::name },
+    const NamedParameter namedParameters[] =
+    {
+        NAMED_PARAMETER(oscMix)
+        NAMED_PARAMETER(oscTune)
+        NAMED_PARAMETER(oscFine)
+        NAMED_PARAMETER(filterFreq)
+        NAMED_PARAMETER(filterReso)
+        NAMED_PARAMETER(filterEnv)
+        NAMED_PARAMETER(filterLFO)
+        NAMED_PARAMETER(filterVelocity)
+        NAMED_PARAMETER(filterAttack)
+        NAMED_PARAMETER(filterDecay)
+        NAMED_PARAMETER(filterSustain)
+        NAMED_PARAMETER(filterRelease)
+        NAMED_PARAMETER(envAttack)
+        NAMED_PARAMETER(envDecay)
+        NAMED_PARAMETER(envSustain)
+        NAMED_PARAMETER(envRelease)
+        NAMED_PARAMETER(lfoRate)
+        NAMED_PARAMETER(vibrato)
+        NAMED_PARAMETER(noise)
+        NAMED_PARAMETER(octave)
+        NAMED_PARAMETER(tuning)
+        NAMED_PARAMETER(outputLevel)
+        NAMED_PARAMETER(polyphony)
+        NAMED_PARAMETER(wavetablePosition)
+        NAMED_PARAMETER(partials)
+        NAMED_PARAMETER(partialTilt)
+        NAMED_PARAMETER(partialBalance)
+        NAMED_PARAMETER(partialDecay)
+    };
+    #undef NAMED_PARAMETER
+
+    float SynthParameters::* findParameter(const juce::String& name)
+    {
+        for (const auto& parameter : namedParameters)
+        {
+            if (name == parameter.name)
+            {
+                return parameter.field;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    std::vector<T> parseList(const juce::String& text)
+    {
+        std::vector<T> values;
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", ""))
+        {
+            values.push_back(T(token.getDoubleValue()));
+        }
+        return values;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "usage: SubSynthBatch --output <file> [--notes 48,60,...] [--velocities 64,127,...]"
+                  << " [--sweep <parameter>=<v1>,<v2>,...]... [--seconds <s>] [--release <s>]"
+                  << " [--rate <hz>] [--block-size <n>] [--channels 1|2] [--threads <n>]" << std::endl;
+    }
+}
+
+// Renders every combination of the swept parameters, notes and velocities
+// into one file in the BatchRenderer format.
+//
+//     SubSynthBatch --output sweep.ssbr --notes 36,48,60 --velocities 40,100
+//                   --sweep filterFreq=0,50,100 --sweep filterReso=0,40,80
+//
+// Parameters that are not swept keep the plugin's defaults. Each --sweep
+// adds an axis; the last one varies fastest.
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juce;
+    const juce::File workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    BatchRenderer::Sweep sweep;
+    std::vector<BatchRenderer::Axis> axes;
+    juce::File outputFile;
+    int numThreads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--output" && hasValue)
+        {
+            outputFile = workingDirectory.getChildFile(argv[++i]);
+        }
+        else if (argument == "--notes" && hasValue)
+        {
+            sweep.notes = parseList<int>(argv[++i]);
+        }
+        else if (argument == "--velocities" && hasValue)
+        {
+            sweep.velocities = parseList<int>(argv[++i]);
+        }
+        else if (argument == "--sweep" && hasValue)
+        {
+            const juce::String axis(argv[++i]);
+            const auto field = findParameter(axis.upToFirstOccurrenceOf("=", false, false).trim());
+            if (field == nullptr || !axis.containsChar('='))
+            {
+                std::cerr << "SubSynthBatch: unknown parameter in --sweep " << axis << std::endl;
+                return 2;
+            }
+            axes.push_back({ field, parseList<float>(axis.fromFirstOccurrenceOf("=", false, false)) });
+        }
+        else if (argument == "--seconds" && hasValue)
+        {
+            sweep.noteSeconds = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--release" && hasValue)
+        {
+            sweep.releaseSeconds = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--rate" && hasValue)
+        {
+            sweep.sampleRate = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--block-size" && hasValue)
+        {
+            sweep.blockSize = juce::String(argv[++i]).getIntValue();
+        }
+        else if (argument == "--channels" && hasValue)
+        {
+            sweep.numChannels = juce::String(argv[++i]).getIntValue();
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            numThreads = juce::String(argv[++i]).getIntValue();
+        }
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (outputFile == juce::File())
+    {
+        printUsage();
+        return 2;
+    }
+
+    const auto isMidiValue = [](int value) { return value >= 0 && value < 128; };
+    if (sweep.notes.empty() || sweep.velocities.empty()
+        || !std::all_of(sweep.notes.begin(), sweep.notes.end(), isMidiValue)
+        || !std::all_of(sweep.velocities.begin(), sweep.velocities.end(), isMidiValue)
+        || std::any_of(axes.begin(), axes.end(), [](const BatchRenderer::Axis& axis) { return axis.values.empty(); }))
+    {
+        std::cerr << "SubSynthBatch: notes, velocities and swept values must be non-empty lists, notes and velocities 0-127"
+                  << std::endl;
+        return 2;
+    }
+
+    if (sweep.noteSeconds < 0.0 || sweep.releaseSeconds < 0.0 || sweep.sampleRate <= 0.0
+        || sweep.blockSize <= 0 || sweep.numChannels < 1 || sweep.numChannels > 2 || numThreads < 0)
+    {
+        std::cerr << "SubSynthBatch: seconds and release must not be negative, rate and block size must be positive,"
+                  << " channels 1 or 2" << std::endl;
+        return 2;
+    }
+
+    sweep.patches = BatchRenderer::makeGrid(SynthParameters(), axes);
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    juce::String error;
+    if (!BatchRenderer::run(sweep, outputFile, error, numThreads))
+    {
+        std::cerr << "SubSynthBatch: " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << sweep.getNumRenders() << " renders of " << sweep.getRenderLength() << " samples written to "
+              << outputFile.getFullPathName() << " in "
+              << juce::String((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2) << " s" << std::endl;
+    return 0;
+}
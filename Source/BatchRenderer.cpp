@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 18 Oct 2026 9:41:08pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+
+namespace
+{
+    using namespace BatchRenderer;
+
+    // Large enough that mapping costs nothing next to rendering, small
+    // enough that a 32-bit address space is not a concern.
+    constexpr int64_t maxChunkBytes = int64_t(64) << 20;
+
+    // One engine and its scratch block, reused for every render of a
+    // worker.
+    class Engine
+    {
+    public:
+        explicit Engine(const Sweep& sweep)
+            : sweep(sweep), block(2, sweep.blockSize)
+        {
+            synth->additive = std::any_of(sweep.patches.begin(), sweep.patches.end(),
+                                          [](const SynthParameters& patch) { return juce::roundToInt(patch.partials) > 0; });
+            synth->allocateResources(sweep.sampleRate, sweep.blockSize);
+        }
+
+        ~Engine()
+        {
+            synth->deallocateResources();
+        }
+
+        void render(int patch, int note, int velocity, float* const* channels)
+        {
+            // Applied on both sides of resetToIdle() so the smoothers start
+            // settled at this patch rather than ramping from the previous
+            // render's, and the filters start from idle as in a fresh engine,
+            // which keeps every render independent of the order they run in.
+            const SynthParameters& parameters = sweep.patches[size_t(patch)];
+            parameters.applyTo(*synth, sweep.sampleRate);
+            synth->resetToIdle();
+            parameters.applyTo(*synth, sweep.sampleRate);
+
+            const auto key = uint8_t(sweep.notes[size_t(note)]);
+            const int noteLength = sweep.getNoteLength();
+            const int renderLength = sweep.getRenderLength();
+
+            synth->midiMessage(0x90, key, uint8_t(sweep.velocities[size_t(velocity)]));
+
+            for (int blockStart = 0; blockStart < renderLength; blockStart += sweep.blockSize)
+            {
+                const int blockLength = std::min(sweep.blockSize, renderLength - blockStart);
+                int offset = 0;
+
+                if (noteLength >= blockStart && noteLength < blockStart + blockLength)
+                {
+                    offset = noteLength - blockStart;
+                    if (offset > 0)
+                    {
+                        synth->render(block, 0, offset, sweep.numChannels);
+                    }
+                    synth->midiMessage(0x80, key, 0);
+                }
+
+                if (offset < blockLength)
+                {
+                    synth->render(block, offset, blockLength - offset, sweep.numChannels);
+                }
+
+                for (int channel = 0; channel < sweep.numChannels; ++channel)
+                {
+                    juce::FloatVectorOperations::copy(channels[channel] + blockStart, block.getReadPointer(channel), blockLength);
+                }
+            }
+        }
+
+    private:
+        const Sweep& sweep;
+        std::unique_ptr<Synth<float>> synth = std::make_unique<Synth<float>>();
+        juce::AudioBuffer<float> block;
+    };
+
+    struct Schedule
+    {
+        int64_t rendersPerChunk = 1;
+        int64_t numChunks = 0;
+        std::atomic<int64_t> nextChunk { 0 };
+        std::atomic<bool> failed { false };
+    };
+
+    class Worker : public juce::ThreadPoolJob
+    {
+    public:
+        Worker(const Sweep& sweep, const juce::File& file, Schedule& schedule)
+            : juce::ThreadPoolJob("SubSynth batch render"), sweep(sweep), file(file), schedule(schedule)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            Engine engine(sweep);
+
+            const int64_t renderSize = int64_t(sweep.numChannels) * sweep.getRenderLength();
+            const int64_t numRenders = sweep.getNumRenders();
+            const auto numNotes = int64_t(sweep.notes.size());
+            const auto numVelocities = int64_t(sweep.velocities.size());
+            std::array<float*, 2> channels {};
+
+            while (!shouldExit() && !schedule.failed.load())
+            {
+                const int64_t chunk = schedule.nextChunk.fetch_add(1);
+                if (chunk >= schedule.numChunks)
+                {
+                    break;
+                }
+
+                const int64_t first = chunk * schedule.rendersPerChunk;
+                const int64_t last = std::min(first + schedule.rendersPerChunk, numRenders);
+                const int64_t start = FileHeader::size + first * renderSize * int64_t(sizeof(float));
+                const int64_t end = FileHeader::size + last * renderSize * int64_t(sizeof(float));
+
+                // The mapping starts on a page boundary at or before start.
+                juce::MemoryMappedFile mapped(file, juce::Range<juce::int64>(start, end), juce::MemoryMappedFile::readWrite);
+                if (mapped.getData() == nullptr)
+                {
+                    schedule.failed.store(true);
+                    break;
+                }
+                auto* data = reinterpret_cast<float*>(static_cast<char*>(mapped.getData()) + (start - mapped.getRange().getStart()));
+
+                for (int64_t render = first; render < last; ++render)
+                {
+                    float* output = data + (render - first) * renderSize;
+                    for (int channel = 0; channel < sweep.numChannels; ++channel)
+                    {
+                        channels[size_t(channel)] = output + int64_t(channel) * sweep.getRenderLength();
+                    }
+
+                    const auto velocity = int(render % numVelocities);
+                    const auto note = int((render / numVelocities) % numNotes);
+                    const auto patch = int(render / (numVelocities * numNotes));
+                    engine.render(patch, note, velocity, channels.data());
+                }
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        const Sweep& sweep;
+        const juce::File file;
+        Schedule& schedule;
+    };
+
+    bool writeHeader(const Sweep& sweep, const juce::File& file, juce::String& error)
+    {
+        const int64_t fileSize = FileHeader::size
+                               + sweep.getNumRenders() * sweep.numChannels * sweep.getRenderLength() * int64_t(sizeof(float));
+
+        file.deleteFile();
+        {
+            juce::FileOutputStream stream(file);
+            if (!stream.openedOk())
+            {
+                error = "Cannot create " + file.getFullPathName();
+                return false;
+            }
+
+            stream.writeInt(int(FileHeader::magic));
+            stream.writeInt(int(FileHeader::version));
+            stream.writeInt64(sweep.getNumRenders());
+            stream.writeInt64(int64_t(sweep.patches.size()));
+            stream.writeInt64(int64_t(sweep.notes.size()));
+            stream.writeInt64(int64_t(sweep.velocities.size()));
+            stream.writeInt(sweep.numChannels);
+            stream.writeInt(sweep.getRenderLength());
+            stream.writeDouble(sweep.sampleRate);
+
+            // Growing the file this way leaves it sparse; the workers fill
+            // in every byte after the header.
+            stream.setPosition(fileSize);
+            stream.truncate();
+        }
+
+        if (file.getSize() != fileSize)
+        {
+            error = "Cannot allocate " + juce::String(fileSize) + " bytes for " + file.getFullPathName();
+            return false;
+        }
+        return true;
+    }
+}
+
+std::vector<SynthParameters> BatchRenderer::makeGrid(const SynthParameters& base, const std::vector<Axis>& axes)
+{
+    std::vector<SynthParameters> grid { base };
+    for (const Axis& axis : axes)
+    {
+        std::vector<SynthParameters> next;
+        next.reserve(grid.size() * axis.values.size());
+        for (const SynthParameters& parameters : grid)
+        {
+            for (float value : axis.values)
+            {
+                next.push_back(parameters);
+                next.back().*(axis.field) = value;
+            }
+        }
+        grid = std::move(next);
+    }
+    return grid;
+}
+
+int64_t BatchRenderer::Sweep::getNumRenders() const
+{
+    return int64_t(patches.size()) * int64_t(notes.size()) * int64_t(velocities.size());
+}
+
+int BatchRenderer::Sweep::getNoteLength() const
+{
+    return juce::roundToInt(noteSeconds * sampleRate);
+}
+
+int BatchRenderer::Sweep::getRenderLength() const
+{
+    return getNoteLength() + juce::roundToInt(releaseSeconds * sampleRate);
+}
+
+bool BatchRenderer::run(const Sweep& sweep, const juce::File& file, juce::String& error, int numThreads)
+{
+    if (sweep.getNumRenders() == 0 || sweep.getRenderLength() <= 0)
+    {
+        error = "The sweep is empty.";
+        return false;
+    }
+    if (sweep.numChannels < 1 || sweep.numChannels > 2 || sweep.blockSize <= 0)
+    {
+        error = "The sweep needs one or two channels and a positive block size.";
+        return false;
+    }
+
+    if (!writeHeader(sweep, file, error))
+    {
+        return false;
+    }
+
+    if (numThreads <= 0)
+    {
+        numThreads = juce::SystemStats::getNumCpus();
+    }
+
+    // A few chunks per worker even for small sweeps, so that the last ones
+    // do not leave most of the pool idle.
+    const int64_t renderBytes = int64_t(sweep.numChannels) * sweep.getRenderLength() * int64_t(sizeof(float));
+    const int64_t numRenders = sweep.getNumRenders();
+    Schedule schedule;
+    schedule.rendersPerChunk = std::max(int64_t(1), std::min(maxChunkBytes / renderBytes,
+                                                             (numRenders + 4 * numThreads - 1) / (4 * numThreads)));
+    schedule.numChunks = (numRenders + schedule.rendersPerChunk - 1) / schedule.rendersPerChunk;
+    numThreads = int(std::min(int64_t(numThreads), schedule.numChunks));
+
+    juce::ThreadPool pool(numThreads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(sweep, file, schedule));
+        pool.addJob(workers.back().get(), false);
+    }
+    for (const auto& worker : workers)
+    {
+        pool.waitForJobToFinish(worker.get(), -1);
+    }
+
+    if (schedule.failed.load())
+    {
+        error = "Cannot map " + file.getFullPathName() + " for writing.";
+        return false;
+    }
+    return true;
+}
+
+void BatchRenderer::renderOne(const Sweep& sweep, int patch, int note, int velocity, float* const* channels)
+{
+    Engine engine(sweep);
+    engine.render(patch, note, velocity, channels);
+}
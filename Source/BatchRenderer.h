@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 18 Oct 2026 9:41:08pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SynthParameters.h"
+
+// Renders every combination of patch, note and velocity into one float
+// array file, for dataset generation and QA sweeps. Each worker owns a bare
+// Synth<float> rather than a plugin instance, allocated once and only reset
+// between renders, and claims chunks of the output file in turn. A chunk
+// is memory-mapped only while it is written, so the file can be far larger
+// than memory, and the workers share nothing but the chunk counter.
+namespace BatchRenderer
+{
+    // One swept parameter and the values it takes.
+    struct Axis
+    {
+        float SynthParameters::* field;
+        std::vector<float> values;
+    };
+
+    // Every combination of the axis values applied to base. The last axis
+    // varies fastest.
+    std::vector<SynthParameters> makeGrid(const SynthParameters& base, const std::vector<Axis>& axes);
+
+    struct Sweep
+    {
+        std::vector<SynthParameters> patches;
+        std::vector<int> notes { 60 };
+        std::vector<int> velocities { 100 };
+
+        double sampleRate = 48000.0;
+        int blockSize = 256;
+        int numChannels = 2;
+
+        // The note is held for noteSeconds, then the render continues
+        // through the release for releaseSeconds.
+        double noteSeconds = 1.0;
+        double releaseSeconds = 0.5;
+
+        int64_t getNumRenders() const;
+        int getNoteLength() const;
+        int getRenderLength() const;
+
+        // Render index of one combination; renders are stored in this order.
+        int64_t getRenderIndex(int patch, int note, int velocity) const
+        {
+            return (int64_t(patch) * int64_t(notes.size()) + note) * int64_t(velocities.size()) + velocity;
+        }
+    };
+
+    // The output file starts with this header, in little-endian order,
+    // followed by the renders as 32-bit floats: render after render, each
+    // one channel after the other.
+    struct FileHeader
+    {
+        static constexpr uint32_t magic = 0x52425353;  // "SSBR"
+        static constexpr uint32_t version = 1;
+        static constexpr int size = 64;
+
+        int64_t numRenders;
+        int64_t numPatches, numNotes, numVelocities;
+        int32_t numChannels;
+        int32_t renderLength;
+        double sampleRate;
+    };
+
+    // Renders the sweep into file, replacing it, on numThreads workers (0
+    // for one per core). Returns false and describes the problem in error
+    // if the file cannot be written.
+    bool run(const Sweep& sweep, const juce::File& file, juce::String& error, int numThreads = 0);
+
+    // Renders one combination into channels[0..numChannels), each
+    // getRenderLength() samples long, with a fresh engine. The reference a
+    // batch render can be checked against.
+    void renderOne(const Sweep& sweep, int patch, int note, int velocity, float* const* channels);
+}
@@ -0,0 +1,720 @@
+/*
+  ==============================================================================
+
+    ConvolutionReverb.cpp
+    Created: 18 Oct 2026 3:02:16pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "ConvolutionReverb.h"
+
+namespace
+{
+    // sum += a * b, over numBins interleaved complex bins.
+    void multiplyAdd(const float* a, const float* b, float* sum, int numBins)
+    {
+        for (int i = 0; i < 2 * numBins; i += 2)
+        {
+            sum[i] += a[i] * b[i] - a[i + 1] * b[i + 1];
+            sum[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+        }
+    }
+
+    bool readImpulseResponse(const juce::File& file, double sampleRate, int maxLength, juce::AudioBuffer<float>& impulseResponse)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        {
+            return false;
+        }
+
+        const double ratio = reader->sampleRate / sampleRate;
+        const int fileLength = int(std::min<juce::int64>(reader->lengthInSamples, juce::int64(std::ceil(maxLength * ratio))));
+        const int numChannels = std::min(int(reader->numChannels), 2);
+
+        // A few samples of silence past the end let the interpolator finish.
+        juce::AudioBuffer<float> source(numChannels, fileLength + 8);
+        source.clear();
+        reader->read(&source, 0, fileLength, 0, true, numChannels > 1);
+
+        const int length = std::min(maxLength, std::max(1, int(double(fileLength) / ratio)));
+        impulseResponse.setSize(numChannels, length);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (ratio == 1.0)
+            {
+                impulseResponse.copyFrom(channel, 0, source, channel, 0, length);
+            }
+            else
+            {
+                juce::LagrangeInterpolator interpolator;
+                interpolator.process(ratio, source.getReadPointer(channel), impulseResponse.getWritePointer(channel), length);
+            }
+        }
+        return true;
+    }
+
+    // Decorrelated noise with a 60 dB exponential decay over decayMs. The
+    // noise is seeded so a preset always gets the same room.
+    void createRoom(double sampleRate, int decayMs, juce::AudioBuffer<float>& impulseResponse)
+    {
+        const int length = int(double(decayMs) * 0.001 * sampleRate);
+        const float decayPerSample = std::log(0.001f) / float(length);
+
+        impulseResponse.setSize(2, length);
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            juce::Random random(4711 + channel);
+            float* data = impulseResponse.getWritePointer(channel);
+            for (int i = 0; i < length; ++i)
+            {
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * std::exp(decayPerSample * float(i));
+            }
+        }
+    }
+}
+
+ConvolutionReverb::ConvolutionReverb()
+    : juce::Thread("SubSynth reverb tail"),
+      kernelState(std::make_shared<KernelState>())
+{
+    for (auto& block : tailOutputBlocks)
+    {
+        block.store(-1);
+    }
+
+    // The state outlives the reverb while a loader job holds it, so the
+    // check only looks at the state.
+    kernelState->holders.keepWhileInUse([state = kernelState.get()](const Holder& holder)
+    {
+        return holder.kernel.get() == state->kernelInUse.load();
+    });
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    release();
+}
+
+void ConvolutionReverb::prepare(double newSampleRate)
+{
+    release();
+    sampleRate.store(newSampleRate);
+
+    for (HeadChannel& channel : head)
+    {
+        channel.block.assign(headPartitionSize, 0.0f);
+        channel.spectra.assign(size_t(maxHeadPartitions * spectrumSize(headPartitionSize)), 0.0f);
+        channel.history.assign(size_t(spectrumSize(headPartitionSize)), 0.0f);
+        channel.overlap.assign(headPartitionSize, 0.0f);
+    }
+    headScratch.assign(4 * headPartitionSize, 0.0f);
+    headProduct.assign(4 * headPartitionSize, 0.0f);
+
+    // The delay line holds as many partitions as the longest impulse
+    // response can have at this rate.
+    const int maxLength = int(maxDecay * newSampleRate);
+    maxTailPartitions = std::max(1, (maxLength - headLength + tailPartitionSize - 1) / tailPartitionSize);
+    tailSpectra.assign(size_t(2 * maxTailPartitions * spectrumSize(tailPartitionSize)), 0.0f);
+    tailOverlap.assign(2 * tailPartitionSize, 0.0f);
+    tailScratch.assign(4 * tailPartitionSize, 0.0f);
+    tailCopy.assign(2 * tailPartitionSize, 0.0f);
+
+    const size_t inputSize = size_t(inputRingSize * 2 * tailPartitionSize);
+    tailInput.reset(new std::atomic<float>[inputSize]);
+    for (size_t i = 0; i < inputSize; ++i)
+    {
+        tailInput[i].store(0.0f, std::memory_order_relaxed);
+    }
+    tailOutput.assign(size_t(outputRingSize * 2 * tailPartitionSize), 0.0f);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        inputBuffer[size_t(channel)].assign(headPartitionSize, 0.0f);
+        wetBuffer[size_t(channel)].assign(headPartitionSize, 0.0f);
+    }
+    mixSmoother.reset(newSampleRate, 0.05);
+
+    // Nothing else can be using the old kernels now.
+    tailKernel.store(nullptr);
+    kernelState->kernelInUse.store(nullptr);
+    collectGarbage();
+    requestKernel(true);
+
+    tailBlock = 0;
+    tailInputBlocks.store(0);
+    tailBlocksDone.store(0);
+    for (auto& block : tailOutputBlocks)
+    {
+        block.store(-1);
+    }
+    resyncTail(0);
+    tailOverruns = 0;
+    prepared = true;
+    reset();
+
+    startRealtimeThread(juce::Thread::RealtimeOptions().withApproximateAudioProcessingTime(tailPartitionSize, newSampleRate));
+}
+
+void ConvolutionReverb::release()
+{
+    if (!prepared)
+    {
+        return;
+    }
+    signalThreadShouldExit();
+    wakeUp.signal();
+    stopThread(1000);
+    prepared = false;
+}
+
+void ConvolutionReverb::reset()
+{
+    if (prepared)
+    {
+        restart();
+    }
+    mixSmoother.setCurrentAndTargetValue(mixSmoother.getTargetValue());
+}
+
+void ConvolutionReverb::restart()
+{
+    for (HeadChannel& channel : head)
+    {
+        std::fill(channel.block.begin(), channel.block.end(), 0.0f);
+        std::fill(channel.spectra.begin(), channel.spectra.end(), 0.0f);
+        std::fill(channel.overlap.begin(), channel.overlap.end(), 0.0f);
+    }
+    headPosition = 0;
+    headSpectrum = 0;
+
+    // Skipping a whole input ring makes the worker drop what it has and
+    // start again from the first block after this, and no block from
+    // before can ever be taken for one from after.
+    tailBlock += inputRingSize;
+    firstTailBlock = tailBlock;
+    tailPosition = 0;
+    tailReady = false;
+}
+
+void ConvolutionReverb::setDecay(float decaySeconds)
+{
+    decaySeconds = std::clamp(decaySeconds, minDecay, maxDecay);
+    {
+        const juce::ScopedLock lock(kernelState->lock);
+        if (decaySeconds == kernelState->source.decay)
+        {
+            return;
+        }
+        kernelState->source.decay = decaySeconds;
+        if (kernelState->source.file != juce::File())
+        {
+            return;
+        }
+    }
+    requestKernel(false);
+}
+
+void ConvolutionReverb::loadImpulseResponse(const juce::File& file)
+{
+    {
+        const juce::ScopedLock lock(kernelState->lock);
+        if (file == kernelState->source.file)
+        {
+            return;
+        }
+        kernelState->source.file = file;
+    }
+    requestKernel(false);
+}
+
+juce::File ConvolutionReverb::getImpulseResponseFile() const
+{
+    const juce::ScopedLock lock(kernelState->lock);
+    return kernelState->source.file;
+}
+
+void ConvolutionReverb::requestKernel(bool buildNow)
+{
+    Source source;
+    uint32_t request = 0;
+    {
+        const juce::ScopedLock lock(kernelState->lock);
+        source = kernelState->source;
+        request = ++kernelState->latestRequest;
+    }
+
+    // Before the first prepare there is no rate to build for; prepare()
+    // builds it then.
+    const double rate = sampleRate.load();
+    if (rate <= 0.0)
+    {
+        return;
+    }
+
+    if (buildNow)
+    {
+        kernelState->publish(request, createKernel(source, rate));
+        return;
+    }
+
+    std::weak_ptr<KernelState> weakState = kernelState;
+    SharedTables::getLoaderPool().addJob([weakState, source, rate, request]
+    {
+        auto kernel = createKernel(source, rate);
+        if (auto loaderState = weakState.lock())
+        {
+            loaderState->publish(request, std::move(kernel));
+        }
+    });
+}
+
+void ConvolutionReverb::KernelState::publish(uint32_t request, std::shared_ptr<const Kernel> kernel)
+{
+    // The check and the publish happen under one lock, so a kernel built
+    // for an older rate cannot land after prepare() has published its own.
+    const juce::ScopedLock scopedLock(lock);
+    if (kernel == nullptr || request != latestRequest)
+    {
+        return;
+    }
+    lengthSeconds.store(double(kernel->length) / kernel->sampleRate);
+    holders.publish(std::make_unique<Holder>(Holder { std::move(kernel) }));
+}
+
+void ConvolutionReverb::collectGarbage()
+{
+    kernelState->holders.collectGarbage();
+}
+
+const ConvolutionReverb::Kernel* ConvolutionReverb::acquireKernel()
+{
+    const double rate = sampleRate.load(std::memory_order_relaxed);
+
+    // As with the mod matrix, the swap waits a block while the previous
+    // kernel has not been collected yet. The worker is pointed at the new
+    // kernel before the old one can be collected.
+    const Holder* active = kernelState->holders.acquire([this, rate](const Holder& next)
+    {
+        tailKernel.store(next.kernel->sampleRate == rate ? next.kernel.get() : nullptr);
+    });
+
+    // A kernel for another rate would play at the wrong pitch, so the
+    // reverb stays silent until the one for this rate arrives.
+    const Kernel* kernel = active != nullptr && active->kernel->sampleRate == rate ? active->kernel.get() : nullptr;
+    tailKernel.store(kernel);
+    return kernel;
+}
+
+juce::AudioBuffer<float> ConvolutionReverb::createImpulseResponse(const juce::File& file, float decaySeconds, double sampleRate)
+{
+    juce::AudioBuffer<float> impulseResponse;
+    if (file == juce::File())
+    {
+        createRoom(sampleRate, juce::roundToInt(std::clamp(decaySeconds, minDecay, maxDecay) * 1000.0f), impulseResponse);
+    }
+    else if (!readImpulseResponse(file, sampleRate, int(maxDecay * sampleRate), impulseResponse))
+    {
+        return {};
+    }
+
+    // Normalised the way juce::dsp::Convolution does, so that rooms and
+    // files of any length come out at a similar level.
+    float maxEnergy = 0.0f;
+    for (int channel = 0; channel < impulseResponse.getNumChannels(); ++channel)
+    {
+        const float* data = impulseResponse.getReadPointer(channel);
+        float energy = 0.0f;
+        for (int i = 0; i < impulseResponse.getNumSamples(); ++i)
+        {
+            energy += data[i] * data[i];
+        }
+        maxEnergy = std::max(maxEnergy, energy);
+    }
+    if (maxEnergy > 0.0f)
+    {
+        impulseResponse.applyGain(0.125f / std::sqrt(maxEnergy));
+    }
+    return impulseResponse;
+}
+
+std::shared_ptr<const ConvolutionReverb::Kernel> ConvolutionReverb::createKernel(const Source& source, double sampleRate)
+{
+    // A room is named by its decay in milliseconds, a file by its key.
+    const bool isRoom = source.file == juce::File();
+    const juce::String name = isRoom ? juce::String() : SharedTables::getFileKey(source.file);
+    const int decayMs = isRoom ? juce::roundToInt(std::clamp(source.decay, minDecay, maxDecay) * 1000.0f) : 0;
+
+    return SharedTables::get<Kernel>(name, sampleRate, decayMs, [&source, sampleRate]() -> std::shared_ptr<const Kernel>
+    {
+        const auto impulseResponse = createImpulseResponse(source.file, source.decay, sampleRate);
+        if (impulseResponse.getNumSamples() == 0)
+        {
+            return nullptr;
+        }
+        return std::make_shared<const Kernel>(impulseResponse, sampleRate);
+    });
+}
+
+ConvolutionReverb::Kernel::Kernel(const juce::AudioBuffer<float>& impulseResponse, double rate)
+    : sampleRate(rate),
+      length(impulseResponse.getNumSamples()),
+      numChannels(std::min(impulseResponse.getNumChannels(), 2))
+{
+    numHeadPartitions = (std::min(length, headLength) + headPartitionSize - 1) / headPartitionSize;
+    numTailPartitions = std::max(0, (length - headLength + tailPartitionSize - 1) / tailPartitionSize);
+
+    auto transform = [&](int start, int end, int partitionSize, int numPartitions, std::vector<float>& spectra)
+    {
+        const int size = spectrumSize(partitionSize);
+        const juce::dsp::FFT fft(juce::roundToInt(std::log2(2 * partitionSize)));
+        std::vector<float> scratch(size_t(4 * partitionSize));
+        spectra.resize(size_t(numChannels * numPartitions * size));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* data = impulseResponse.getReadPointer(channel);
+            for (int partition = 0; partition < numPartitions; ++partition)
+            {
+                const int first = start + partition * partitionSize;
+                const int count = std::min(partitionSize, end - first);
+                std::fill(scratch.begin(), scratch.end(), 0.0f);
+                std::copy(data + first, data + first + count, scratch.begin());
+                fft.performRealOnlyForwardTransform(scratch.data(), true);
+                std::copy(scratch.begin(), scratch.begin() + size,
+                          spectra.begin() + (channel * numPartitions + partition) * size);
+            }
+        }
+    };
+
+    transform(0, std::min(length, headLength), headPartitionSize, numHeadPartitions, head);
+    transform(headLength, length, tailPartitionSize, numTailPartitions, tail);
+}
+
+void ConvolutionReverb::setMix(float mix)
+{
+    mixSmoother.setTargetValue(std::clamp(mix, 0.0f, 1.0f));
+}
+
+template <typename SampleType>
+void ConvolutionReverb::process(juce::AudioBuffer<SampleType>& buffer, bool waitForTail)
+{
+    // Fully dry costs nothing. The convolution starts over on the way back
+    // in, so a stale tail does not reappear.
+    if (!mixSmoother.isSmoothing() && mixSmoother.getTargetValue() == 0.0f)
+    {
+        bypassed = true;
+        return;
+    }
+    if (bypassed)
+    {
+        restart();
+        bypassed = false;
+    }
+
+    const Kernel* kernel = acquireKernel();
+    const int numChannels = std::min(buffer.getNumChannels(), 2);
+    const float* inputs[2] = { inputBuffer[0].data(), inputBuffer[1].data() };
+    float* wets[2] = { wetBuffer[0].data(), wetBuffer[1].data() };
+
+    // Chunks never cross a head partition, so they never cross the end of
+    // a tail block either.
+    for (int offset = 0; offset < buffer.getNumSamples();)
+    {
+        const int numSamples = std::min(buffer.getNumSamples() - offset, headPartitionSize - headPosition);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const SampleType* input = buffer.getReadPointer(channel, offset);
+            float* dry = inputBuffer[size_t(channel)].data();
+            for (int i = 0; i < numSamples; ++i)
+            {
+                dry[i] = float(input[i]);
+            }
+            processHead(kernel, channel, dry, wets[channel], numSamples);
+        }
+        exchangeTail(inputs, wets, numChannels, numSamples, waitForTail);
+
+        headPosition += numSamples;
+        if (headPosition == headPartitionSize)
+        {
+            headPosition = 0;
+            headSpectrum = (headSpectrum + 1) % maxHeadPartitions;
+        }
+
+        SampleType* outputs[2] = {};
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            outputs[channel] = buffer.getWritePointer(channel, offset);
+        }
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType mix = SampleType(mixSmoother.getNextValue());
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                outputs[channel][i] = outputs[channel][i] * (SampleType(1) - mix) + SampleType(wets[channel][i]) * mix;
+            }
+        }
+        offset += numSamples;
+    }
+}
+
+void ConvolutionReverb::processHead(const Kernel* kernel, int channel, const float* input, float* wet, int numSamples)
+{
+    HeadChannel& state = head[size_t(channel)];
+    const int size = spectrumSize(headPartitionSize);
+    const int numPartitions = kernel != nullptr ? kernel->numHeadPartitions : 0;
+    const int kernelChannel = kernel != nullptr ? std::min(channel, kernel->numChannels - 1) : 0;
+    auto spectrum = [&](int age)
+    {
+        return state.spectra.data() + size_t((headSpectrum - age + maxHeadPartitions) % maxHeadPartitions) * size;
+    };
+
+    std::copy(input, input + numSamples, state.block.begin() + headPosition);
+
+    // The older partitions only change when a new one starts.
+    if (headPosition == 0)
+    {
+        std::fill(state.history.begin(), state.history.end(), 0.0f);
+        for (int partition = 1; partition < numPartitions; ++partition)
+        {
+            multiplyAdd(spectrum(partition), kernel->getHead(kernelChannel, partition), state.history.data(), headPartitionSize + 1);
+        }
+    }
+
+    // The partition coming in is transformed again on every call, as far
+    // as it has come, which is what keeps the latency at zero.
+    std::fill(headScratch.begin(), headScratch.end(), 0.0f);
+    std::copy(state.block.begin(), state.block.end(), headScratch.begin());
+    headFft.performRealOnlyForwardTransform(headScratch.data(), true);
+    std::copy(headScratch.begin(), headScratch.begin() + size, spectrum(0));
+
+    const bool partitionDone = headPosition + numSamples == headPartitionSize;
+    if (numPartitions == 0)
+    {
+        std::copy(state.overlap.begin() + headPosition, state.overlap.begin() + headPosition + numSamples, wet);
+        if (partitionDone)
+        {
+            std::fill(state.overlap.begin(), state.overlap.end(), 0.0f);
+        }
+    }
+    else
+    {
+        std::fill(headProduct.begin(), headProduct.end(), 0.0f);
+        std::copy(state.history.begin(), state.history.end(), headProduct.begin());
+        multiplyAdd(spectrum(0), kernel->getHead(kernelChannel, 0), headProduct.data(), headPartitionSize + 1);
+        headFft.performRealOnlyInverseTransform(headProduct.data());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            wet[i] = headProduct[size_t(headPosition + i)] + state.overlap[size_t(headPosition + i)];
+        }
+        if (partitionDone)
+        {
+            std::copy(headProduct.begin() + headPartitionSize, headProduct.begin() + 2 * headPartitionSize, state.overlap.begin());
+        }
+    }
+
+    if (partitionDone)
+    {
+        std::fill(state.block.begin(), state.block.end(), 0.0f);
+    }
+}
+
+void ConvolutionReverb::exchangeTail(const float* const* input, float* const* wet, int numChannels, int numSamples, bool waitForTail)
+{
+    std::atomic<float>* slot = tailInput.get() + size_t(tailBlock % inputRingSize) * 2 * tailPartitionSize;
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        std::atomic<float>* destination = slot + channel * tailPartitionSize + tailPosition;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destination[i].store(channel < numChannels ? input[channel][i] : 0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    // The block played now was fed in two blocks ago.
+    if (tailReady)
+    {
+        const float* played = tailOutput.data() + size_t(tailBlock % outputRingSize) * 2 * tailPartitionSize;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            juce::FloatVectorOperations::add(wet[channel], played + channel * tailPartitionSize + tailPosition, numSamples);
+        }
+    }
+
+    tailPosition += numSamples;
+    if (tailPosition < tailPartitionSize)
+    {
+        return;
+    }
+
+    ++tailBlock;
+    tailPosition = 0;
+
+    // The fence orders the count before the samples of the next block, so
+    // a worker that copied any of them also sees that its block is gone.
+    tailInputBlocks.store(tailBlock, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    {
+        // Waking the worker takes a brief mutex inside WaitableEvent; the
+        // worker never holds it while convolving.
+        SUBSYNTH_REALTIME_ALLOW;
+        wakeUp.signal();
+    }
+
+    tailReady = pickUpTail(waitForTail);
+}
+
+bool ConvolutionReverb::pickUpTail(bool waitForTail)
+{
+    const juce::int64 block = tailBlock - 2;
+    if (block < firstTailBlock)
+    {
+        return false;
+    }
+
+    if (waitForTail)
+    {
+        // Offline, so the wait is allowed.
+        SUBSYNTH_REALTIME_ALLOW;
+        while (tailBlocksDone.load(std::memory_order_acquire) <= block && isThreadRunning())
+        {
+            tailDone.wait(10);
+        }
+    }
+
+    if (tailOutputBlocks[size_t(block % outputRingSize)].load(std::memory_order_acquire) == block)
+    {
+        return true;
+    }
+    ++tailOverruns;
+    return false;
+}
+
+void ConvolutionReverb::run()
+{
+    while (!threadShouldExit())
+    {
+        {
+            SUBSYNTH_REALTIME_SCOPE;
+            while (processTailBlock())
+            {
+            }
+        }
+        wakeUp.wait(100);
+    }
+}
+
+void ConvolutionReverb::resyncTail(juce::int64 block)
+{
+    std::fill(tailSpectra.begin(), tailSpectra.end(), 0.0f);
+    std::fill(tailOverlap.begin(), tailOverlap.end(), 0.0f);
+    tailSpectrum = 0;
+    nextTailBlock = block;
+}
+
+bool ConvolutionReverb::processTailBlock()
+{
+    const juce::int64 available = tailInputBlocks.load(std::memory_order_acquire);
+    if (nextTailBlock >= available)
+    {
+        return false;
+    }
+
+    // Fallen so far behind that the blocks waiting may be overwritten
+    // already: start again from the newest one.
+    if (available - nextTailBlock > inputRingSize - 2)
+    {
+        resyncTail(available - 1);
+    }
+
+    const juce::int64 block = nextTailBlock;
+    const std::atomic<float>* slot = tailInput.get() + size_t(block % inputRingSize) * 2 * tailPartitionSize;
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* copy = tailCopy.data() + channel * tailPartitionSize;
+        for (int i = 0; i < tailPartitionSize; ++i)
+        {
+            copy[i] = slot[channel * tailPartitionSize + i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // The audio thread starts overwriting this block once it has counted
+    // inputRingSize more. If it had, the copy may be torn; the next call
+    // starts over.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (tailInputBlocks.load(std::memory_order_relaxed) >= block + inputRingSize)
+    {
+        return true;
+    }
+
+    const Kernel* kernel = tailKernel.load();
+    for (;;)
+    {
+        kernelState->kernelInUse.store(kernel);
+        const Kernel* current = tailKernel.load();
+        if (current == kernel)
+        {
+            break;
+        }
+        kernel = current;
+    }
+
+    const int size = spectrumSize(tailPartitionSize);
+    const int numPartitions = kernel != nullptr ? std::min(kernel->numTailPartitions, maxTailPartitions) : 0;
+    float* output = tailOutput.data() + size_t(block % outputRingSize) * 2 * tailPartitionSize;
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* spectra = tailSpectra.data() + size_t(channel * maxTailPartitions) * size;
+        float* overlap = tailOverlap.data() + channel * tailPartitionSize;
+        float* played = output + channel * tailPartitionSize;
+
+        std::fill(tailScratch.begin(), tailScratch.end(), 0.0f);
+        std::copy(tailCopy.begin() + channel * tailPartitionSize, tailCopy.begin() + (channel + 1) * tailPartitionSize,
+                  tailScratch.begin());
+        tailFft.performRealOnlyForwardTransform(tailScratch.data(), true);
+        std::copy(tailScratch.begin(), tailScratch.begin() + size, spectra + size_t(tailSpectrum) * size);
+
+        if (numPartitions == 0)
+        {
+            std::copy(overlap, overlap + tailPartitionSize, played);
+            std::fill(overlap, overlap + tailPartitionSize, 0.0f);
+            continue;
+        }
+
+        const int kernelChannel = std::min(channel, kernel->numChannels - 1);
+        std::fill(tailScratch.begin(), tailScratch.end(), 0.0f);
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            const int age = (tailSpectrum - partition + maxTailPartitions) % maxTailPartitions;
+            multiplyAdd(spectra + size_t(age) * size, kernel->getTail(kernelChannel, partition), tailScratch.data(), tailPartitionSize + 1);
+        }
+        tailFft.performRealOnlyInverseTransform(tailScratch.data());
+
+        for (int i = 0; i < tailPartitionSize; ++i)
+        {
+            played[i] = tailScratch[size_t(i)] + overlap[i];
+        }
+        std::copy(tailScratch.begin() + tailPartitionSize, tailScratch.begin() + 2 * tailPartitionSize, overlap);
+    }
+
+    kernelState->kernelInUse.store(nullptr);
+    tailSpectrum = (tailSpectrum + 1) % maxTailPartitions;
+    tailOutputBlocks[size_t(block % outputRingSize)].store(block, std::memory_order_release);
+    nextTailBlock = block + 1;
+    tailBlocksDone.store(nextTailBlock, std::memory_order_release);
+    {
+        SUBSYNTH_REALTIME_ALLOW;
+        tailDone.signal();
+    }
+    return true;
+}
+
+template void ConvolutionReverb::process(juce::AudioBuffer<float>&, bool);
+template void ConvolutionReverb::process(juce::AudioBuffer<double>&, bool);
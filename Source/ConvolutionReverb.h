@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    ConvolutionReverb.h
+    Created: 18 Oct 2026 3:02:16pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Handoff.h"
+#include "SharedTables.h"
+#include "RealtimeAudit.h"
+
+// Stereo convolution reverb for the summed synth output, partitioned in two
+// stages. The head, the first 2 * tailPartitionSize samples of the impulse
+// response, runs on the audio thread in short uniform partitions with zero
+// latency. The rest runs on a worker thread in long partitions: the audio
+// thread hands it every tailPartitionSize samples of input and picks the
+// result up one block later, when the head has run out. The audio thread's
+// share of the work therefore does not depend on the length of the tail.
+//
+// The audio thread never waits for the worker. A tail block that is not
+// ready when it is due is left out and counted as an overrun; only offline
+// rendering waits for it.
+//
+// Impulse responses are read, resampled and transformed on the loader
+// thread, for the sample rate they were built at, and swapped in at the
+// start of a block.
+class ConvolutionReverb : private juce::Thread
+{
+public:
+    static constexpr int headPartitionSize = 256;
+    static constexpr int tailPartitionSize = 4096;
+    static constexpr float minDecay = 0.3f;
+    static constexpr float maxDecay = 10.0f;
+
+    ConvolutionReverb();
+    ~ConvolutionReverb() override;
+
+    // Message thread, with processing stopped. The impulse response for
+    // the new rate is built before this returns, so even an offline render
+    // that starts straight away has its reverb.
+    void prepare(double sampleRate);
+    void release();
+    void reset();
+
+    // Message thread. Builds a synthetic room (decorrelated noise with a
+    // 60 dB exponential decay over decaySeconds), unless a file is loaded.
+    void setDecay(float decaySeconds);
+
+    // Message thread. Convolves with an audio file instead of the room, or
+    // goes back to the room for a default File. The file is read on the
+    // loader thread; mono files feed both channels, and anything past
+    // maxDecay seconds is cut. The current impulse response stays if the
+    // file cannot be read.
+    void loadImpulseResponse(const juce::File& file);
+    juce::File getImpulseResponseFile() const;
+
+    // Message thread. Releases the impulse responses the audio thread and
+    // the worker have let go of.
+    void collectGarbage();
+
+    // The length of the impulse response last built, in seconds.
+    double getLengthSeconds() const { return kernelState->lengthSeconds.load(); }
+
+    // 0 is dry only, 1 is wet only. Safe to call from the audio thread.
+    void setMix(float mix);
+
+    // Audio thread. With waitForTail, for offline rendering, a late tail
+    // block is waited for rather than left out.
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, bool waitForTail = false);
+
+    // Tail blocks left out since prepare() because the worker was late.
+    // Read it from the audio thread or while processing is stopped.
+    int getTailOverruns() const { return tailOverruns; }
+
+    // The impulse response the reverb plays at this rate: the file if one
+    // is given, otherwise the room, resampled and normalised. Empty if the
+    // file cannot be read. Blocks; never call it on the audio thread.
+    static juce::AudioBuffer<float> createImpulseResponse(const juce::File& file, float decaySeconds, double sampleRate);
+
+private:
+    static constexpr int headLength = 2 * tailPartitionSize;
+    static constexpr int maxHeadPartitions = headLength / headPartitionSize;
+    static constexpr int headFftOrder = 9;
+    static constexpr int tailFftOrder = 13;
+
+    // Input blocks waiting for the worker, and tail blocks waiting to be
+    // played. The input ring must leave the worker room to fall behind by
+    // a block; two output blocks are enough, because the worker cannot
+    // start one before the audio thread has finished with the block in
+    // the same slot.
+    static constexpr int inputRingSize = 4;
+    static constexpr int outputRingSize = 2;
+
+    static_assert(1 << headFftOrder == 2 * headPartitionSize, "the head transforms two partitions");
+    static_assert(1 << tailFftOrder == 2 * tailPartitionSize, "the tail transforms two partitions");
+    static_assert(tailPartitionSize % headPartitionSize == 0, "tail blocks must end on a head partition");
+
+    // The spectrum of one partition, as interleaved complex bins from DC to
+    // Nyquist.
+    static constexpr int spectrumSize(int partitionSize) { return 2 * (partitionSize + 1); }
+
+    // An impulse response cut into the partitions of both stages and
+    // transformed. Immutable once built, and shared through SharedTables by
+    // every instance playing the same room or file at the same rate.
+    struct Kernel
+    {
+        Kernel(const juce::AudioBuffer<float>& impulseResponse, double sampleRate);
+
+        const float* getHead(int channel, int partition) const
+        {
+            return head.data() + size_t(channel * numHeadPartitions + partition) * spectrumSize(headPartitionSize);
+        }
+
+        const float* getTail(int channel, int partition) const
+        {
+            return tail.data() + size_t(channel * numTailPartitions + partition) * spectrumSize(tailPartitionSize);
+        }
+
+        double sampleRate;
+        int length;
+        int numChannels;
+        int numHeadPartitions;
+        int numTailPartitions;
+        std::vector<float> head;
+        std::vector<float> tail;
+    };
+
+    // What the impulse response is built from.
+    struct Source
+    {
+        float decay = 0.0f;
+        juce::File file;
+    };
+
+    struct Holder
+    {
+        std::shared_ptr<const Kernel> kernel;
+    };
+
+    // Shared with the loader jobs, so that a job finishing after the
+    // reverb is gone has somewhere harmless to publish to.
+    struct KernelState
+    {
+        // Any thread but the audio thread. Drops kernels of stale requests.
+        void publish(uint32_t request, std::shared_ptr<const Kernel> kernel);
+
+        juce::CriticalSection lock;
+        Source source;            // guarded by lock
+        uint32_t latestRequest = 0; // guarded by lock
+        std::atomic<double> lengthSeconds { 0.0 };
+
+        // The kernel the worker is convolving with right now. A retired
+        // kernel is only freed once the worker no longer uses it.
+        std::atomic<const Kernel*> kernelInUse { nullptr };
+        Handoff<Holder> holders;
+    };
+
+    // Blocks while the kernel is built, or while another instance builds
+    // the same one.
+    static std::shared_ptr<const Kernel> createKernel(const Source& source, double sampleRate);
+    void requestKernel(bool buildNow);
+
+    // Audio thread. The newest kernel, or nullptr while there is none for
+    // the prepared rate.
+    const Kernel* acquireKernel();
+
+    // Audio thread, or with processing stopped. Starts over with silence.
+    void restart();
+
+    void processHead(const Kernel* kernel, int channel, const float* input, float* wet, int numSamples);
+    void exchangeTail(const float* const* input, float* const* wet, int numChannels, int numSamples, bool waitForTail);
+    bool pickUpTail(bool waitForTail);
+
+    // The worker.
+    void run() override;
+    bool processTailBlock();
+    void resyncTail(juce::int64 block);
+
+    std::shared_ptr<KernelState> kernelState;
+    std::atomic<double> sampleRate { 0.0 };
+
+    // The head, on the audio thread.
+    struct HeadChannel
+    {
+        std::vector<float> block;    // the partition coming in
+        std::vector<float> spectra;  // the last maxHeadPartitions partitions
+        std::vector<float> history;  // their products, but for the newest
+        std::vector<float> overlap;
+    };
+    std::array<HeadChannel, 2> head;
+    std::vector<float> headScratch;
+    std::vector<float> headProduct;
+    juce::dsp::FFT headFft { headFftOrder };
+    int headPosition = 0;
+    int headSpectrum = 0;
+
+    // The tail, as the audio thread sees it. Input samples are atomics so
+    // the worker may check a block after copying it rather than lock it.
+    std::unique_ptr<std::atomic<float>[]> tailInput;
+    std::vector<float> tailOutput;
+    std::array<std::atomic<juce::int64>, outputRingSize> tailOutputBlocks;
+    std::atomic<juce::int64> tailInputBlocks { 0 };
+    std::atomic<juce::int64> tailBlocksDone { 0 };
+    juce::int64 tailBlock = 0;      // the input block coming in
+    juce::int64 firstTailBlock = 0; // since the last restart
+    int tailPosition = 0;
+    bool tailReady = false;
+    int tailOverruns = 0;
+
+    // The kernel the worker convolves with, set by the audio thread. The
+    // one it is using right now is kernelState->kernelInUse.
+    std::atomic<const Kernel*> tailKernel { nullptr };
+
+    // The tail, on the worker.
+    std::vector<float> tailSpectra;
+    std::vector<float> tailOverlap;
+    std::vector<float> tailScratch;
+    std::vector<float> tailCopy;
+    juce::dsp::FFT tailFft { tailFftOrder };
+    int maxTailPartitions = 0;
+    int tailSpectrum = 0;
+    juce::int64 nextTailBlock = 0;
+
+    juce::WaitableEvent wakeUp;
+    juce::WaitableEvent tailDone;
+
+    std::array<std::vector<float>, 2> inputBuffer;
+    std::array<std::vector<float>, 2> wetBuffer;
+    juce::LinearSmoothedValue<float> mixSmoother;
+    bool bypassed = true;
+    bool prepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE(ConvolutionReverb)
+};
@@ -12,14 +12,15 @@
 
 const float SILENCE = 0.0001f;
 
+template <typename SampleType = float>
 class Envelope {
 public:
-    float level;
+    SampleType level;
     
-    float attackA;
-    float decayA;
-    float sustainLevel;
-    float releaseA;
+    SampleType attackA;
+    SampleType decayA;
+    SampleType sustainLevel;
+    SampleType releaseA;
     
     void reset()
     {
@@ -28,7 +29,7 @@ public:
         a = 0.0f;
     }
     
-    float nextValue()
+    SampleType nextValue()
     {
         level = a * (level - target) + target;
         if (level + target > 3.0f) {
@@ -60,8 +61,18 @@ public:
         target = 0.0f;
         a = releaseA;
     }
+    
+    // Every stage, including the one in progress, takes 1 / exponent times
+    // as long as it did.
+    void stretch(SampleType exponent)
+    {
+        attackA = std::pow(attackA, exponent);
+        decayA = std::pow(decayA, exponent);
+        releaseA = std::pow(releaseA, exponent);
+        a = std::pow(a, exponent);
+    }
 
 private:
-    float target;
-    float a;
+    SampleType target;
+    SampleType a;
 };
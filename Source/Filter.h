@@ -10,18 +10,193 @@
 
 #pragma once
 
-class Filter : public juce::dsp::LadderFilter<float>
+// 12 dB/oct Moog-style ladder, the same topology as juce::dsp::LadderFilter
+// in LPF12 mode. It is implemented here so that the length of the linear
+// cutoff/resonance ramp is up to the caller (the JUCE filter always smooths
+// over 50 ms) and coefficients can be computed for many voices at once.
+template <typename SampleType = float>
+class Filter
 {
 public:
-    void updateCoefficients(float cutoff, float Q)
+    Filter()
     {
-        setCutoffFrequencyHz(cutoff);
-        setResonance(std::clamp(Q / 30.0f, 0.0f, 1.0f));
+        prepare(1000.0, 50);
     }
 
-    float render(float x)
+    void prepare(double sampleRate, int rampLengthInSamples)
     {
-        updateSmoothers();
-        return processSample(x, 0);
+        cutoffScaler = SampleType(-2.0 * juce::MathConstants<double>::pi) / SampleType(sampleRate);
+        rampLength = rampLengthInSamples;
+        resetToIdle();
     }
+
+    // Clears the state and finishes the ramps at their targets. The engine
+    // does this to every idle voice each block, so the next note on the
+    // voice ramps from where the last one left the cutoff.
+    void reset()
+    {
+        state.fill(SampleType(0));
+        cutoffRamp.jumpToTarget();
+        resonanceRamp.jumpToTarget();
+    }
+
+    // Back to the idle state prepare() leaves, 200 Hz with no resonance,
+    // for a note that must not depend on what the voice played before.
+    void resetToIdle()
+    {
+        resetTo(std::exp(SampleType(200) * cutoffScaler), scaleResonance(SampleType(0)));
+    }
+
+    // Clears the state and puts the ramps straight at these targets, as
+    // setTargets() takes them.
+    void resetTo(SampleType cutoffCoefficient, SampleType scaledResonance)
+    {
+        state.fill(SampleType(0));
+        cutoffRamp.jumpTo(cutoffCoefficient);
+        resonanceRamp.jumpTo(scaledResonance);
+    }
+
+    // The factor that turns a cutoff in Hz into the exponent of the one-pole
+    // coefficient, so callers can compute a whole batch of coefficients.
+    SampleType getCutoffScaler() const
+    {
+        return cutoffScaler;
+    }
+
+    static SampleType scaleResonance(SampleType Q)
+    {
+        SampleType resonance = std::clamp(Q / SampleType(30), SampleType(0), SampleType(1));
+        return SampleType(0.1) + resonance * (SampleType(1) - SampleType(0.1));
+    }
+
+    void updateCoefficients(SampleType cutoff, SampleType Q)
+    {
+        setTargets(std::exp(cutoff * cutoffScaler), scaleResonance(Q));
+    }
+
+    void setTargets(SampleType cutoffCoefficient, SampleType scaledResonance)
+    {
+        cutoffRamp.setTarget(cutoffCoefficient, rampLength);
+        resonanceRamp.setTarget(scaledResonance, rampLength);
+    }
+
+    SampleType render(SampleType x)
+    {
+        const SampleType a1 = cutoffRamp.next();
+        const SampleType resonance = resonanceRamp.next();
+        const SampleType g = a1 * SampleType(-1) + SampleType(1);
+        const SampleType b0 = g * SampleType(0.76923076923);
+        const SampleType b1 = g * SampleType(0.23076923076);
+
+        const SampleType dx = gain * saturate(drive * x);
+        const SampleType a = dx + resonance * SampleType(-4) * (gain2 * saturate(drive2 * state[4]) - dx * comp);
+
+        const SampleType b = b1 * state[0] + a1 * state[1] + b0 * a;
+        const SampleType c = b1 * state[1] + a1 * state[2] + b0 * b;
+        const SampleType d = b1 * state[2] + a1 * state[3] + b0 * c;
+        const SampleType e = b1 * state[3] + a1 * state[4] + b0 * d;
+
+        state[0] = a;
+        state[1] = b;
+        state[2] = c;
+        state[3] = d;
+        state[4] = e;
+
+        return c;
+    }
+
+private:
+    // Restarting linear ramp, same stepping as juce::LinearSmoothedValue.
+    struct Ramp
+    {
+        SampleType current = 0;
+        SampleType target = 0;
+        SampleType step = 0;
+        int countdown = 0;
+
+        void setTarget(SampleType newTarget, int length)
+        {
+            if (newTarget == target)
+            {
+                return;
+            }
+            target = newTarget;
+            if (length <= 0)
+            {
+                jumpToTarget();
+                return;
+            }
+            countdown = length;
+            step = (target - current) / SampleType(countdown);
+        }
+
+        void jumpToTarget()
+        {
+            current = target;
+            countdown = 0;
+        }
+
+        void jumpTo(SampleType value)
+        {
+            target = value;
+            jumpToTarget();
+        }
+
+        SampleType next()
+        {
+            if (countdown <= 0)
+            {
+                return target;
+            }
+            --countdown;
+            current = countdown > 0 ? current + step : target;
+            return current;
+        }
+    };
+
+    // tanh over [-5, 5] with 128 linearly interpolated points, as in the JUCE
+    // ladder. The table is read-only, so all filters share one copy.
+    struct SaturationTable
+    {
+        static constexpr int numPoints = 128;
+        static constexpr SampleType minInput = SampleType(-5);
+        static constexpr SampleType maxInput = SampleType(5);
+
+        SaturationTable()
+        {
+            for (int i = 0; i < numPoints; ++i)
+            {
+                SampleType x = minInput + (SampleType(i) * (maxInput - minInput)) / SampleType(numPoints - 1);
+                data[size_t(i)] = std::tanh(std::clamp(x, minInput, maxInput));
+            }
+            data[numPoints] = data[numPoints - 1];
+        }
+
+        std::array<SampleType, numPoints + 1> data;
+        const SampleType scaler = SampleType(numPoints - 1) / (maxInput - minInput);
+        const SampleType offset = -minInput * scaler;
+    };
+
+    static inline const SaturationTable saturationTable {};
+
+    static SampleType saturate(SampleType x)
+    {
+        const SaturationTable& table = saturationTable;
+        SampleType index = table.scaler * std::clamp(x, SaturationTable::minInput, SaturationTable::maxInput) + table.offset;
+        auto i = size_t(index);
+        SampleType f = index - SampleType(i);
+        return table.data[i] + f * (table.data[i + 1] - table.data[i]);
+    }
+
+    static constexpr SampleType drive = SampleType(1.2);
+    static constexpr SampleType drive2 = drive * SampleType(0.04) + SampleType(0.96);
+    static constexpr SampleType comp = SampleType(0.5);
+    static inline const SampleType gain = std::pow(drive, SampleType(-2.642)) * SampleType(0.6103) + SampleType(0.3903);
+    static inline const SampleType gain2 = std::pow(drive2, SampleType(-2.642)) * SampleType(0.6103) + SampleType(0.3903);
+
+    std::array<SampleType, 5> state;
+    Ramp cutoffRamp;
+    Ramp resonanceRamp;
+    SampleType cutoffScaler;
+    int rampLength;
 };
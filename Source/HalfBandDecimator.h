@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    HalfBandDecimator.h
+    Created: 18 Oct 2026 7:48:13pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedTables.h"
+
+// Halves the sample rate with a polyphase IIR half-band lowpass, the same
+// structure as juce::dsp::Oversampling's IIR stages: the even input samples
+// run through one cascade of first-order allpasses and the odd ones through
+// another, and the two are averaged. That is a handful of multiply-adds per
+// output sample with only a few samples of group delay.
+//
+// Each allpass depends on the one before it, so a cascade cannot be split
+// across time. What runs side by side instead is both paths of both
+// channels: four independent lanes, one 128-bit register of floats (two of
+// doubles), with the same four multiply-adds in each.
+template <typename SampleType = float>
+class HalfBandDecimator
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    // Even path of the left and right channel, then odd path of both.
+    using Lanes = std::array<SampleType, 4>;
+
+    // The allpass coefficients of both paths. They do not depend on the
+    // sample rate, so one design per transition width and attenuation is
+    // shared by every decimator in the process.
+    struct Design
+    {
+        Design(double normalisedTransitionWidth, int stopbandAmplitudedB)
+        {
+            auto structure = juce::dsp::FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod(
+                normalisedTransitionWidth, double(stopbandAmplitudedB));
+
+            for (int i = 0; i < structure.directPath.size(); ++i)
+            {
+                direct.push_back(structure.directPath.getUnchecked(i).coefficients[0]);
+            }
+            // The first section of the delayed path is the one-sample delay
+            // itself, which the polyphase split already provides.
+            for (int i = 1; i < structure.delayedPath.size(); ++i)
+            {
+                delayed.push_back(structure.delayedPath.getUnchecked(i).coefficients[0]);
+            }
+
+            for (size_t n = 0; n < std::min(direct.size(), delayed.size()); ++n)
+            {
+                pairs.push_back({ direct[n], direct[n], delayed[n], delayed[n] });
+            }
+        }
+
+        // The delay at low frequencies, in samples at the higher rate. An
+        // allpass section delays DC by (1 - a) / (1 + a) samples at the
+        // lower rate, and the odd samples are one sample apart from the
+        // even ones; the two paths are averaged.
+        double getDelay() const
+        {
+            double sum = 0.0;
+            for (SampleType a : direct)
+            {
+                sum += (1.0 - double(a)) / (1.0 + double(a));
+            }
+            for (SampleType a : delayed)
+            {
+                sum += (1.0 - double(a)) / (1.0 + double(a));
+            }
+            return sum + 0.5;
+        }
+
+        std::vector<SampleType> direct;
+        std::vector<SampleType> delayed;
+
+        // The sections both paths have, lane by lane.
+        std::vector<Lanes> pairs;
+    };
+
+    // The allpass state of both paths for up to two channels.
+    class Paths
+    {
+    public:
+        void prepare(const Design& design)
+        {
+            pairState.resize(design.pairs.size());
+            directState.resize(design.direct.size() - design.pairs.size());
+            delayedState.resize(design.delayed.size() - design.pairs.size());
+            reset();
+        }
+
+        void reset()
+        {
+            std::fill(pairState.begin(), pairState.end(), Lanes {});
+            std::fill(directState.begin(), directState.end(), Lanes {});
+            std::fill(delayedState.begin(), delayedState.end(), Lanes {});
+        }
+
+        // First-order allpasses (a + z^-1) / (1 + a z^-1), in series, on
+        // all four lanes; whichever path has more sections finishes on its
+        // own two.
+        void process(const Design& design, Lanes& x)
+        {
+            for (size_t n = 0; n < design.pairs.size(); ++n)
+            {
+                section<0, 4>(design.pairs[n], pairState[n], x);
+            }
+            for (size_t n = 0; n < directState.size(); ++n)
+            {
+                const SampleType a = design.direct[design.pairs.size() + n];
+                section<0, 2>({ a, a, a, a }, directState[n], x);
+            }
+            for (size_t n = 0; n < delayedState.size(); ++n)
+            {
+                const SampleType a = design.delayed[design.pairs.size() + n];
+                section<2, 4>({ a, a, a, a }, delayedState[n], x);
+            }
+        }
+
+    private:
+        template <size_t first, size_t end>
+        static void section(const Lanes& a, Lanes& state, Lanes& x)
+        {
+            for (size_t lane = first; lane < end; ++lane)
+            {
+                const SampleType y = a[lane] * x[lane] + state[lane];
+                state[lane] = x[lane] - a[lane] * y;
+                x[lane] = y;
+            }
+        }
+
+        std::vector<Lanes> pairState;
+        std::vector<Lanes> directState;
+        std::vector<Lanes> delayedState;
+    };
+
+    // Allocates; call from allocateResources(). The transition width is
+    // normalised to the input rate, centred on a quarter of it.
+    void prepare(double normalisedTransitionWidth, int stopbandAmplitudedB)
+    {
+        design = SharedTables::get<Design>(normalisedTransitionWidth, stopbandAmplitudedB);
+        paths.prepare(*design);
+        reset();
+    }
+
+    void reset()
+    {
+        paths.reset();
+        delay = {};
+    }
+
+    // The delay at low frequencies, in output samples.
+    double getLatency() const
+    {
+        return design->getDelay() / 2.0;
+    }
+
+    // Reads 2 * numOutputSamples from each channel and writes the
+    // decimated signal to the start of the same channel.
+    template <int numChannels>
+    void process(SampleType* const* channels, int numOutputSamples)
+    {
+        static_assert(numChannels >= 1 && numChannels <= maxChannels);
+
+        for (int i = 0; i < numOutputSamples; ++i)
+        {
+            Lanes x {};
+            for (int c = 0; c < numChannels; ++c)
+            {
+                x[size_t(c)] = channels[c][2 * i];
+                x[size_t(c) + 2] = channels[c][2 * i + 1];
+            }
+
+            paths.process(*design, x);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                channels[c][i] = (delay[size_t(c)] + x[size_t(c)]) * SampleType(0.5);
+                delay[size_t(c)] = x[size_t(c) + 2];
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const Design> design;
+    Paths paths;
+    std::array<SampleType, maxChannels> delay {};
+};
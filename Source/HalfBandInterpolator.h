@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    HalfBandInterpolator.h
+    Created: 19 Oct 2026 12:31:07am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "HalfBandDecimator.h"
+
+// Doubles the sample rate with the same polyphase IIR half-band lowpass as
+// HalfBandDecimator, run the other way round: every input sample goes
+// through both allpass cascades, and the two results become the even and
+// the odd output sample. Each cascade runs at the input rate, so the images
+// are removed for the cost of filtering at the lower rate. As in the
+// decimator, both paths of both channels run as four lanes.
+template <typename SampleType = float>
+class HalfBandInterpolator
+{
+public:
+    static constexpr int maxChannels = HalfBandDecimator<SampleType>::maxChannels;
+    using Design = typename HalfBandDecimator<SampleType>::Design;
+    using Lanes = typename HalfBandDecimator<SampleType>::Lanes;
+
+    // Allocates; call from allocateResources(). The transition width is
+    // normalised to the output rate, centred on a quarter of it.
+    void prepare(double normalisedTransitionWidth, int stopbandAmplitudedB)
+    {
+        design = SharedTables::get<Design>(normalisedTransitionWidth, stopbandAmplitudedB);
+        paths.prepare(*design);
+        reset();
+    }
+
+    void reset()
+    {
+        paths.reset();
+    }
+
+    // The delay at low frequencies, in output samples.
+    double getLatency() const
+    {
+        return design->getDelay();
+    }
+
+    // Reads numInputSamples from each input channel and writes twice as
+    // many to the output channel. Input and output must not overlap.
+    template <int numChannels>
+    void process(const SampleType* const* input, SampleType* const* output, int numInputSamples)
+    {
+        static_assert(numChannels >= 1 && numChannels <= maxChannels);
+
+        for (int i = 0; i < numInputSamples; ++i)
+        {
+            Lanes x {};
+            for (int c = 0; c < numChannels; ++c)
+            {
+                x[size_t(c)] = input[c][i];
+                x[size_t(c) + 2] = input[c][i];
+            }
+
+            paths.process(*design, x);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                output[c][2 * i] = x[size_t(c)];
+                output[c][2 * i + 1] = x[size_t(c) + 2];
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const Design> design;
+    typename HalfBandDecimator<SampleType>::Paths paths;
+};
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    Handoff.h
+    Created: 19 Oct 2026 2:14:07pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Hands objects built off the audio thread to the audio thread. The builder
+// publishes a new object; the audio thread picks the newest one up with
+// acquire() at the start of a block, and the one it lets go of is deleted
+// off the audio thread, in publish() or collectGarbage(). An object
+// published before the audio thread took the previous one replaces it.
+//
+// The audio thread only swaps while the object it retired last has been
+// collected, so it never frees anything and never waits.
+//
+// The engine, the mod matrix, the tuning, the wavetables and the reverb's
+// impulse responses are all handed over this way.
+template <typename Object>
+class Handoff
+{
+public:
+    Handoff() = default;
+
+    ~Handoff()
+    {
+        delete active;
+        delete pending.load();
+        delete retired.load();
+    }
+
+    // Any thread but the audio thread, one at a time.
+    void publish(std::unique_ptr<Object> object)
+    {
+        collectGarbage();
+        delete pending.exchange(object.release(), std::memory_order_acq_rel);
+    }
+
+    // Any thread but the audio thread. Deletes the object the audio thread
+    // has let go of, unless the check set with keepWhileInUse() says another
+    // thread still reads it.
+    void collectGarbage()
+    {
+        Object* old = retired.load(std::memory_order_acquire);
+        if (old != nullptr && (inUse == nullptr || !inUse(*old)))
+        {
+            delete retired.exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+
+    // Before the handoff is used. For objects a thread other than the audio
+    // thread reads too: a retired object is kept until isInUse returns
+    // false for it.
+    void keepWhileInUse(std::function<bool(const Object&)> isInUse)
+    {
+        inUse = std::move(isInUse);
+    }
+
+    // Audio thread. The newest object, or nullptr while none was published.
+    // beforeRetiring sees the new object before the old one can be
+    // collected, to point other readers away from the old one.
+    template <typename BeforeRetiring>
+    Object* acquire(BeforeRetiring&& beforeRetiring)
+    {
+        if (pending.load(std::memory_order_acquire) != nullptr && retired.load(std::memory_order_acquire) == nullptr)
+        {
+            if (Object* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                beforeRetiring(*next);
+                retired.store(active, std::memory_order_release);
+                active = next;
+            }
+        }
+        return active;
+    }
+
+    Object* acquire()
+    {
+        return acquire([](const Object&) {});
+    }
+
+    // With the audio thread stopped. Swaps in whatever is pending straight
+    // away, deletes everything else, and returns the current object.
+    Object* flush()
+    {
+        collectGarbage();
+        if (Object* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            delete active;
+            active = next;
+        }
+        return active;
+    }
+
+    // With the audio thread stopped. Replaces everything with object.
+    void reset(std::unique_ptr<Object> object)
+    {
+        collectGarbage();
+        delete pending.exchange(nullptr, std::memory_order_acq_rel);
+        delete active;
+        active = object.release();
+    }
+
+private:
+    Object* active = nullptr;
+    std::atomic<Object*> pending { nullptr };
+    std::atomic<Object*> retired { nullptr };
+    std::function<bool(const Object&)> inUse;
+
+    JUCE_DECLARE_NON_COPYABLE(Handoff)
+};
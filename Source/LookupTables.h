@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    LookupTables.h
+    Created: 18 Oct 2026 5:03:44pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedTables.h"
+
+// Curves that used to be evaluated at note-on and on every parameter update.
+// Each table holds the exact expression it replaces, so a lookup gives the
+// same value the calculation did. Tables are built at compile time where the
+// curve allows it and otherwise once at static initialisation, shared by
+// every instance in the process.
+//
+// Parameter curves are tabulated at the steps of the parameter layout. A
+// value between steps, which only the engine driven without the plugin's
+// parameters can see, is computed directly. Two things still evaluate
+// transcendentals on the audio thread: the note frequencies when the
+// octave or master tuning moves (128 exp2, see Synth::Part), and the
+// additive oscillator's phasors at note-on.
+namespace LookupTables
+{
+    constexpr int numNotes = 128;
+    constexpr int numVelocities = 128;
+    constexpr int numEnvelopeSteps = 101;
+    constexpr int numFilterVelocitySteps = 201;
+
+    // Oscillator amplitude for a MIDI velocity.
+    template <typename SampleType>
+    struct VelocityAmplitudes
+    {
+        constexpr VelocityAmplitudes()
+        {
+            for (int velocity = 0; velocity < numVelocities; ++velocity)
+            {
+                data[size_t(velocity)] = ((SampleType(0.004) * SampleType((velocity + 64) * (velocity + 64)) - 8.0f) / 127.0f) * 0.5f;
+            }
+        }
+
+        std::array<SampleType, numVelocities> data {};
+    };
+
+    template <typename SampleType>
+    inline constexpr VelocityAmplitudes<SampleType> velocityAmplitudes {};
+
+    // Constant-power gains for the note-dependent stereo spread.
+    template <typename SampleType>
+    struct NotePanning
+    {
+        NotePanning()
+        {
+            for (int note = 0; note < numNotes; ++note)
+            {
+                const SampleType panning = std::clamp(SampleType(note - 60) / SampleType(96), SampleType(-0.3), SampleType(0.3));
+                position[size_t(note)] = panning;
+                left[size_t(note)] = std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f - panning));
+                right[size_t(note)] = std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f + panning));
+            }
+        }
+
+        std::array<SampleType, numNotes> position;
+        std::array<SampleType, numNotes> left;
+        std::array<SampleType, numNotes> right;
+    };
+
+    template <typename SampleType>
+    inline const NotePanning<SampleType> notePanning {};
+
+    // exp(5.5 - 0.075 * time), the time constant behind the 0-100 envelope
+    // time parameters, at each of their integer steps.
+    template <typename SampleType>
+    struct EnvelopeTimes
+    {
+        EnvelopeTimes()
+        {
+            for (int step = 0; step < numEnvelopeSteps; ++step)
+            {
+                data[size_t(step)] = std::exp(SampleType(5.5) - SampleType(0.075) * SampleType(float(step)));
+            }
+        }
+
+        std::array<SampleType, numEnvelopeSteps> data;
+    };
+
+    template <typename SampleType>
+    inline const EnvelopeTimes<SampleType> envelopeTimes {};
+
+    // exp(0.0005 * filterVelocity * (velocity - 64)), the cutoff scaling at
+    // note-on, for each integer step of the -100 to 100 filter velocity
+    // parameter and each velocity.
+    template <typename SampleType>
+    struct VelocityCutoffScales
+    {
+        VelocityCutoffScales()
+        {
+            for (int step = 0; step < numFilterVelocitySteps; ++step)
+            {
+                const SampleType sensitivity = SampleType(0.0005) * float(step - 100);
+                for (int velocity = 0; velocity < numVelocities; ++velocity)
+                {
+                    data[size_t(step)][size_t(velocity)] = std::exp(sensitivity * SampleType(velocity - 64));
+                }
+            }
+        }
+
+        // The scales for one filter velocity, or nullptr off the steps.
+        const SampleType* getRow(float filterVelocity) const
+        {
+            const int step = int(filterVelocity) + 100;
+            if (float(step - 100) != filterVelocity || step < 0 || step >= numFilterVelocitySteps)
+            {
+                return nullptr;
+            }
+            return data[size_t(step)].data();
+        }
+
+        std::array<std::array<SampleType, numVelocities>, numFilterVelocitySteps> data;
+    };
+
+    template <typename SampleType>
+    inline const VelocityCutoffScales<SampleType> velocityCutoffScales {};
+
+    // One curve of a parameter with a fixed step, at every step from start
+    // to end. Step values are start + n * interval in float, as the
+    // parameter's range snaps them.
+    template <typename SampleType>
+    class SteppedCurve
+    {
+    public:
+        using Function = SampleType (*)(float);
+
+        SteppedCurve(float startToUse, float end, float intervalToUse, Function functionToUse)
+            : start(startToUse), interval(intervalToUse), function(functionToUse)
+        {
+            values.resize(size_t(juce::roundToInt((end - start) / interval)) + 1);
+            for (size_t step = 0; step < values.size(); ++step)
+            {
+                values[step] = function(getStepValue(int(step)));
+            }
+        }
+
+        SampleType operator()(float value) const
+        {
+            const int step = juce::roundToInt((value - start) / interval);
+            if (step >= 0 && step < int(values.size()) && getStepValue(step) == value)
+            {
+                return values[size_t(step)];
+            }
+            return function(value);
+        }
+
+    private:
+        float getStepValue(int step) const { return start + interval * float(step); }
+
+        float start;
+        float interval;
+        Function function;
+        std::vector<SampleType> values;
+    };
+
+    // Output gain for the -24 to 6 dB output level.
+    template <typename SampleType>
+    inline const SteppedCurve<SampleType> outputGains { -24.0f, 6.0f, 0.1f, [](float level)
+    {
+        return juce::Decibels::decibelsToGain(SampleType(level));
+    } };
+
+    // Filter Q, exp(3 * resonance), for the 0-100 resonance parameter.
+    template <typename SampleType>
+    inline const SteppedCurve<SampleType> filterQs { 0.0f, 100.0f, 1.0f, [](float resonance)
+    {
+        const SampleType amount = resonance / SampleType(100);
+        return std::exp(SampleType(3) * amount);
+    } };
+}
+
+// One-pole envelope coefficients for the envelope time parameters at one
+// rate. prepare() looks up the table of integer steps for that rate, shared
+// by every engine in the process; anything else, or another rate, is
+// computed directly.
+template <typename SampleType>
+class EnvelopeCurve
+{
+public:
+    struct Table
+    {
+        Table(double inverseRate, int /*quality*/)
+        {
+            for (size_t step = 0; step < coefficients.size(); ++step)
+            {
+                coefficients[step] = std::exp(-SampleType(inverseRate) * LookupTables::envelopeTimes<SampleType>.data[step]);
+            }
+        }
+
+        std::array<SampleType, LookupTables::numEnvelopeSteps> coefficients;
+    };
+
+    // Message thread.
+    void prepare(SampleType inverseRate)
+    {
+        if (table != nullptr && inverseRate == preparedInverseRate)
+        {
+            return;
+        }
+        preparedInverseRate = inverseRate;
+        table = SharedTables::get<Table>(double(inverseRate));
+    }
+
+    SampleType operator()(float time, SampleType inverseRate) const
+    {
+        if (inverseRate == preparedInverseRate && time >= 0.0f && time < float(LookupTables::numEnvelopeSteps))
+        {
+            const int step = int(time);
+            if (float(step) == time)
+            {
+                return table->coefficients[size_t(step)];
+            }
+        }
+        return std::exp(-inverseRate * std::exp(SampleType(5.5) - SampleType(0.075) * time));
+    }
+
+private:
+    SampleType preparedInverseRate = 0;
+    std::shared_ptr<const Table> table;
+};
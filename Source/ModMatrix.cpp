@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    ModMatrix.cpp
+    Created: 18 Oct 2026 2:21:47pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "ModMatrix.h"
+
+void ModMatrix::setRouting(const std::array<ModSlot, numSlots>& slots)
+{
+    // An empty routing is still published, as an empty program, so that it
+    // replaces the previous one. A program the audio thread never picked up
+    // is simply superseded.
+    programs.publish(std::make_unique<ModProgram>(compile(slots)));
+}
+
+const ModProgram* ModMatrix::acquire()
+{
+    // The previous program can only be retired once the message thread has
+    // collected the one before it; until then the swap waits a block.
+    const ModProgram* active = programs.acquire();
+    if (active == nullptr || active->operations.empty())
+    {
+        return nullptr;
+    }
+    return active;
+}
+
+ModProgram ModMatrix::compile(const std::array<ModSlot, numSlots>& slots)
+{
+    // Scale from an amount of 1 to destination units.
+    constexpr float octave = 0.69314718056f;
+    constexpr float scale[] =
+    {
+        0.0f,             // none
+        octave,           // pitch: one octave
+        octave,           // oscBPitch: one octave
+        4.0f * octave,    // cutoff: four octaves
+        30.0f,            // resonance: the full Q range
+        1.0f,             // oscMix: the full mix range
+        1.0f,             // noise: the part's noise level, up to double
+        1.0f,             // pan: from the note's position to either side
+        2.76310211f,      // level: 24 dB
+        3.0f * octave,    // envelopeTimes: eight times longer or shorter
+    };
+    static_assert(std::size(scale) == size_t(ModDestination::count));
+
+    ModProgram program;
+
+    for (const ModSlot& slot : slots)
+    {
+        if (slot.source == ModSource::none || slot.source >= ModSource::count
+            || slot.destination == ModDestination::none || slot.destination >= ModDestination::count
+            || slot.amount == 0.0f)
+        {
+            continue;
+        }
+
+        const auto source = uint8_t(slot.source);
+        const auto destination = uint8_t(slot.destination);
+        const float amount = slot.amount * scale[destination];
+
+        // The same route in two slots becomes one operation.
+        auto existing = std::find_if(program.operations.begin(), program.operations.end(),
+                                     [&](const ModProgram::Operation& operation)
+                                     {
+                                         return operation.source == source && operation.destination == destination;
+                                     });
+        if (existing != program.operations.end())
+        {
+            existing->amount += amount;
+        }
+        else
+        {
+            program.operations.push_back({ source, destination, amount });
+        }
+    }
+
+    program.operations.erase(std::remove_if(program.operations.begin(), program.operations.end(),
+                                            [](const ModProgram::Operation& operation)
+                                            {
+                                                return operation.amount == 0.0f;
+                                            }),
+                             program.operations.end());
+
+    std::stable_sort(program.operations.begin(), program.operations.end(),
+                     [](const ModProgram::Operation& a, const ModProgram::Operation& b)
+                     {
+                         return a.destination < b.destination;
+                     });
+
+    for (const auto& operation : program.operations)
+    {
+        program.sourceMask |= 1u << operation.source;
+        program.destinationMask |= 1u << operation.destination;
+    }
+
+    return program;
+}
+
+juce::StringArray ModMatrix::getSourceNames()
+{
+    return { "Off", "LFO", "Amp Env", "Filter Env", "Velocity", "Key", "Mod Wheel", "Breath", "Expression", "Aftertouch" };
+}
+
+juce::StringArray ModMatrix::getDestinationNames()
+{
+    return { "Off", "Pitch", "Osc B Pitch", "Cutoff", "Resonance", "Osc Mix", "Noise", "Pan", "Level", "Env Times" };
+}
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    ModMatrix.h
+    Created: 18 Oct 2026 2:21:47pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Handoff.h"
+
+enum class ModSource : uint8_t
+{
+    none,
+    lfo,
+    envelope,
+    filterEnvelope,
+    velocity,
+    key,
+    modWheel,
+    breath,
+    expression,
+    aftertouch,
+    count
+};
+
+enum class ModDestination : uint8_t
+{
+    none,
+    pitch,
+    oscBPitch,
+    cutoff,
+    resonance,
+    oscMix,
+    noise,
+    pan,
+    level,
+    envelopeTimes,
+    count
+};
+
+// One user routing. The amount is bipolar, -1 to 1.
+struct ModSlot
+{
+    ModSource source = ModSource::none;
+    ModDestination destination = ModDestination::none;
+    float amount = 0.0f;
+
+    bool operator==(const ModSlot& other) const
+    {
+        return source == other.source && destination == other.destination && amount == other.amount;
+    }
+
+    bool operator!=(const ModSlot& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// The routing compiled into the form the control tick evaluates: one
+// multiply-add per route, sorted by destination, with the amounts already
+// scaled to the units of each destination (log-frequency for pitch and
+// cutoff, Q for resonance, a fraction of the range for the oscillator mix
+// and pan, of the part's level for noise, and log-gain and log-time for
+// level and the envelope times). The masks tell the engine which sources
+// to gather and which destinations to apply.
+struct ModProgram
+{
+    struct Operation
+    {
+        uint8_t source;
+        uint8_t destination;
+        float amount;
+    };
+
+    std::vector<Operation> operations;
+    uint32_t sourceMask = 0;
+    uint32_t destinationMask = 0;
+
+    bool uses(ModSource source) const
+    {
+        return (sourceMask & (1u << unsigned(source))) != 0;
+    }
+
+    bool uses(ModDestination destination) const
+    {
+        return (destinationMask & (1u << unsigned(destination))) != 0;
+    }
+};
+
+// Owns the routing for one engine. The message thread compiles new slots
+// with setRouting(); the audio thread picks the newest program up with
+// acquire() at the start of a block. Programs are handed over through a
+// Handoff and are only ever deleted on the message thread.
+class ModMatrix
+{
+public:
+    static constexpr int numSlots = 4;
+
+    ModMatrix() = default;
+
+    // Message thread.
+    void setRouting(const std::array<ModSlot, numSlots>& slots);
+
+    // Audio thread. Returns nullptr while no route is set.
+    const ModProgram* acquire();
+
+    static ModProgram compile(const std::array<ModSlot, numSlots>& slots);
+
+    static juce::StringArray getSourceNames();
+    static juce::StringArray getDestinationNames();
+
+private:
+    Handoff<ModProgram> programs;
+
+    JUCE_DECLARE_NON_COPYABLE(ModMatrix)
+};
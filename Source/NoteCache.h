@@ -0,0 +1,445 @@
+/*
+  ==============================================================================
+
+    NoteCache.h
+    Created: 18 Oct 2026 10:26:43pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Voice.h"
+
+// Recorded voice output for notes that sound the same every time they are
+// played: a part without noise, LFO, controllers or mod routings, on an idle
+// voice. The first such note records what its oscillators and filter render
+// until both envelopes settle at their sustain level; later notes with the
+// same key replay it instead of running the kernel. A voice can leave the
+// cache at any sample (on release, or when its part is modulated or
+// edited), so along with the audio an entry keeps the oscillator phases and
+// the filter at every control tick. Leaving restores the last of these and
+// runs the kernel up to the current sample, which takes less than one tick.
+//
+// Turning the cache on changes how such notes start, so it is not
+// sample-identical to rendering with it off: a live note's filter and
+// filter envelope carry on from wherever the voice's last note left them,
+// while a cacheable note starts both from idle, or its filter right at its
+// cutoff when it has no filter envelope. Replaying an entry does give
+// exactly what recording it rendered.
+//
+// All memory is allocated by prepare(); the audio thread only moves pages
+// between entries, evicting the least recently used entry when it runs out.
+template <typename SampleType>
+class NoteCache
+{
+public:
+    static constexpr int pageLength = 2048;
+    static constexpr int stateSize = 17;
+
+    // What a voice renders from note-on depends on nothing else. The state
+    // holds the part's settings, in whatever order the engine puts them.
+    // tickPhase is where note-on fell between control ticks, or -1 for a
+    // note whose sound does not depend on it.
+    struct Key
+    {
+        std::array<SampleType, stateSize> state {};
+        SampleType frequency = 0;
+        int velocity = 0;
+        int tickPhase = 0;
+
+        bool operator==(const Key& other) const
+        {
+            return state == other.state && frequency == other.frequency
+                && velocity == other.velocity && tickPhase == other.tickPhase;
+        }
+    };
+
+    // One voice's place in an entry, in samples at the oscillator rate.
+    struct Cursor
+    {
+        int entry = -1;
+        int page = -1;
+        int position = 0;
+        bool recording = false;
+
+        bool isActive() const { return entry >= 0; }
+    };
+
+    // The kernel only moves the oscillator phases and the filter; everything
+    // else about a voice is set again from its part every block and tick.
+    struct Snapshot
+    {
+        int position = 0;
+        SampleType phaseA = 0;
+        SampleType phaseB = 0;
+        Filter<SampleType> filter;
+    };
+
+    // Message thread. tickLength is the control interval at the oscillator
+    // rate and maxLength caps one entry. A budget too small for a page
+    // turns the cache off.
+    void prepare(size_t budgetBytes, int tickLength, int maxEntryLength)
+    {
+        snapshotsPerPage = pageLength / tickLength + 3;
+        const size_t pageBytes = sizeof(SampleType) * pageLength + sizeof(Snapshot) * size_t(snapshotsPerPage) + sizeof(Page);
+        const size_t numPages = budgetBytes / pageBytes;
+
+        pages.assign(numPages, Page());
+        audio.assign(numPages * pageLength, SampleType(0));
+        snapshots.assign(numPages * size_t(snapshotsPerPage), Snapshot());
+        freePages.reserve(numPages);
+        entries.assign(std::min(numPages, size_t(maxEntries)), Entry());
+        scratch.assign(size_t(tickLength), SampleType(0));
+        silence.assign(size_t(tickLength), SampleType(0));
+        maxLength = maxEntryLength;
+        clear();
+    }
+
+    bool isEnabled() const { return !pages.empty(); }
+
+    // Drops every entry. Any cursor still attached has to be reset first.
+    void clear()
+    {
+        std::fill(entries.begin(), entries.end(), Entry());
+        freePages.clear();
+        for (int page = int(pages.size()) - 1; page >= 0; --page)
+        {
+            freePages.push_back(page);
+        }
+    }
+
+    // Attaches the cursor to a recorded entry for the key, or to a new one
+    // that records. Returns false when the key is being recorded by another
+    // voice or nothing can be evicted to make room.
+    bool start(const Key& key, Cursor& cursor)
+    {
+        cursor = Cursor();
+
+        for (int e = 0; e < int(entries.size()); ++e)
+        {
+            Entry& entry = entries[size_t(e)];
+            if (entry.inUse && entry.key == key)
+            {
+                if (entry.length == 0)
+                {
+                    return false;
+                }
+                entry.lastUsed = ++clock;
+                ++entry.users;
+                ++hits;
+                cursor.entry = e;
+                cursor.page = entry.firstPage;
+                return true;
+            }
+        }
+
+        ++misses;
+
+        auto slot = std::find_if(entries.begin(), entries.end(), [](const Entry& entry) { return !entry.inUse; });
+        if (slot == entries.end())
+        {
+            const int evicted = evictLeastRecentlyUsed();
+            if (evicted < 0)
+            {
+                return false;
+            }
+            slot = entries.begin() + evicted;
+        }
+
+        Entry& entry = *slot;
+        entry.inUse = true;
+        entry.key = key;
+        entry.users = 1;
+        entry.recording = true;
+        entry.lastUsed = ++clock;
+
+        const int page = allocatePage();
+        if (page < 0)
+        {
+            entry = Entry();
+            return false;
+        }
+        pages[size_t(page)] = Page();
+        entry.firstPage = entry.lastPage = page;
+
+        cursor.entry = int(slot - entries.begin());
+        cursor.page = page;
+        cursor.recording = true;
+        return true;
+    }
+
+    // Releases the cursor. A recording ends here; complete marks the entry
+    // as covering everything before the sustain, so no later voice extends it.
+    void detach(Cursor& cursor, bool complete = false)
+    {
+        Entry& entry = entries[size_t(cursor.entry)];
+        --entry.users;
+        if (cursor.recording)
+        {
+            entry.recording = false;
+            entry.complete = entry.complete || complete;
+            if (entry.length == 0)
+            {
+                releaseEntry(cursor.entry);
+            }
+        }
+        cursor = Cursor();
+    }
+
+    // Recording. A snapshot is taken at the start of the entry and at every
+    // control tick, after the tick and before the kernel runs.
+    bool addSnapshot(Cursor& cursor, const Voice<SampleType>& voice)
+    {
+        Entry& entry = entries[size_t(cursor.entry)];
+        int page = entry.lastPage;
+        if (entry.length == pages[size_t(page)].start + pageLength)
+        {
+            page = openPage(entry);
+            if (page < 0)
+            {
+                return false;
+            }
+        }
+
+        Page& info = pages[size_t(page)];
+        if (info.numSnapshots == snapshotsPerPage)
+        {
+            return false;
+        }
+        Snapshot& snapshot = snapshots[size_t(page * snapshotsPerPage + info.numSnapshots++)];
+        snapshot.position = entry.length;
+        snapshot.phaseA = voice.oscillatorA.phase;
+        snapshot.phaseB = voice.oscillatorB.phase;
+        snapshot.filter = voice.filter;
+        return true;
+    }
+
+    // Returns false when the entry cannot grow any further. The samples
+    // appended before that are still valid.
+    bool append(Cursor& cursor, const SampleType* samples, int length)
+    {
+        Entry& entry = entries[size_t(cursor.entry)];
+        if (entry.length + length > maxLength)
+        {
+            return false;
+        }
+
+        while (length > 0)
+        {
+            int page = entry.lastPage;
+            int space = pages[size_t(page)].start + pageLength - entry.length;
+            if (space == 0)
+            {
+                page = openPage(entry);
+                if (page < 0)
+                {
+                    return false;
+                }
+                space = pageLength;
+            }
+
+            const int count = std::min(space, length);
+            const int offset = entry.length - pages[size_t(page)].start;
+            std::copy(samples, samples + count, audio.begin() + page * pageLength + offset);
+            entry.length += count;
+            samples += count;
+            length -= count;
+        }
+        return true;
+    }
+
+    int getLength(const Cursor& cursor) const { return entries[size_t(cursor.entry)].length; }
+    bool isFull(const Cursor& cursor) const { return getLength(cursor) >= maxLength; }
+
+    // Replay. Copies up to length samples and returns how many there were.
+    int read(Cursor& cursor, SampleType* destination, int length)
+    {
+        const Entry& entry = entries[size_t(cursor.entry)];
+        int total = 0;
+        while (total < length && cursor.position < entry.length)
+        {
+            const Page& page = pages[size_t(cursor.page)];
+            const int offset = cursor.position - page.start;
+            if (offset == pageLength)
+            {
+                cursor.page = page.next;
+                continue;
+            }
+
+            const int count = std::min({ length - total, pageLength - offset, entry.length - cursor.position });
+            const auto source = audio.begin() + cursor.page * pageLength + offset;
+            std::copy(source, source + count, destination + total);
+            total += count;
+            cursor.position += count;
+        }
+        return total;
+    }
+
+    bool isAtEnd(const Cursor& cursor) const { return cursor.position >= getLength(cursor); }
+
+    // Puts the voice back to the last snapshot before the cursor and returns
+    // the number of samples the kernel has to run to reach it. A snapshot at
+    // the cursor itself already has the next tick applied, which the engine
+    // is still going to run, so it is passed over. At the start of an entry
+    // the voice is as note-on left it.
+    int restore(const Cursor& cursor, Voice<SampleType>& voice) const
+    {
+        if (cursor.position == 0)
+        {
+            return 0;
+        }
+
+        const Page& page = pages[size_t(cursor.page)];
+        for (int k = page.numSnapshots - 1; k >= 0; --k)
+        {
+            const Snapshot& snapshot = snapshots[size_t(cursor.page * snapshotsPerPage + k)];
+            if (snapshot.position < cursor.position)
+            {
+                voice.oscillatorA.phase = snapshot.phaseA;
+                voice.oscillatorB.phase = snapshot.phaseB;
+                voice.filter = snapshot.filter;
+                return cursor.position - snapshot.position;
+            }
+        }
+        jassertfalse;
+        return 0;
+    }
+
+    // A replaying voice that reaches the end of an entry another note cut
+    // short carries on recording it.
+    bool canExtend(const Cursor& cursor) const
+    {
+        const Entry& entry = entries[size_t(cursor.entry)];
+        return !entry.complete && !entry.recording && entry.length < maxLength;
+    }
+
+    void extend(Cursor& cursor)
+    {
+        entries[size_t(cursor.entry)].recording = true;
+        cursor.recording = true;
+    }
+
+    const Key& getKey(const Cursor& cursor) const { return entries[size_t(cursor.entry)].key; }
+
+    // Scratch for catching up, one control interval long, and as many
+    // zeros to pass as its envelope.
+    SampleType* getScratch() { return scratch.data(); }
+    const SampleType* getSilence() const { return silence.data(); }
+    int getScratchLength() const { return int(scratch.size()); }
+
+    int getHits() const { return hits; }
+    int getMisses() const { return misses; }
+    int getNumEntries() const
+    {
+        return int(std::count_if(entries.begin(), entries.end(), [](const Entry& entry) { return entry.inUse; }));
+    }
+    size_t getMemoryFootprint() const
+    {
+        return sizeof(SampleType) * (audio.capacity() + scratch.capacity() + silence.capacity())
+             + sizeof(Snapshot) * snapshots.capacity() + sizeof(Page) * pages.capacity()
+             + sizeof(Entry) * entries.capacity() + sizeof(int) * freePages.capacity();
+    }
+
+private:
+    static constexpr int maxEntries = 1024;
+
+    struct Entry
+    {
+        Key key;
+        int firstPage = -1;
+        int lastPage = -1;
+        int length = 0;
+        int users = 0;
+        bool inUse = false;
+        bool recording = false;
+        bool complete = false;
+        uint64_t lastUsed = 0;
+    };
+
+    // Pages hold pageLength samples from start on, and the snapshots taken
+    // there. The first snapshot of a page is a copy of the last one of the
+    // page before, so every position finds one in its own page.
+    struct Page
+    {
+        int next = -1;
+        int start = 0;
+        int numSnapshots = 0;
+    };
+
+    // The entry nobody plays or records that was used the longest time ago.
+    int evictLeastRecentlyUsed()
+    {
+        int oldest = -1;
+        for (int e = 0; e < int(entries.size()); ++e)
+        {
+            const Entry& entry = entries[size_t(e)];
+            if (entry.inUse && entry.users == 0 && !entry.recording
+                && (oldest < 0 || entry.lastUsed < entries[size_t(oldest)].lastUsed))
+            {
+                oldest = e;
+            }
+        }
+        if (oldest >= 0)
+        {
+            releaseEntry(oldest);
+        }
+        return oldest;
+    }
+
+    void releaseEntry(int index)
+    {
+        for (int page = entries[size_t(index)].firstPage; page >= 0; page = pages[size_t(page)].next)
+        {
+            freePages.push_back(page);
+        }
+        entries[size_t(index)] = Entry();
+    }
+
+    int allocatePage()
+    {
+        if (freePages.empty() && evictLeastRecentlyUsed() < 0)
+        {
+            return -1;
+        }
+        const int page = freePages.back();
+        freePages.pop_back();
+        return page;
+    }
+
+    int openPage(Entry& entry)
+    {
+        const int page = allocatePage();
+        if (page < 0)
+        {
+            return -1;
+        }
+
+        Page& previous = pages[size_t(entry.lastPage)];
+        Page& info = pages[size_t(page)];
+        info = Page();
+        info.start = entry.length;
+        if (previous.numSnapshots > 0)
+        {
+            snapshots[size_t(page * snapshotsPerPage)] = snapshots[size_t(entry.lastPage * snapshotsPerPage + previous.numSnapshots - 1)];
+            info.numSnapshots = 1;
+        }
+        previous.next = page;
+        entry.lastPage = page;
+        return page;
+    }
+
+    std::vector<Entry> entries;
+    std::vector<Page> pages;
+    std::vector<SampleType> audio;
+    std::vector<Snapshot> snapshots;
+    std::vector<int> freePages;
+    std::vector<SampleType> scratch;
+    std::vector<SampleType> silence;
+    int snapshotsPerPage = 0;
+    int maxLength = 0;
+    uint64_t clock = 0;
+    int hits = 0;
+    int misses = 0;
+};
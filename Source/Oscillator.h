@@ -10,25 +10,38 @@
 
 #pragma once
 
+#include "Wavetable.h"
+#include "PartialBank.h"
+
 const float TWO_PI = juce::MathConstants<float>::twoPi;
 const float PI = juce::MathConstants<float>::pi;
 const float PI_OVER_4 = juce::MathConstants<float>::pi / 4;
 
+enum class OscillatorAlgorithm
+{
+    naive,
+    polyBLEP,
+    fourier,
+    wavetable,
+    additive,
+};
+
+template <typename SampleType = float>
 class Oscillator 
 {
 public:
-    float amplitude;
-    float sampleRate;
-    float freq;
-    float phase;
+    SampleType amplitude;
+    SampleType sampleRate;
+    SampleType freq;
+    SampleType phase;
     
-    void setFrequency(float freq) 
+    void setFrequency(SampleType freq) 
     {
         this->freq = freq;
         updateIncrement();
     }
     
-    void setSampleRate(float sampleRate) 
+    void setSampleRate(SampleType sampleRate) 
     {
         this->sampleRate = sampleRate;
         this->nyquist = sampleRate / 2.0f;
@@ -42,12 +55,12 @@ public:
     }
     
     // Generated using claude sonnet 3.5 (Poly BLEP)
-    float nextPolyBLEPSample()
+    SampleType nextPolyBLEPSample()
     {
-        float t = phase;
-        float value = 2.0f * t - 1.0f;
+        SampleType t = phase;
+        SampleType value = 2.0f * t - 1.0f;
 
-        float dt = inc;
+        SampleType dt = inc;
         if (t < dt) 
         {
             t /= dt;
@@ -65,9 +78,9 @@ public:
         return amplitude * value;
     }
     
-    float nextNaiveSample()
+    SampleType nextNaiveSample()
     {
-        float value = 2.0f * phase - 1.0f;
+        SampleType value = 2.0f * phase - 1.0f;
 
         phase += inc;
         if (phase >= 1.0f) phase -= 1.0f;
@@ -75,16 +88,16 @@ public:
         return amplitude * value;
     }
     
-    float nextFourierSample()
+    SampleType nextFourierSample()
     {
-        float value = 0.0f;
-        float h = freq;
-        float i = 1.0f;
-        float m = 0.63661977236f;
+        SampleType value = 0.0f;
+        SampleType h = freq;
+        SampleType i = 1.0f;
+        SampleType m = SampleType(0.63661977236);
         
         while (h < nyquist) 
         {
-            value += m * std::sin(TWO_PI * phase * i) / i;
+            value += m * std::sin(juce::MathConstants<SampleType>::twoPi * phase * i) / i;
             h += freq;
             i += 1.0f;
             m = -m;
@@ -96,12 +109,87 @@ public:
         return amplitude * value;
     }
     
+    // Wavetable playback: the mip-map level and the two frames to morph
+    // between are picked whenever the frequency or position changes, so the
+    // per-sample work is two interpolated lookups.
+    void setWavetable(const Wavetable* table)
+    {
+        wavetable = table;
+    }
+    
+    // 0 is the first frame, 1 the last. Takes effect on the next
+    // setFrequency().
+    void setWavetablePosition(SampleType position)
+    {
+        wavetablePosition = std::clamp(position, SampleType(0), SampleType(1));
+    }
+    
+    SampleType nextWavetableSample()
+    {
+        const SampleType index = phase * SampleType(Wavetable::frameSize);
+        const int i = int(index);
+        const SampleType fraction = index - SampleType(i);
+        
+        const SampleType a = frameA[i] + fraction * (frameA[i + 1] - frameA[i]);
+        const SampleType b = frameB[i] + fraction * (frameB[i + 1] - frameB[i]);
+        const SampleType value = a + frameMorph * (b - a);
+        
+        phase += inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+        
+        return amplitude * value;
+    }
+    
+    // Additive playback reads the voice's partial bank, which follows every
+    // frequency change.
+    void setPartials(PartialBank<SampleType>* bank)
+    {
+        partials = bank;
+    }
+    
+    SampleType nextAdditiveSample()
+    {
+        const SampleType value = partials->next();
+        
+        phase += inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+        
+        return amplitude * value;
+    }
+    
 private:
-    float inc;
-    float nyquist;
+    SampleType inc;
+    SampleType nyquist;
+    
+    const Wavetable* wavetable = nullptr;
+    SampleType wavetablePosition = 0;
+    const float* frameA = nullptr;
+    const float* frameB = nullptr;
+    SampleType frameMorph = 0;
+    
+    PartialBank<SampleType>* partials = nullptr;
 
     void updateIncrement()
     {
         inc = freq / sampleRate;
+        
+        if (wavetable != nullptr)
+        {
+            updateFrames();
+        }
+        if (partials != nullptr)
+        {
+            partials->setIncrement(inc, phase);
+        }
+    }
+    
+    void updateFrames()
+    {
+        const int level = Wavetable::levelForIncrement(double(inc));
+        const SampleType position = wavetablePosition * SampleType(wavetable->getNumFrames() - 1);
+        const int frame = int(position);
+        frameA = wavetable->getLevel(frame, level);
+        frameB = wavetable->getLevel(std::min(frame + 1, wavetable->getNumFrames() - 1), level);
+        frameMorph = position - SampleType(frame);
     }
 };
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    PartialBank.h
+    Created: 18 Oct 2026 8:41:06pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The user's shaping of the additive spectrum, set per part.
+struct PartialShape
+{
+    int count = 0;          // partials per oscillator; 0 keeps the saws
+    float tilt = 0.0f;      // dB per octave on top of the saw's -6
+    float oddEven = 0.0f;   // -1 even partials only, 0 all, 1 odd only
+    float decay = 0.0f;     // per second, times the partial number minus one
+};
+
+// Additive saw-like oscillator. Every partial is a unit phasor that is
+// rotated by its own step each sample, so a sample costs one complex
+// multiply and one multiply-add per partial instead of a sin() call. The
+// partials are stored in SIMD registers, a few side by side. Whenever the
+// frequency is set, which happens at least once per control tick, the
+// phasors are set afresh from the oscillator's phase, so the rounding of
+// the steps never builds up past one interval in either magnitude or
+// phase.
+template <typename SampleType = float>
+class PartialBank
+{
+public:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr int lanes = int(Register::SIMDNumElements);
+    static constexpr int maxPartials = 64;
+    static constexpr int numRegisters = maxPartials / lanes;
+
+    // Note-on. All partials start at phase zero, with the saw amplitudes
+    // (2/pi) (-1)^(k+1) / k shaped by the part's settings.
+    void start(const PartialShape& shape, SampleType sampleRate)
+    {
+        numPartials = std::clamp(shape.count, 0, maxPartials);
+        decaying = shape.decay > 0.0f;
+
+        const double tiltExponent = double(shape.tilt) / 6.0206;
+        const double oddGain = std::min(1.0, 1.0 + double(shape.oddEven));
+        const double evenGain = std::min(1.0, 1.0 - double(shape.oddEven));
+
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const int k = r * lanes + lane + 1;
+                double amplitude = 0.0;
+                double decayPerSample = 1.0;
+                if (k <= numPartials)
+                {
+                    const double sign = (k % 2 == 1) ? 1.0 : -1.0;
+                    amplitude = 0.63661977236 * sign / double(k) * std::pow(double(k), tiltExponent)
+                              * ((k % 2 == 1) ? oddGain : evenGain);
+                    decayPerSample = std::exp(-double(shape.decay) * double(k - 1) / double(sampleRate));
+                }
+                amplitudes[size_t(r)].set(size_t(lane), SampleType(amplitude));
+                decays[size_t(r)].set(size_t(lane), SampleType(decayPerSample));
+            }
+            phasorsRe[size_t(r)] = Register::expand(SampleType(1));
+            phasorsIm[size_t(r)] = Register::expand(SampleType(0));
+        }
+        activeRegisters = 0;
+    }
+
+    // The fundamental as a fraction of the sample rate, and the phase of
+    // the next sample in cycles. Partials at or above Nyquist are muted
+    // until the pitch drops again.
+    void setIncrement(SampleType increment, SampleType phase)
+    {
+        int numAudible = numPartials;
+        if (increment > SampleType(0))
+        {
+            numAudible = std::min(numPartials, int(std::ceil(0.5 / double(increment))) - 1);
+        }
+        activeRegisters = (numAudible + lanes - 1) / lanes;
+
+        // Each step and each phasor is the previous one turned by the
+        // fundamental's, in double so the top partials stay in tune.
+        const double angle = juce::MathConstants<double>::twoPi * double(increment);
+        const std::complex<double> fundamental(std::cos(angle), std::sin(angle));
+        std::complex<double> step = fundamental;
+
+        const double turn = juce::MathConstants<double>::twoPi * double(phase);
+        const std::complex<double> first(std::cos(turn), std::sin(turn));
+        std::complex<double> phasor = first;
+
+        for (int r = 0; r < activeRegisters; ++r)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const bool audible = r * lanes + lane < numAudible;
+                rotationsRe[size_t(r)].set(size_t(lane), SampleType(step.real()));
+                rotationsIm[size_t(r)].set(size_t(lane), SampleType(step.imag()));
+                masks[size_t(r)].set(size_t(lane), audible ? SampleType(1) : SampleType(0));
+                phasorsRe[size_t(r)].set(size_t(lane), SampleType(phasor.real()));
+                phasorsIm[size_t(r)].set(size_t(lane), SampleType(phasor.imag()));
+                step *= fundamental;
+                phasor *= first;
+            }
+        }
+    }
+
+    SampleType next()
+    {
+        Register sum = Register::expand(SampleType(0));
+        for (int r = 0; r < activeRegisters; ++r)
+        {
+            Register& re = phasorsRe[size_t(r)];
+            Register& im = phasorsIm[size_t(r)];
+            sum += amplitudes[size_t(r)] * masks[size_t(r)] * im;
+
+            const Register rotatedRe = re * rotationsRe[size_t(r)] - im * rotationsIm[size_t(r)];
+            const Register rotatedIm = re * rotationsIm[size_t(r)] + im * rotationsRe[size_t(r)];
+            re = rotatedRe;
+            im = rotatedIm;
+
+            if (decaying)
+            {
+                amplitudes[size_t(r)] = amplitudes[size_t(r)] * decays[size_t(r)];
+            }
+        }
+        return sum.sum();
+    }
+
+private:
+    std::array<Register, numRegisters> phasorsRe;
+    std::array<Register, numRegisters> phasorsIm;
+    std::array<Register, numRegisters> rotationsRe;
+    std::array<Register, numRegisters> rotationsIm;
+    std::array<Register, numRegisters> amplitudes;
+    std::array<Register, numRegisters> decays;
+    std::array<Register, numRegisters> masks;
+
+    int numPartials = 0;
+    int activeRegisters = 0;
+    bool decaying = false;
+};
@@ -13,13 +13,52 @@
 SubSynthAudioProcessorEditor::SubSynthAudioProcessorEditor (SubSynthAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
+    parameterEditor = std::make_unique<juce::GenericAudioProcessorEditor> (audioProcessor);
+    addAndMakeVisible (*parameterEditor);
+    audioProcessor.addListener (this);
+
+    // Wavetables are per part, so these follow the edited part.
+    wavetableButton.onClick = [this] { chooseWavetable(); };
+    addAndMakeVisible (wavetableButton);
+
+    sawButton.setTooltip ("Go back to the saw oscillators");
+    sawButton.onClick = [this]
+    {
+        audioProcessor.loadWavetable (audioProcessor.getEditedPart(), juce::File());
+        updateFileButtons();
+    };
+    addAndMakeVisible (sawButton);
+
+    impulseResponseButton.onClick = [this] { chooseImpulseResponse(); };
+    addAndMakeVisible (impulseResponseButton);
+
+    roomButton.setTooltip ("Go back to the synthetic room");
+    roomButton.onClick = [this]
+    {
+        audioProcessor.loadImpulseResponse (juce::File());
+        updateFileButtons();
+    };
+    addAndMakeVisible (roomButton);
+
+    footprintLabel.setJustificationType (juce::Justification::centredRight);
+    addAndMakeVisible (footprintLabel);
+
+    traceButton.setTooltip ("Record what the audio thread spends its time on, as a Chrome trace");
+    traceButton.onClick = [this] { toggleTrace(); };
+    addAndMakeVisible (traceButton);
+
+    updateFileButtons();
+    timerCallback();
+    startTimerHz (2);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (500, 500 + 2 * barHeight);
 }
 
 SubSynthAudioProcessorEditor::~SubSynthAudioProcessorEditor()
 {
+    audioProcessor.removeListener (this);
 }
 
 //==============================================================================
@@ -27,14 +66,134 @@ void SubSynthAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (juce::FontOptions (15.0f));
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void SubSynthAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto bounds = getLocalBounds();
+
+    auto wavetableBar = bounds.removeFromTop (barHeight).reduced (4);
+    footprintLabel.setBounds (wavetableBar.removeFromRight (150));
+    wavetableBar.removeFromRight (4);
+    sawButton.setBounds (wavetableBar.removeFromRight (80));
+    wavetableBar.removeFromRight (4);
+    wavetableButton.setBounds (wavetableBar);
+
+    auto reverbBar = bounds.removeFromTop (barHeight).reduced (4);
+    traceButton.setBounds (reverbBar.removeFromRight (150));
+    reverbBar.removeFromRight (4);
+    roomButton.setBounds (reverbBar.removeFromRight (80));
+    reverbBar.removeFromRight (4);
+    impulseResponseButton.setBounds (reverbBar);
+
+    parameterEditor->setBounds (bounds);
+}
+
+void SubSynthAudioProcessorEditor::audioProcessorChanged (juce::AudioProcessor*, const ChangeDetails& details)
+{
+    // May come from whichever thread restored the state.
+    if (details.parameterInfoChanged)
+    {
+        triggerAsyncUpdate();
+    }
+}
+
+void SubSynthAudioProcessorEditor::handleAsyncUpdate()
+{
+    parameterEditor = std::make_unique<juce::GenericAudioProcessorEditor> (audioProcessor);
+    addAndMakeVisible (*parameterEditor);
+    resized();
+    updateFileButtons();
+}
+
+void SubSynthAudioProcessorEditor::timerCallback()
+{
+    updateFileButtons();
+
+    const int voices = audioProcessor.getVoiceCount();
+    footprintLabel.setText (voices == 0 ? juce::String()
+                                        : juce::String (voices) + (voices == 1 ? " voice, " : " voices, ")
+                                            + juce::File::descriptionOfSizeInBytes (juce::int64 (audioProcessor.getMemoryFootprint())),
+                            juce::dontSendNotification);
+}
+
+void SubSynthAudioProcessorEditor::chooseWavetable()
+{
+    const int part = audioProcessor.getEditedPart();
+    fileChooser = std::make_unique<juce::FileChooser> ("Load a wavetable for part " + juce::String (part + 1),
+                                                       audioProcessor.getWavetableFile (part),
+                                                       "*.wav;*.aif;*.aiff;*.flac");
+
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    fileChooser->launchAsync (flags, [this, part] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        if (file != juce::File())
+        {
+            audioProcessor.loadWavetable (part, file);
+            updateFileButtons();
+        }
+    });
+}
+
+void SubSynthAudioProcessorEditor::chooseImpulseResponse()
+{
+    fileChooser = std::make_unique<juce::FileChooser> ("Load an impulse response",
+                                                       audioProcessor.getImpulseResponseFile(),
+                                                       "*.wav;*.aif;*.aiff;*.flac");
+
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    fileChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        if (file != juce::File())
+        {
+            audioProcessor.loadImpulseResponse (file);
+            updateFileButtons();
+        }
+    });
+}
+
+void SubSynthAudioProcessorEditor::toggleTrace()
+{
+    // The tracer is shared by every instance in the process, so this
+    // starts or stops the trace for all of them.
+    if (Tracer::isEnabled())
+    {
+        Tracer::getInstance().stop();
+        updateFileButtons();
+        return;
+    }
+
+    fileChooser = std::make_unique<juce::FileChooser> ("Write a trace",
+                                                       juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                                                           .getChildFile ("SubSynth trace.json"),
+                                                       "*.json");
+
+    const auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+    fileChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        if (file != juce::File())
+        {
+            Tracer::getInstance().start (file.withFileExtension ("json"));
+            updateFileButtons();
+        }
+    });
+}
+
+void SubSynthAudioProcessorEditor::updateFileButtons()
+{
+    const int part = audioProcessor.getEditedPart();
+    const auto wavetable = audioProcessor.getWavetableFile (part);
+    wavetableButton.setButtonText ("Part " + juce::String (part + 1) + " oscillators: "
+                                   + (wavetable == juce::File() ? juce::String ("saw") : wavetable.getFileName()));
+    sawButton.setEnabled (wavetable != juce::File());
+
+    const auto impulseResponse = audioProcessor.getImpulseResponseFile();
+    impulseResponseButton.setButtonText ("Reverb: " + (impulseResponse == juce::File() ? juce::String ("synthetic room")
+                                                                                        : impulseResponse.getFileName()));
+    roomButton.setEnabled (impulseResponse != juce::File());
+
+    traceButton.setButtonText (Tracer::isEnabled() ? "Stop trace" : "Start trace");
 }
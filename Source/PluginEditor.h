@@ -13,8 +13,14 @@
 
 //==============================================================================
 /**
+    The generic parameter editor, under two bars for the things that are
+    not parameters: the files the synth loads, what the engine allocated,
+    and the timeline trace.
 */
-class SubSynthAudioProcessorEditor  : public juce::AudioProcessorEditor
+class SubSynthAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                      private juce::AudioProcessorListener,
+                                      private juce::AsyncUpdater,
+                                      private juce::Timer
 {
 public:
     SubSynthAudioProcessorEditor (SubSynthAudioProcessor&);
@@ -25,9 +31,37 @@ public:
     void resized() override;
 
 private:
+    static constexpr int barHeight = 32;
+
+    void chooseWavetable();
+    void chooseImpulseResponse();
+    void toggleTrace();
+    void updateFileButtons();
+
+    // Switching the edited part sets the parameters without the usual
+    // notifications, so the parameter editor is rebuilt to show them.
+    void audioProcessorParameterChanged (juce::AudioProcessor*, int, float) override {}
+    void audioProcessorChanged (juce::AudioProcessor*, const ChangeDetails& details) override;
+    void handleAsyncUpdate() override;
+
+    // The engine is rebuilt in the background when the polyphony or the
+    // quality settings change, a restored state can bring other files, and
+    // another instance can start or stop the trace, so all three are
+    // polled.
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     SubSynthAudioProcessor& audioProcessor;
 
+    std::unique_ptr<juce::GenericAudioProcessorEditor> parameterEditor;
+    juce::TextButton wavetableButton;
+    juce::TextButton sawButton { "Saw" };
+    juce::TextButton impulseResponseButton;
+    juce::TextButton roomButton { "Room" };
+    juce::Label footprintLabel;
+    juce::TextButton traceButton;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SubSynthAudioProcessorEditor)
 };
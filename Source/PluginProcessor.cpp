@@ -16,17 +16,17 @@ inline static void castParameter(juce::AudioProcessorValueTreeState& apvts, cons
     jassert(destination);
 }
 
+// The state property holding a part's wavetable file. Part 1 keeps the one
+// states saved before there were parts use.
+static juce::Identifier getWavetableProperty(int part)
+{
+    return part == 0 ? juce::Identifier("wavetable") : juce::Identifier("wavetable" + juce::String(part + 1));
+}
+
 //==============================================================================
 SubSynthAudioProcessor::SubSynthAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
+     : AudioProcessor (createBusesProperties())
 #endif
 {
     castParameter(apvts, ParameterID::oscMix, oscMixParam);
@@ -51,13 +51,89 @@ SubSynthAudioProcessor::SubSynthAudioProcessor()
     castParameter(apvts, ParameterID::octave, octaveParam);
     castParameter(apvts, ParameterID::tuning, tuningParam);
     castParameter(apvts, ParameterID::outputLevel, outputLevelParam);
+    castParameter(apvts, ParameterID::polyphony, polyphonyParam);
+    castParameter(apvts, ParameterID::multitimbral, multitimbralParam);
+    castParameter(apvts, ParameterID::editPart, editPartParam);
+
+    castParameter(apvts, ParameterID::modSource1, modSourceParams[0]);
+    castParameter(apvts, ParameterID::modSource2, modSourceParams[1]);
+    castParameter(apvts, ParameterID::modSource3, modSourceParams[2]);
+    castParameter(apvts, ParameterID::modSource4, modSourceParams[3]);
+    castParameter(apvts, ParameterID::modDest1, modDestParams[0]);
+    castParameter(apvts, ParameterID::modDest2, modDestParams[1]);
+    castParameter(apvts, ParameterID::modDest3, modDestParams[2]);
+    castParameter(apvts, ParameterID::modDest4, modDestParams[3]);
+    castParameter(apvts, ParameterID::modAmount1, modAmountParams[0]);
+    castParameter(apvts, ParameterID::modAmount2, modAmountParams[1]);
+    castParameter(apvts, ParameterID::modAmount3, modAmountParams[2]);
+    castParameter(apvts, ParameterID::modAmount4, modAmountParams[3]);
+    castParameter(apvts, ParameterID::reverbMix, reverbMixParam);
+    castParameter(apvts, ParameterID::reverbDecay, reverbDecayParam);
+    castParameter(apvts, ParameterID::wavetablePosition, wavetablePositionParam);
+    castParameter(apvts, ParameterID::partials, partialsParam);
+    castParameter(apvts, ParameterID::partialTilt, partialTiltParam);
+    castParameter(apvts, ParameterID::partialBalance, partialBalanceParam);
+    castParameter(apvts, ParameterID::partialDecay, partialDecayParam);
+    castParameter(apvts, ParameterID::renderAhead, renderAheadParam);
+    castParameter(apvts, ParameterID::oversampling, oversamplingParam);
+    castParameter(apvts, ParameterID::noteCache, noteCacheParam);
+    castParameter(apvts, ParameterID::noteCacheSize, noteCacheSizeParam);
+    castParameter(apvts, ParameterID::reducedRate, reducedRateParam);
+    castParameter(apvts, ParameterID::parallelVoices, parallelVoicesParam);
+
+    partParameterFields = {
+        { oscMixParam, &SynthParameters::oscMix },
+        { oscTuneParam, &SynthParameters::oscTune },
+        { oscFineParam, &SynthParameters::oscFine },
+        { filterFreqParam, &SynthParameters::filterFreq },
+        { filterResoParam, &SynthParameters::filterReso },
+        { filterEnvParam, &SynthParameters::filterEnv },
+        { filterLFOParam, &SynthParameters::filterLFO },
+        { filterVelocityParam, &SynthParameters::filterVelocity },
+        { filterAttackParam, &SynthParameters::filterAttack },
+        { filterDecayParam, &SynthParameters::filterDecay },
+        { filterSustainParam, &SynthParameters::filterSustain },
+        { filterReleaseParam, &SynthParameters::filterRelease },
+        { envAttackParam, &SynthParameters::envAttack },
+        { envDecayParam, &SynthParameters::envDecay },
+        { envSustainParam, &SynthParameters::envSustain },
+        { envReleaseParam, &SynthParameters::envRelease },
+        { lfoRateParam, &SynthParameters::lfoRate },
+        { vibratoParam, &SynthParameters::vibrato },
+        { noiseParam, &SynthParameters::noise },
+        { octaveParam, &SynthParameters::octave },
+        { tuningParam, &SynthParameters::tuning },
+        { outputLevelParam, &SynthParameters::outputLevel },
+        { polyphonyParam, &SynthParameters::polyphony },
+        { wavetablePositionParam, &SynthParameters::wavetablePosition },
+        { partialsParam, &SynthParameters::partials },
+        { partialTiltParam, &SynthParameters::partialTilt },
+        { partialBalanceParam, &SynthParameters::partialBalance },
+        { partialDecayParam, &SynthParameters::partialDecay },
+    };
 
     apvts.state.addListener(this);
+    stemChannels.fill(-1);
+
+    // Tracing can be switched on for a whole host session by pointing
+    // SUBSYNTH_TRACE at the file to write.
+    const auto tracePath = juce::SystemStats::getEnvironmentVariable("SUBSYNTH_TRACE", {});
+    if (tracePath.isNotEmpty() && !Tracer::isEnabled())
+    {
+        Tracer::getInstance().start(juce::File(tracePath));
+    }
+
+    timerCallback();
+    startTimerHz(30);
 }
 
 SubSynthAudioProcessor::~SubSynthAudioProcessor()
 {
+    stopTimer();
     apvts.state.removeListener(this);
+
+    // Render-ahead workers update the reverb, so they stop first.
+    engines.reset(nullptr);
 }
 
 //==============================================================================
@@ -95,7 +171,7 @@ bool SubSynthAudioProcessor::isMidiEffect() const
 
 double SubSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return reverbMixParam->get() > 0.0f ? reverb.getLengthSeconds() : 0.0;
 }
 
 int SubSynthAudioProcessor::getNumPrograms()
@@ -127,21 +203,191 @@ void SubSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    synth.allocateResources(sampleRate, samplesPerBlock);
+    preparedBlockSize = samplesPerBlock;
+    updateOutputChannels();
+    reverb.prepare(sampleRate);
+    reverb.reset();
+
+    // Processing is stopped, so the engine goes straight in.
+    auto next = createEngine(sampleRate, samplesPerBlock);
+    latestEngine = next.get();
+    engine = latestEngine;
+    engines.reset(std::move(next));
+    setLatencySamples(engine->latency);
     parametersChanged.store(true);
-    this->reset();
+}
+
+std::unique_ptr<SubSynthAudioProcessor::Engine> SubSynthAudioProcessor::createEngine(double sampleRate, int samplesPerBlock)
+{
+    auto next = std::make_unique<Engine>();
+    next->settings = getRequiredSettings();
+    const EngineSettings& settings = next->settings;
+    
+    // The pool is shared by every instance in the process; an engine only
+    // holds a reference while it renders in parallel.
+    if (settings.parallelVoices)
+    {
+        next->workerPool = std::make_unique<juce::SharedResourcePointer<WorkerPool>>();
+    }
+    
+    // The routing, the tuning and the wavetable are handed over like any
+    // later change, and picked up with the engine's first block.
+    auto configure = [&](auto& engineSynth)
+    {
+        engineSynth.maxPolyphony = settings.polyphony;
+        engineSynth.oversampling = settings.oversampling;
+        engineSynth.noteCacheBytes = settings.noteCacheBytes;
+        engineSynth.additive = settings.additive;
+        engineSynth.subBlockSize = subBlockSize;
+        engineSynth.minInternalRate = settings.reducedRate ? minInternalRate : 0.0;
+        engineSynth.workerPool = next->workerPool != nullptr ? static_cast<WorkerPool*>(*next->workerPool) : nullptr;
+        engineSynth.stemChannels = stemChannels;
+        engineSynth.modMatrix.setRouting(modSlots);
+        engineSynth.tuning.publish(tuning);
+        for (int part = 0; part < Synth<float>::numParts; ++part)
+        {
+            engineSynth.wavetables[size_t(part)].load(getWavetableFile(part));
+        }
+        engineSynth.allocateResources(sampleRate, samplesPerBlock);
+    };
+    
+    if (isUsingDoublePrecision())
+    {
+        configure(next->doubleSynth);
+    }
+    else
+    {
+        configure(next->synth);
+    }
+    
+    resetEngine(*next);
+    return next;
 }
 
 void SubSynthAudioProcessor::reset()
 {
-    synth.reset();
+    // Processing is stopped, so an engine still waiting for the audio
+    // thread takes over here.
+    engine = engines.flush();
+    if (engine != nullptr)
+    {
+        resetEngine(*engine);
+    }
+    reverb.reset();
+}
+
+void SubSynthAudioProcessor::resetEngine(Engine& target)
+{
+    // The worker may be rendering ahead, so it is stopped before the
+    // engines are touched and restarted with an empty queue.
+    target.renderAhead.release();
+    target.doubleRenderAhead.release();
+
+    target.synth.reset();
+    target.doubleSynth.reset();
+
+    prepareRenderAhead(target);
+}
+
+void SubSynthAudioProcessor::prepareRenderAhead(Engine& target)
+{
+    // Upsampling from a reduced internal rate delays the output as well.
+    target.latency = isUsingDoublePrecision() ? target.doubleSynth.getLatencySamples() : target.synth.getLatencySamples();
+    
+    if (!target.settings.renderAhead || preparedBlockSize <= 0)
+    {
+        return;
+    }
+
+    auto prepare = [this, &target](auto& worker, auto sampleType)
+    {
+        using SampleType = decltype(sampleType);
+        worker.prepare(getSampleRate(), preparedBlockSize, getTotalNumOutputChannels(),
+                       [this, &engineSynth = target.getSynth<SampleType>()](juce::AudioBuffer<SampleType>& block, juce::MidiBuffer& midi, bool changed)
+                       {
+                           if (changed)
+                           {
+                               SUBSYNTH_TRACE_SCOPE("update");
+                               update(engineSynth);
+                           }
+                           splitBuffer(engineSynth, block, midi);
+                       });
+        target.latency += worker.getLatencySamples();
+    };
+
+    if (isUsingDoublePrecision())
+    {
+        prepare(target.doubleRenderAhead, 0.0);
+    }
+    else
+    {
+        prepare(target.renderAhead, 0.0f);
+    }
 }
 
 void SubSynthAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
-    synth.deallocateResources();
+    engines.reset(nullptr);
+    engine = nullptr;
+    latestEngine = nullptr;
+    reverb.release();
+}
+
+int SubSynthAudioProcessor::getVoiceCount() const
+{
+    if (latestEngine == nullptr)
+    {
+        return 0;
+    }
+    return isUsingDoublePrecision() ? latestEngine->doubleSynth.getVoiceCount() : latestEngine->synth.getVoiceCount();
+}
+
+size_t SubSynthAudioProcessor::getMemoryFootprint() const
+{
+    if (latestEngine == nullptr)
+    {
+        return 0;
+    }
+    return latestEngine->synth.getMemoryFootprint() + latestEngine->doubleSynth.getMemoryFootprint();
+}
+
+juce::AudioProcessor::BusesProperties SubSynthAudioProcessor::createBusesProperties()
+{
+    auto buses = BusesProperties()
+                #if ! JucePlugin_IsMidiEffect
+                 #if ! JucePlugin_IsSynth
+                  .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                 #endif
+                  .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                #endif
+                  ;
+
+   #if ! JucePlugin_IsMidiEffect
+    buses = buses.withOutput ("Dry", juce::AudioChannelSet::stereo(), false);
+    for (int i = 0; i < Synth<float>::numParts; ++i)
+    {
+        buses = buses.withOutput ("Part " + juce::String(i + 1), juce::AudioChannelSet::stereo(), false);
+    }
+   #endif
+    return buses;
+}
+
+void SubSynthAudioProcessor::updateOutputChannels()
+{
+    auto channelOf = [this](int busIndex)
+    {
+        const auto* bus = getBus(false, busIndex);
+        return bus != nullptr && bus->isEnabled() ? getChannelIndexInProcessBlockBuffer(false, busIndex, 0) : -1;
+    };
+
+    dryChannel = channelOf(dryBus);
+
+    for (int i = 0; i < Synth<float>::numParts; ++i)
+    {
+        stemChannels[size_t(i)] = channelOf(firstStemBus + i);
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -165,14 +411,40 @@ bool SubSynthAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
         return false;
    #endif
 
+    // The dry bus and the part stems are stereo or off.
+    for (int bus = 1; bus < int(layouts.outputBuses.size()); ++bus)
+    {
+        const auto set = layouts.getChannelSet(false, bus);
+        if (!set.isDisabled() && set != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
     return true;
   #endif
 }
 #endif
 
+bool SubSynthAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
 void SubSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer, midiMessages);
+}
+
+void SubSynthAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    process(buffer, midiMessages);
+}
+
+template <typename SampleType>
+void SubSynthAudioProcessor::process (juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    SUBSYNTH_REALTIME_SCOPE;
+    SUBSYNTH_TRACE_SCOPE("processBlock", buffer.getNumSamples());
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -181,91 +453,261 @@ void SubSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
         buffer.clear(i, 0, buffer.getNumSamples());
     }
     
-    bool expected = true;
-    if (isNonRealtime() || parametersChanged.compare_exchange_strong(expected, false)) {
-        update();
+    // A rebuilt engine takes over here, and gets the parameters before it
+    // renders anything.
+    if (Engine* next = engines.acquire(); next != engine)
+    {
+        engine = next;
+        parametersChanged.store(true);
+    }
+    if (engine == nullptr)
+    {
+        buffer.clear();
+        midiMessages.clear();
+        return;
     }
     
-    splitBuffer(buffer, midiMessages);
+    auto& engineSynth = engine->getSynth<SampleType>();
+    auto& worker = engine->getRenderAhead<SampleType>();
+    if (worker.isPrepared())
+    {
+        // The update runs with the job, on whichever thread renders it.
+        const bool changed = parametersChanged.exchange(false) || isNonRealtime();
+        worker.process(buffer, midiMessages, changed);
+        midiMessages.clear();
+    }
+    else
+    {
+        bool expected = true;
+        if (isNonRealtime() || parametersChanged.compare_exchange_strong(expected, false)) {
+            SUBSYNTH_TRACE_SCOPE("update");
+            update(engineSynth);
+        }
+        
+        splitBuffer(engineSynth, buffer, midiMessages);
+    }
+    
+    // The dry bus is the main mix before the reverb; a mono main output
+    // feeds both of its channels.
+    if (dryChannel >= 0)
+    {
+        const int mainChannels = getMainBusNumOutputChannels();
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            buffer.copyFrom(dryChannel + channel, 0, buffer, std::min(channel, mainChannels - 1), 0, buffer.getNumSamples());
+        }
+    }
+    {
+        SUBSYNTH_TRACE_SCOPE("reverb");
+        auto mainOutput = getBusBuffer(buffer, false, 0);
+        reverb.process(mainOutput, isNonRealtime());
+    }
 }
 
-void SubSynthAudioProcessor::update()
+template <typename SampleType>
+void SubSynthAudioProcessor::update(Synth<SampleType>& engineSynth)
 {
-    float sampleRate = float(getSampleRate());
-    float inverseSampleRate = 1.0f / sampleRate;
+    // The message thread holds the lock only while it switches parts; the
+    // update is simply retried on the next block.
+    const juce::SpinLock::ScopedTryLockType lock(partLock);
+    if (!lock.isLocked())
+    {
+        parametersChanged.store(true);
+        return;
+    }
 
-    synth.envAttack = std::exp(-inverseSampleRate * std::exp(5.5f - 0.075f * envAttackParam->get()));
-    synth.envDecay = std::exp(-inverseSampleRate * std::exp(5.5f - 0.075f * envDecayParam->get()));
+    partParameters[size_t(editedPart.load())] = readPartParameters();
 
-    synth.envSustain = envSustainParam->get() / 100.0f;
+    const bool multitimbral = multitimbralParam->get();
+    const int numParts = multitimbral ? Synth<float>::numParts : 1;
 
-    float envRelease = envReleaseParam->get();
-    if (envRelease < 1.0f) {
-        synth.envRelease = 0.75f;
-    } else {
-        synth.envRelease = std::exp(-inverseSampleRate * std::exp(5.5f - 0.075f * envRelease));
+    engineSynth.multitimbral = multitimbral;
+    for (int i = 0; i < numParts; ++i)
+    {
+        partParameters[size_t(i)].applyTo(engineSynth, getSampleRate() / engineSynth.getRateDivisor(), i);
     }
 
-    float noiseMix = noiseParam->get() / 100.0f;
-    noiseMix *= noiseMix;
-    synth.noiseMix = noiseMix * 0.1f;
-    
-    synth.oscMixSmoother.setTargetValue(oscMixParam->get() / 100.0f);
-    
-    float semi = oscTuneParam->get();
-    float cent = oscFineParam->get() * 0.01f;
-    synth.oscBTune = std::pow(1.059463094359f, semi + cent);
+    reverb.setMix(reverbMixParam->get() / 100.0f);
+}
 
-    float octave = octaveParam->get();
-    float tuning = tuningParam->get();
-    synth.masterTune = (octave * 12.0f) + (tuning / 100.0f);
-    
-    synth.outputLevelSmoother.setTargetValue(juce::Decibels::decibelsToGain(outputLevelParam->get()));
-    
-    float filterVelocity = filterVelocityParam->get(); 
-    if (filterVelocity < -90.0f)
+SynthParameters SubSynthAudioProcessor::readPartParameters() const
+{
+    SynthParameters parameters;
+    for (const auto& field : partParameterFields)
     {
-        synth.velocitySensitivity = 0.0f;
-        synth.ignoreVelocity = true;
+        parameters.*(field.field) = field.parameter->get();
     }
-    else
+    return parameters;
+}
+
+void SubSynthAudioProcessor::loadPartParameters(const SynthParameters& parameters)
+{
+    // Switching parts is not an edit, so rather than sending the host a
+    // change it could record as automation for every parameter, the values
+    // are set quietly and the host is asked to read them again.
+    for (const auto& field : partParameterFields)
     {
-        synth.velocitySensitivity = 0.0005f * filterVelocity;
-        synth.ignoreVelocity = false;
+        juce::AudioProcessorParameter& parameter = *field.parameter;
+        parameter.setValue(field.parameter->convertTo0to1(parameters.*(field.field)));
     }
-    
-    const float inverseUpdateRate = inverseSampleRate * synth.LFO_MAX;
-    float lfoRate = std::exp(7.0f * lfoRateParam->get() - 4.0f);
-    synth.lfoInc = lfoRate * inverseUpdateRate * float(TWO_PI);
-    
-    float vibrato = vibratoParam->get() / 200.0f;
-    synth.vibrato = 0.2f * vibrato * vibrato;
-    
-    synth.pwmDepth = synth.vibrato;
-    if (vibrato < 0.0f)
-    { 
-        synth.vibrato = 0.0f;
+    updateHostDisplay(juce::AudioProcessor::ChangeDetails().withParameterInfoChanged(true));
+}
+
+void SubSynthAudioProcessor::timerCallback()
+{
+    std::array<ModSlot, ModMatrix::numSlots> slots;
+    for (int i = 0; i < ModMatrix::numSlots; ++i)
+    {
+        slots[size_t(i)].source = ModSource(modSourceParams[size_t(i)]->getIndex());
+        slots[size_t(i)].destination = ModDestination(modDestParams[size_t(i)]->getIndex());
+        slots[size_t(i)].amount = modAmountParams[size_t(i)]->get() / 100.0f;
+    }
+
+    if (slots != modSlots)
+    {
+        modSlots = slots;
+        if (latestEngine != nullptr)
+        {
+            latestEngine->synth.modMatrix.setRouting(modSlots);
+            latestEngine->doubleSynth.modMatrix.setRouting(modSlots);
+        }
+    }
+
+    // Only rebuilds when the decay has changed.
+    reverb.setDecay(reverbDecayParam->get());
+    reverb.collectGarbage();
+
+    if (latestEngine != nullptr)
+    {
+        for (int part = 0; part < Synth<float>::numParts; ++part)
+        {
+            latestEngine->synth.wavetables[size_t(part)].collectGarbage();
+            latestEngine->doubleSynth.wavetables[size_t(part)].collectGarbage();
+        }
+    }
+
+    // Of several queued tuning messages, each applies to the result of the
+    // one before, and only the last result is published.
+    std::shared_ptr<const Tuning> retuned = tuning;
+    const auto scope = tuningSysExFifo.read(tuningSysExFifo.getNumReady());
+    for (int i = 0; i < scope.blockSize1 + scope.blockSize2; ++i)
+    {
+        const int index = i < scope.blockSize1 ? scope.startIndex1 + i : scope.startIndex2 + i - scope.blockSize1;
+        if (auto next = retuned->withSysEx(tuningSysEx[size_t(index)].data(), tuningSysExSizes[size_t(index)]))
+        {
+            retuned = std::move(next);
+        }
+    }
+    // The engine has already retuned itself at each message's sample, so
+    // this only keeps the tuning for the plugin state and for engines
+    // built later.
+    if (retuned != tuning)
+    {
+        saveTuning(std::move(retuned));
+    }
+    if (latestEngine != nullptr)
+    {
+        latestEngine->synth.tuning.collectGarbage();
+        latestEngine->doubleSynth.tuning.collectGarbage();
+    }
+
+    const int part = multitimbralParam->get() ? editPartParam->getIndex() : 0;
+    if (part != editedPart.load())
+    {
+        const juce::SpinLock::ScopedLockType lock(partLock);
+        partParameters[size_t(editedPart.load())] = readPartParameters();
+        editedPart.store(part);
+        loadPartParameters(partParameters[size_t(part)]);
+        parametersChanged.store(true);
+    }
+
+    // Growing or shrinking the voice pool, changing the oversampling or the
+    // note cache size, turning the partials of every part off or any on, or
+    // switching the note cache, parallel voices, the reduced rate or
+    // render-ahead reallocates. The new engine is built
+    // here, while the old one keeps playing, and starts from silence when
+    // the audio thread swaps it in. The host hears about the new latency
+    // straight away.
+    engines.collectGarbage();
+    if (latestEngine != nullptr && getRequiredSettings() != latestEngine->settings)
+    {
+        auto next = createEngine(getSampleRate(), preparedBlockSize);
+        latestEngine = next.get();
+        setLatencySamples(latestEngine->latency);
+        engines.publish(std::move(next));
     }
-    
-    synth.filterKeyTracking = 0.08f * filterFreqParam->get() - 1.5f;
-    
-    float filterReso = filterResoParam->get() / 100.0f;
-    synth.filterQ = std::exp(3.0f * filterReso);
-    
-    
-    float filterLFO = filterLFOParam->get() / 100.0f;
-    synth.filterLFODepth = 2.5f * filterLFO * filterLFO;
-    
-    synth.filterAttack = std::exp(-inverseUpdateRate * std::exp(5.5f - 0.075f * filterAttackParam->get()));
-    synth.filterDecay = std::exp(-inverseUpdateRate * std::exp(5.5f - 0.075f * filterDecayParam->get()));
-    float filterSustain = filterSustainParam->get() / 100.0f;
-    synth.filterSustain = filterSustain * filterSustain;
-    synth.filterRelease = std::exp(-inverseUpdateRate * std::exp(5.5f - 0.075f * filterReleaseParam->get()));
-    
-    synth.filterEnvDepth = 0.06f * filterEnvParam->get();
 }
 
-void SubSynthAudioProcessor::splitBuffer(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages)
+SubSynthAudioProcessor::EngineSettings SubSynthAudioProcessor::getRequiredSettings()
+{
+    EngineSettings settings;
+    settings.polyphony = getRequiredPolyphony();
+    settings.oversampling = 1 << oversamplingParam->getIndex();
+    if (noteCacheParam->get())
+    {
+        settings.noteCacheBytes = (minNoteCacheMegabytes << 20) << noteCacheSizeParam->getIndex();
+    }
+    settings.additive = isAdditiveRequired();
+    settings.parallelVoices = parallelVoicesParam->get();
+    settings.reducedRate = reducedRateParam->get();
+    settings.renderAhead = renderAheadParam->get();
+    return settings;
+}
+
+bool SubSynthAudioProcessor::isAdditiveRequired()
+{
+    // The same rounding as SynthParameters::applyTo().
+    auto playsPartials = [](float partials)
+    {
+        return juce::roundToInt(partials) > 0;
+    };
+
+    if (playsPartials(partialsParam->get()))
+    {
+        return true;
+    }
+    if (!multitimbralParam->get())
+    {
+        return false;
+    }
+
+    const juce::SpinLock::ScopedLockType lock(partLock);
+    for (int i = 0; i < Synth<float>::numParts; ++i)
+    {
+        if (i != editedPart.load() && playsPartials(partParameters[size_t(i)].partials))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SubSynthAudioProcessor::getRequiredPolyphony()
+{
+    auto voicesFor = [](float polyphony)
+    {
+        return std::clamp(juce::roundToInt(polyphony), 1, Synth<float>::numVoices);
+    };
+
+    if (!multitimbralParam->get())
+    {
+        return voicesFor(polyphonyParam->get());
+    }
+
+    // Parts share the pool, so it only needs as many voices as all part
+    // limits together.
+    const juce::SpinLock::ScopedLockType lock(partLock);
+    int total = 0;
+    for (int i = 0; i < Synth<float>::numParts; ++i)
+    {
+        total += i == editedPart.load() ? voicesFor(polyphonyParam->get())
+                                        : voicesFor(partParameters[size_t(i)].polyphony);
+    }
+    return std::min(total, Synth<float>::numVoices);
+}
+
+template <typename SampleType>
+void SubSynthAudioProcessor::splitBuffer(Synth<SampleType>& engineSynth, juce::AudioBuffer<SampleType> &buffer, juce::MidiBuffer &midiMessages)
 {
     int bufferOffset = 0;
     
@@ -275,7 +717,7 @@ void SubSynthAudioProcessor::splitBuffer(juce::AudioBuffer<float> &buffer, juce:
         
         if (noOfSamplesTillMessage > 0)
         {
-            render(buffer, noOfSamplesTillMessage, bufferOffset);
+            render(engineSynth, buffer, noOfSamplesTillMessage, bufferOffset);
             bufferOffset += noOfSamplesTillMessage;
         }
         
@@ -283,27 +725,50 @@ void SubSynthAudioProcessor::splitBuffer(juce::AudioBuffer<float> &buffer, juce:
         {
             uint8_t data1 = message.numBytes >= 2 ? message.data[1] : 0;
             uint8_t data2 = message.numBytes == 3 ? message.data[2] : 0;
-            handleMidi(message.data[0], data1, data2);
+            handleMidi(engineSynth, message.data[0], data1, data2);
+        }
+        else if (engineSynth.retune(message.data, message.numBytes))
+        {
+            queueTuningSysEx(message.data, message.numBytes);
         }
     }
     
     int noOfFinalSamples = buffer.getNumSamples() - bufferOffset;
     if (noOfFinalSamples > 0)
     {
-        render(buffer, noOfFinalSamples, bufferOffset);
+        render(engineSynth, buffer, noOfFinalSamples, bufferOffset);
     }
     
     midiMessages.clear();
 }
 
-void SubSynthAudioProcessor::handleMidi(uint8_t data0, uint8_t data1, uint8_t data2)
+void SubSynthAudioProcessor::queueTuningSysEx(const uint8_t* data, int size)
 {
-    synth.midiMessage(data0, data1, data2);
+    // Dropped when too long to be a tuning message or when the queue is
+    // full, in which case only the saved tuning misses it.
+    if (size > maxTuningSysExSize)
+    {
+        return;
+    }
+    const auto scope = tuningSysExFifo.write(1);
+    if (scope.blockSize1 > 0)
+    {
+        std::copy(data, data + size, tuningSysEx[size_t(scope.startIndex1)].begin());
+        tuningSysExSizes[size_t(scope.startIndex1)] = size;
+    }
 }
 
-void SubSynthAudioProcessor::render(juce::AudioBuffer<float> &buffer, int sampleCount, int bufferOffset)
+template <typename SampleType>
+void SubSynthAudioProcessor::handleMidi(Synth<SampleType>& engineSynth, uint8_t data0, uint8_t data1, uint8_t data2)
 {
-    synth.render(buffer, bufferOffset, sampleCount, getTotalNumOutputChannels());
+    engineSynth.midiMessage(data0, data1, data2);
+}
+
+template <typename SampleType>
+void SubSynthAudioProcessor::render(Synth<SampleType>& engineSynth, juce::AudioBuffer<SampleType> &buffer, int sampleCount, int bufferOffset)
+{
+    SUBSYNTH_TRACE_SCOPE("render segment", sampleCount);
+    engineSynth.render(buffer, bufferOffset, sampleCount, getMainBusNumOutputChannels());
 }
 
 //==============================================================================
@@ -314,25 +779,138 @@ bool SubSynthAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* SubSynthAudioProcessor::createEditor()
 {
-    auto editor = new juce::GenericAudioProcessorEditor(*this);
-    editor->setSize(500, 500);
-    return editor;
+    return new SubSynthAudioProcessorEditor(*this);
 }
 //==============================================================================
 void SubSynthAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    copyXmlToBinary(*apvts.copyState().createXml(), destData);
+    auto state = apvts.copyState();
+
+    // The plugin parameters already hold the edited part, so only the
+    // snapshots are stored alongside them.
+    juce::ValueTree partsTree("Parts");
+    {
+        const juce::SpinLock::ScopedLockType lock(partLock);
+        for (int i = 0; i < Synth<float>::numParts; ++i)
+        {
+            const SynthParameters parameters = i == editedPart.load() ? readPartParameters() : partParameters[size_t(i)];
+            juce::ValueTree partTree("Part");
+            for (const auto& field : partParameterFields)
+            {
+                partTree.setProperty(field.parameter->paramID, parameters.*(field.field), nullptr);
+            }
+            partsTree.appendChild(partTree, nullptr);
+        }
+    }
+    state.appendChild(partsTree, nullptr);
+
+    copyXmlToBinary(*state.createXml(), destData);
 }
 
 void SubSynthAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml.get() != nullptr && xml->hasTagName(apvts.state.getType())) {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        auto state = juce::ValueTree::fromXml(*xml);
+        auto partsTree = state.getChildWithName("Parts");
+        state.removeChild(partsTree, nullptr);
+        apvts.replaceState(state);
+
+        const juce::SpinLock::ScopedLockType lock(partLock);
+        for (int i = 0; i < Synth<float>::numParts; ++i)
+        {
+            SynthParameters parameters;
+            auto partTree = partsTree.getChild(i);
+            for (const auto& field : partParameterFields)
+            {
+                parameters.*(field.field) = partTree.getProperty(field.parameter->paramID, parameters.*(field.field));
+            }
+            partParameters[size_t(i)] = parameters;
+        }
+        editedPart.store(multitimbralParam->get() ? editPartParam->getIndex() : 0);
+
+        // Part switches leave the parameter tree behind, so the edited
+        // part is taken from its snapshot rather than from the tree. States
+        // saved before there were parts only have the tree.
+        if (partsTree.isValid())
+        {
+            loadPartParameters(partParameters[size_t(editedPart.load())]);
+        }
+
+        for (int part = 0; part < Synth<float>::numParts; ++part)
+        {
+            loadWavetable(part, getWavetableFile(part));
+        }
+        loadImpulseResponse(juce::File(apvts.state.getProperty("impulseResponse").toString()));
+
+        auto savedTuning = Tuning::fromString(apvts.state.getProperty("tuning").toString());
+        setTuning(savedTuning != nullptr ? savedTuning : std::make_shared<Tuning>());
+
         parametersChanged.store(true);
     }
 }
 
+void SubSynthAudioProcessor::loadWavetable(int part, const juce::File& file)
+{
+    apvts.state.setProperty(getWavetableProperty(part), file.getFullPathName(), nullptr);
+
+    // Both engines get the same shared table; the second load is only a
+    // lookup. An engine built later loads it from the state.
+    if (latestEngine != nullptr)
+    {
+        latestEngine->synth.wavetables[size_t(part)].load(file);
+        latestEngine->doubleSynth.wavetables[size_t(part)].load(file);
+    }
+}
+
+juce::File SubSynthAudioProcessor::getWavetableFile(int part) const
+{
+    return juce::File(apvts.state.getProperty(getWavetableProperty(part)).toString());
+}
+
+void SubSynthAudioProcessor::loadImpulseResponse(const juce::File& file)
+{
+    apvts.state.setProperty("impulseResponse", file.getFullPathName(), nullptr);
+    reverb.loadImpulseResponse(file);
+}
+
+bool SubSynthAudioProcessor::loadTuning(const juce::File& scaleFile, const juce::File& keyboardMappingFile,
+                                        juce::String& error)
+{
+    auto newTuning = Tuning::loadScala(scaleFile, keyboardMappingFile, error);
+    if (newTuning == nullptr)
+    {
+        return false;
+    }
+    setTuning(std::move(newTuning));
+    return true;
+}
+
+void SubSynthAudioProcessor::resetTuning()
+{
+    setTuning(std::make_shared<Tuning>());
+}
+
+void SubSynthAudioProcessor::saveTuning(std::shared_ptr<const Tuning> newTuning)
+{
+    tuning = std::move(newTuning);
+
+    // The frequencies themselves are saved, so a preset keeps its tuning
+    // even if the scale files move.
+    apvts.state.setProperty("tuning", tuning->isEqualTemperament() ? juce::String() : tuning->toString(), nullptr);
+}
+
+void SubSynthAudioProcessor::setTuning(std::shared_ptr<const Tuning> newTuning)
+{
+    saveTuning(std::move(newTuning));
+
+    if (latestEngine != nullptr)
+    {
+        latestEngine->synth.tuning.publish(tuning);
+        latestEngine->doubleSynth.tuning.publish(tuning);
+    }
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout SubSynthAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
@@ -527,6 +1105,151 @@ juce::AudioProcessorValueTreeState::ParameterLayout SubSynthAudioProcessor::crea
         -6.0f,
         juce::AudioParameterFloatAttributes().withLabel("dB")));
 
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::polyphony,
+        "Polyphony",
+        juce::NormalisableRange<float>(1.0f, float(Synth<float>::numVoices), 1.0f),
+        float(Synth<float>::numVoices),
+        juce::AudioParameterFloatAttributes().withLabel("voices")));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        ParameterID::multitimbral,
+        "Multitimbral",
+        false));
+
+    juce::StringArray partNames;
+    for (int i = 0; i < Synth<float>::numParts; ++i)
+    {
+        partNames.add("Part " + juce::String(i + 1));
+    }
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::editPart,
+        "Edit Part",
+        partNames,
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::reverbMix,
+        "Reverb Mix",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::reverbDecay,
+        "Reverb Decay",
+        juce::NormalisableRange<float>(ConvolutionReverb::minDecay, ConvolutionReverb::maxDecay, 0.01f, 0.5f),
+        2.0f,
+        juce::AudioParameterFloatAttributes().withLabel("s")));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        ParameterID::renderAhead,
+        "Render Ahead",
+        false));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::oversampling,
+        "Oversampling",
+        juce::StringArray { "Off", "2x", "4x" },
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        ParameterID::noteCache,
+        "Note Cache",
+        false));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::noteCacheSize,
+        "Note Cache Size",
+        juce::StringArray { "8 MB", "16 MB", "32 MB", "64 MB", "128 MB" },
+        2));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        ParameterID::reducedRate,
+        "Reduced Rate",
+        false));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        ParameterID::parallelVoices,
+        "Parallel Voices",
+        false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::wavetablePosition,
+        "Wavetable Position",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    auto partialsStringFromValue = [](float value, int)
+    {
+        if (value < 0.5f)
+            return juce::String("OFF");
+        else
+            return juce::String(juce::roundToInt(value));
+    };
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::partials,
+        "Partials",
+        juce::NormalisableRange<float>(0.0f, float(PartialBank<float>::maxPartials), 1.0f),
+        0.0f,
+        juce::AudioParameterFloatAttributes()
+                .withStringFromValueFunction(partialsStringFromValue)));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::partialTilt,
+        "Partial Tilt",
+        juce::NormalisableRange<float>(-12.0f, 6.0f, 0.1f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB/oct")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::partialBalance,
+        "Odd/Even",
+        juce::NormalisableRange<float>(-100.0f, 100.0f, 1.0f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::partialDecay,
+        "Partial Decay",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("%")));
+
+    const juce::ParameterID modSourceIDs[] = { ParameterID::modSource1, ParameterID::modSource2,
+                                               ParameterID::modSource3, ParameterID::modSource4 };
+    const juce::ParameterID modDestIDs[] = { ParameterID::modDest1, ParameterID::modDest2,
+                                             ParameterID::modDest3, ParameterID::modDest4 };
+    const juce::ParameterID modAmountIDs[] = { ParameterID::modAmount1, ParameterID::modAmount2,
+                                               ParameterID::modAmount3, ParameterID::modAmount4 };
+
+    for (int i = 0; i < ModMatrix::numSlots; ++i)
+    {
+        juce::String slot(i + 1);
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            modSourceIDs[i],
+            "Mod " + slot + " Source",
+            ModMatrix::getSourceNames(),
+            0));
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            modDestIDs[i],
+            "Mod " + slot + " Dest",
+            ModMatrix::getDestinationNames(),
+            0));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            modAmountIDs[i],
+            "Mod " + slot + " Amount",
+            juce::NormalisableRange<float>(-100.0f, 100.0f, 0.1f),
+            0.0f,
+            juce::AudioParameterFloatAttributes().withLabel("%")));
+    }
+
     return layout;
 }
 
@@ -10,6 +10,12 @@
 
 #include <JuceHeader.h>
 #include "Synth.h"
+#include "SynthParameters.h"
+#include "ConvolutionReverb.h"
+#include "Tracer.h"
+#include "RenderAhead.h"
+#include "RealtimeAudit.h"
+#include "Handoff.h"
 
 namespace ParameterID
 {
@@ -37,6 +43,34 @@ namespace ParameterID
     PARAMETER_ID(octave)
     PARAMETER_ID(tuning)
     PARAMETER_ID(outputLevel)
+    PARAMETER_ID(polyphony)
+    PARAMETER_ID(multitimbral)
+    PARAMETER_ID(editPart)
+    PARAMETER_ID(modSource1)
+    PARAMETER_ID(modSource2)
+    PARAMETER_ID(modSource3)
+    PARAMETER_ID(modSource4)
+    PARAMETER_ID(modDest1)
+    PARAMETER_ID(modDest2)
+    PARAMETER_ID(modDest3)
+    PARAMETER_ID(modDest4)
+    PARAMETER_ID(modAmount1)
+    PARAMETER_ID(modAmount2)
+    PARAMETER_ID(modAmount3)
+    PARAMETER_ID(modAmount4)
+    PARAMETER_ID(reverbMix)
+    PARAMETER_ID(reverbDecay)
+    PARAMETER_ID(wavetablePosition)
+    PARAMETER_ID(renderAhead)
+    PARAMETER_ID(oversampling)
+    PARAMETER_ID(noteCache)
+    PARAMETER_ID(noteCacheSize)
+    PARAMETER_ID(reducedRate)
+    PARAMETER_ID(parallelVoices)
+    PARAMETER_ID(partials)
+    PARAMETER_ID(partialTilt)
+    PARAMETER_ID(partialBalance)
+    PARAMETER_ID(partialDecay)
 
     #undef PARAMETER_ID
 }
@@ -44,7 +78,7 @@ namespace ParameterID
 //==============================================================================
 /**
 */
-class SubSynthAudioProcessor  : public juce::AudioProcessor, private juce::ValueTree::Listener
+class SubSynthAudioProcessor  : public juce::AudioProcessor, private juce::ValueTree::Listener, private juce::Timer
 {
 public:
     //==============================================================================
@@ -61,6 +95,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -87,6 +123,41 @@ public:
 
     juce::AudioProcessorValueTreeState apvts { *this, nullptr, "Parameters", createParameterLayout() };
 
+    // Replaces the saw oscillators of one part with a wavetable read from
+    // an audio file, or brings them back for an empty File. Message thread;
+    // the table is built in the background and saved with the state. Parts
+    // loading the same file share one table.
+    void loadWavetable(int part, const juce::File& file);
+    juce::File getWavetableFile(int part) const;
+
+    // The part the parameters edit; always 0 unless multitimbral.
+    int getEditedPart() const { return editedPart.load(); }
+
+    // Convolves the reverb with an audio file instead of the synthetic
+    // room, or goes back to the room for an empty File. Message thread;
+    // the file is read in the background and saved with the state.
+    void loadImpulseResponse(const juce::File& file);
+    juce::File getImpulseResponseFile() const { return reverb.getImpulseResponseFile(); }
+
+    // Retunes every part to a Scala scale, with an optional keyboard
+    // mapping (a default File for none). Message thread. Returns false and
+    // keeps the current tuning if the files cannot be read. MIDI Tuning
+    // Standard SysEx retunes too; the tuning is saved with the state.
+    bool loadTuning(const juce::File& scaleFile, const juce::File& keyboardMappingFile, juce::String& error);
+    void resetTuning();
+
+    // Voices stolen by the engine playing now. Read it from the audio
+    // thread or while processing is stopped.
+    int getVoiceStealCount() const
+    {
+        return engine != nullptr ? engine->synth.getVoiceStealCount() + engine->doubleSynth.getVoiceStealCount() : 0;
+    }
+
+    // The voices of the engine built last and the bytes it owns; 0 while
+    // the plugin is not prepared. Message thread.
+    int getVoiceCount() const;
+    size_t getMemoryFootprint() const;
+
 private:
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
@@ -97,15 +168,164 @@ private:
 
     std::atomic<bool> parametersChanged { false };
     
-    void update();
+    template <typename SampleType>
+    void update (Synth<SampleType>& engineSynth);
+    
+    // Multitimbral mode keeps one parameter snapshot per part. The plugin
+    // parameters edit one part at a time; the others are held here and
+    // swapped in and out of the parameters on the message thread.
+    std::array<SynthParameters, Synth<float>::numParts> partParameters;
+    std::atomic<int> editedPart { 0 };
+    juce::SpinLock partLock;
+    
+    struct PartParameterField
+    {
+        juce::AudioParameterFloat* parameter;
+        float SynthParameters::* field;
+    };
+    std::vector<PartParameterField> partParameterFields;
+    
+    SynthParameters readPartParameters() const;
+    void loadPartParameters(const SynthParameters& parameters);
+    
+    // The mod matrix is compiled, the reverb's room is rebuilt, tuning
+    // SysEx is saved and the edited part is switched here, on the message
+    // thread, when their parameters change.
+    void timerCallback() override;
+    std::array<ModSlot, ModMatrix::numSlots> modSlots;
+    
+    // The tuning both engines play. SysEx tuning messages retune the
+    // engine at their own sample, in splitBuffer(); they are also copied
+    // into the FIFO there and applied to this copy in timerCallback(), for
+    // the plugin state and for engines built later. setTuning() publishes
+    // to the engines, saveTuning() only records.
+    std::shared_ptr<const Tuning> tuning = std::make_shared<Tuning>();
+    void setTuning(std::shared_ptr<const Tuning> newTuning);
+    void saveTuning(std::shared_ptr<const Tuning> newTuning);
+    static constexpr int maxTuningSysExSize = 408;  // a bulk dump
+    static constexpr int tuningSysExQueueSize = 8;
+    juce::AbstractFifo tuningSysExFifo { tuningSysExQueueSize };
+    std::array<std::array<uint8_t, maxTuningSysExSize>, tuningSysExQueueSize> tuningSysEx;
+    std::array<int, tuningSysExQueueSize> tuningSysExSizes {};
+    void queueTuningSysEx(const uint8_t* data, int size);
+    
+    // What an engine is allocated for. Changing any of these reallocates,
+    // so they are read when an engine is built rather than in update().
+    struct EngineSettings
+    {
+        // The polyphony setting, or the sum of the part limits in
+        // multitimbral mode.
+        int polyphony = Synth<float>::numVoices;
+        int oversampling = 1;  // 1, 2 or 4
+        size_t noteCacheBytes = 0;  // 0 with the cache off
+        bool additive = false;  // any part has a partial count
+        bool parallelVoices = false;
+        bool reducedRate = false;
+        bool renderAhead = false;
+        
+        bool operator== (const EngineSettings& other) const
+        {
+            return polyphony == other.polyphony && oversampling == other.oversampling
+                && noteCacheBytes == other.noteCacheBytes && additive == other.additive
+                && parallelVoices == other.parallelVoices
+                && reducedRate == other.reducedRate && renderAhead == other.renderAhead;
+        }
+        
+        bool operator!= (const EngineSettings& other) const
+        {
+            return !(*this == other);
+        }
+    };
+    EngineSettings getRequiredSettings();
+    int getRequiredPolyphony();
+    bool isAdditiveRequired();
+    
+    // How much memory the note cache gets when it is on: this many
+    // megabytes, doubled for every step of the Note Cache Size choice.
+    static constexpr size_t minNoteCacheMegabytes = 8;
+    
+    // The engines' block-rate work runs on this grid rather than on the
+    // host's blocks, so tiny blocks cost no more per sample than large ones.
+    static constexpr int subBlockSize = 64;
+    
+    // With the reduced-rate option the engines render at no less than this
+    // and are upsampled to the host rate.
+    static constexpr double minInternalRate = 44100.0;
+    
+    // Both engines, and whatever renders them, for one set of settings.
+    // Only the precision the host asked for is allocated and configured.
+    struct Engine
+    {
+        EngineSettings settings;
+        
+        // Held while voices render in parallel on the process-wide pool;
+        // declared first so it goes last.
+        std::unique_ptr<juce::SharedResourcePointer<WorkerPool>> workerPool;
+        
+        Synth<float> synth;
+        Synth<double> doubleSynth;
+        
+        // Opt-in: the active engine renders one block ahead on a worker.
+        RenderAhead<float> renderAhead;
+        RenderAhead<double> doubleRenderAhead;
+        
+        // Of the engine and of render-ahead, in host samples.
+        int latency = 0;
+        
+        template <typename SampleType>
+        Synth<SampleType>& getSynth()
+        {
+            if constexpr (std::is_same_v<SampleType, double>)
+                return doubleSynth;
+            else
+                return synth;
+        }
+        
+        template <typename SampleType>
+        RenderAhead<SampleType>& getRenderAhead()
+        {
+            if constexpr (std::is_same_v<SampleType, double>)
+                return doubleRenderAhead;
+            else
+                return renderAhead;
+        }
+    };
+    
+    // prepareToPlay() builds an engine and installs it directly. When the
+    // settings change later, timerCallback() builds a new one and hands it
+    // over; the audio thread swaps it in at the start of a block and the
+    // old one is deleted on the message thread. Processing never stops.
+    std::unique_ptr<Engine> createEngine (double sampleRate, int samplesPerBlock);
+    void prepareRenderAhead (Engine& target);
+    void resetEngine (Engine& target);
+    Handoff<Engine> engines;
+    Engine* engine = nullptr;        // the audio thread's
+    Engine* latestEngine = nullptr;  // the newest built, for the message thread
+    int preparedBlockSize = 0;
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SubSynthAudioProcessor)
     
-    Synth synth;
-    void splitBuffer (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
-    void handleMidi (uint8_t data0, uint8_t data1, uint8_t data2);
-    void render (juce::AudioBuffer<float>& buffer, int sampleCount, int bufferOffset);
+    ConvolutionReverb reverb;
+    
+    // Optional output buses after the main one: the synth before the
+    // reverb, then a stem per part. Their channels in the process buffer
+    // are looked up in prepareToPlay(); -1 while a bus is disabled.
+    static constexpr int dryBus = 1;
+    static constexpr int firstStemBus = 2;
+    static juce::AudioProcessor::BusesProperties createBusesProperties();
+    void updateOutputChannels();
+    int dryChannel = -1;
+    std::array<int, Synth<float>::numParts> stemChannels;
+
+    template <typename SampleType>
+    void process (juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+    template <typename SampleType>
+    void splitBuffer (Synth<SampleType>& engineSynth, juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+    template <typename SampleType>
+    void handleMidi (Synth<SampleType>& engineSynth, uint8_t data0, uint8_t data1, uint8_t data2);
+    template <typename SampleType>
+    void render (Synth<SampleType>& engineSynth, juce::AudioBuffer<SampleType>& buffer, int sampleCount, int bufferOffset);
     
     juce::AudioParameterFloat* oscMixParam;
     juce::AudioParameterFloat* oscTuneParam;
@@ -129,4 +349,23 @@ private:
     juce::AudioParameterFloat* octaveParam;
     juce::AudioParameterFloat* tuningParam;
     juce::AudioParameterFloat* outputLevelParam;
+    juce::AudioParameterFloat* polyphonyParam;
+    juce::AudioParameterBool* multitimbralParam;
+    juce::AudioParameterChoice* editPartParam;
+    std::array<juce::AudioParameterChoice*, ModMatrix::numSlots> modSourceParams;
+    std::array<juce::AudioParameterChoice*, ModMatrix::numSlots> modDestParams;
+    std::array<juce::AudioParameterFloat*, ModMatrix::numSlots> modAmountParams;
+    juce::AudioParameterFloat* reverbMixParam;
+    juce::AudioParameterFloat* reverbDecayParam;
+    juce::AudioParameterFloat* wavetablePositionParam;
+    juce::AudioParameterFloat* partialsParam;
+    juce::AudioParameterFloat* partialTiltParam;
+    juce::AudioParameterFloat* partialBalanceParam;
+    juce::AudioParameterFloat* partialDecayParam;
+    juce::AudioParameterBool* renderAheadParam;
+    juce::AudioParameterChoice* oversamplingParam;
+    juce::AudioParameterBool* noteCacheParam;
+    juce::AudioParameterChoice* noteCacheSizeParam;
+    juce::AudioParameterBool* reducedRateParam;
+    juce::AudioParameterBool* parallelVoicesParam;
 };
@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+    RealtimeAudit.cpp
+    Created: 18 Oct 2026 11:48:30pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "RealtimeAudit.h"
+
+#if SUBSYNTH_REALTIME_AUDIT
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    // Plain thread-locals, so the hooks can read them without allocating.
+    thread_local int scopeDepth = 0;
+    thread_local int allowDepth = 0;
+    thread_local int hookDepth = 0;
+
+    std::atomic<int> violations { 0 };
+
+    bool shouldAbort()
+    {
+        static const bool abortOnViolation = [] {
+            const char* mode = std::getenv("SUBSYNTH_REALTIME_AUDIT");
+            return mode != nullptr && std::strcmp(mode, "abort") == 0;
+        }();
+        return abortOnViolation;
+    }
+
+    void report(const char* function)
+    {
+        violations.fetch_add(1, std::memory_order_relaxed);
+
+        // Everything from here on runs inside the hook, so the allocations
+        // and writes it makes are not reported again.
+        std::fprintf(stderr, "SubSynth real-time audit: %s() on an audio thread\n%s\n",
+                     function, juce::SystemStats::getStackBacktrace().toRawUTF8());
+        std::fflush(stderr);
+
+        if (shouldAbort())
+        {
+            std::abort();
+        }
+    }
+
+    // Wraps every intercepted call. Only the outermost one on a thread is
+    // checked, so operator new does not count again for the malloc under it.
+    struct Hook
+    {
+        explicit Hook(const char* function)
+        {
+            if (++hookDepth == 1 && scopeDepth > 0 && allowDepth == 0)
+            {
+                report(function);
+            }
+        }
+
+        ~Hook()
+        {
+            --hookDepth;
+        }
+    };
+}
+
+RealtimeAudit::Scope::Scope() { ++scopeDepth; }
+RealtimeAudit::Scope::~Scope() { --scopeDepth; }
+RealtimeAudit::Allow::Allow() { ++allowDepth; }
+RealtimeAudit::Allow::~Allow() { --allowDepth; }
+
+int RealtimeAudit::getViolationCount()
+{
+    return violations.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+void* operator new(std::size_t size)
+{
+    Hook hook("operator new");
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    Hook hook("operator new[]");
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    Hook hook("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    Hook hook("operator new[]");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+    {
+        Hook hook("operator delete");
+        std::free(pointer);
+    }
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+    {
+        Hook hook("operator delete[]");
+        std::free(pointer);
+    }
+}
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete[](pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { operator delete[](pointer); }
+
+//==============================================================================
+// The C allocator and the blocking calls are replaced by symbol
+// interposition, forwarding to glibc's own entry points or to the next
+// definition of the symbol.
+#if defined(__GLIBC__)
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+
+namespace
+{
+    template <typename Function>
+    Function* next(Function*& function, const char* name)
+    {
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function*>(dlsym(RTLD_NEXT, name));
+        }
+        return function;
+    }
+
+    int (*nextMutexLock)(pthread_mutex_t*) = nullptr;
+    int (*nextCondWait)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    int (*nextCondTimedWait)(pthread_cond_t*, pthread_mutex_t*, const timespec*) = nullptr;
+   #if __GLIBC_PREREQ(2, 30)
+    int (*nextCondClockWait)(pthread_cond_t*, pthread_mutex_t*, clockid_t, const timespec*) = nullptr;
+   #endif
+    int (*nextSemWait)(sem_t*) = nullptr;
+    int (*nextNanosleep)(const timespec*, timespec*) = nullptr;
+    int (*nextClockNanosleep)(clockid_t, int, const timespec*, timespec*) = nullptr;
+    int (*nextUsleep)(useconds_t) = nullptr;
+    ssize_t (*nextRead)(int, void*, size_t) = nullptr;
+    ssize_t (*nextWrite)(int, const void*, size_t) = nullptr;
+}
+
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        Hook hook("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        Hook hook("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        Hook hook("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        Hook hook("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        Hook hook("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept
+    {
+        Hook hook("posix_memalign");
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        {
+            return EINVAL;
+        }
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer != nullptr || size == 0 ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+        {
+            Hook hook("free");
+            __libc_free(pointer);
+        }
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        Hook hook("pthread_mutex_lock");
+        return next(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    // std::condition_variable and juce::WaitableEvent wait through these;
+    // the mutex they take back on waking does not go through
+    // pthread_mutex_lock, so it would not be caught there.
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        Hook hook("pthread_cond_wait");
+        return next(nextCondWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* time)
+    {
+        Hook hook("pthread_cond_timedwait");
+        return next(nextCondTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+   #if __GLIBC_PREREQ(2, 30)
+    int pthread_cond_clockwait(pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock, const timespec* time)
+    {
+        Hook hook("pthread_cond_clockwait");
+        return next(nextCondClockWait, "pthread_cond_clockwait")(condition, mutex, clock, time);
+    }
+   #endif
+
+    int sem_wait(sem_t* semaphore)
+    {
+        Hook hook("sem_wait");
+        return next(nextSemWait, "sem_wait")(semaphore);
+    }
+
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        Hook hook("nanosleep");
+        return next(nextNanosleep, "nanosleep")(duration, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const timespec* duration, timespec* remaining)
+    {
+        Hook hook("clock_nanosleep");
+        return next(nextClockNanosleep, "clock_nanosleep")(clock, flags, duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        Hook hook("usleep");
+        return next(nextUsleep, "usleep")(microseconds);
+    }
+
+    ssize_t read(int file, void* buffer, size_t size)
+    {
+        Hook hook("read");
+        return next(nextRead, "read")(file, buffer, size);
+    }
+
+    ssize_t write(int file, const void* buffer, size_t size)
+    {
+        Hook hook("write");
+        return next(nextWrite, "write")(file, buffer, size);
+    }
+}
+
+#endif
+
+#endif
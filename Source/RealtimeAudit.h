@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    RealtimeAudit.h
+    Created: 18 Oct 2026 11:48:30pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Test-build check that the audio thread never does anything that can
+// block: allocate or free memory, lock a mutex, wait on a condition or
+// semaphore, sleep, or read and write files. SubSynthTests and
+// SubSynthStress are built with SUBSYNTH_REALTIME_AUDIT=1, which
+// intercepts those calls for the whole process; any made on a thread while
+// it is inside a Scope is a violation. Each one is printed to stderr with a
+// stack trace, and aborts the process when the SUBSYNTH_REALTIME_AUDIT
+// environment variable is set to "abort", so a debugger stops on the
+// culprit.
+//
+// The interception replaces operator new and delete and, on Linux, the C
+// allocator and the blocking libc calls by symbol interposition. That only
+// works for code linked into the executable, which is why this is for the
+// harness runners and never the plugin. Without the define, Scope and
+// Allow compile to nothing.
+//
+// The few deliberate exceptions, such as the brief mutex inside
+// WaitableEvent::signal() that wakes a sleeping worker, sit in an Allow.
+#ifndef SUBSYNTH_REALTIME_AUDIT
+ #define SUBSYNTH_REALTIME_AUDIT 0
+#endif
+
+namespace RealtimeAudit
+{
+   #if SUBSYNTH_REALTIME_AUDIT
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    class Allow
+    {
+    public:
+        Allow();
+        ~Allow();
+        JUCE_DECLARE_NON_COPYABLE(Allow)
+    };
+
+    // Violations anywhere in the process since it started.
+    int getViolationCount();
+    constexpr bool isEnabled() { return true; }
+   #else
+    struct Scope { Scope() {} };
+    struct Allow { Allow() {} };
+    inline int getViolationCount() { return 0; }
+    constexpr bool isEnabled() { return false; }
+   #endif
+}
+
+#define SUBSYNTH_REALTIME_SCOPE const RealtimeAudit::Scope JUCE_JOIN_MACRO(realtimeScope, __LINE__) {}
+#define SUBSYNTH_REALTIME_ALLOW const RealtimeAudit::Allow JUCE_JOIN_MACRO(realtimeAllow, __LINE__) {}
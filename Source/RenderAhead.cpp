@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    RenderAhead.cpp
+    Created: 18 Oct 2026 7:02:35pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "RenderAhead.h"
+
+template <typename SampleType>
+RenderAhead<SampleType>::RenderAhead()
+    : juce::Thread("SubSynth render ahead")
+{
+}
+
+template <typename SampleType>
+RenderAhead<SampleType>::~RenderAhead()
+{
+    release();
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::prepare(double sampleRate, int maximumBlockSize, int numChannels, RenderFunction renderFunction)
+{
+    release();
+
+    render = std::move(renderFunction);
+    latency = maximumBlockSize;
+    jobSize = (maximumBlockSize + 3) / 4;
+
+    // A job holds at most one maximum block. The floor leaves room for a
+    // SysEx message in a small one.
+    midiCapacity = std::max(4096, maximumBlockSize * maxEventsPerSample * getEventBytes(3));
+
+    for (Job& job : jobs)
+    {
+        job.block.setSize(numChannels, maximumBlockSize);
+        job.midi.clear();
+        job.midi.ensureSize(size_t(midiCapacity));
+        job.midiBytes = 0;
+        job.numSamples = 0;
+        job.parametersChanged = false;
+        job.state.store(JobState::free);
+    }
+    submitted.store(0);
+    nextToRun = 0;
+    nextToCollect = 0;
+    inlineRenders = 0;
+    droppedEvents = 0;
+
+    // The first block plays one block of silence.
+    fifo.setSize(numChannels, 2 * maximumBlockSize);
+    fifo.clear();
+    fifoRead = 0;
+    fifoCount = latency;
+
+    startRealtimeThread(juce::Thread::RealtimeOptions().withApproximateAudioProcessingTime(maximumBlockSize, sampleRate));
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::release()
+{
+    if (latency == 0)
+    {
+        return;
+    }
+    signalThreadShouldExit();
+    wakeUp.signal();
+    stopThread(1000);
+    latency = 0;
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midi, bool parametersChanged)
+{
+    const int numChannels = std::min(buffer.getNumChannels(), fifo.getNumChannels());
+
+    // A host block longer than announced is handled as several jobs.
+    for (int offset = 0; offset < buffer.getNumSamples(); offset += latency)
+    {
+        const int numSamples = std::min(latency, buffer.getNumSamples() - offset);
+
+        append(midi, offset, numSamples, parametersChanged && offset == 0);
+
+        // Everything queued adds up to the latency plus this block, and
+        // the open job holds less than jobSize of that, so the jobs
+        // queued before it are always enough to fill the block.
+        while (fifoCount < numSamples)
+        {
+            collect(nextToCollect);
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const int firstPart = std::min(numSamples, fifo.getNumSamples() - fifoRead);
+            buffer.copyFrom(channel, offset, fifo, channel, fifoRead, firstPart);
+            if (firstPart < numSamples)
+            {
+                buffer.copyFrom(channel, offset + firstPart, fifo, channel, 0, numSamples - firstPart);
+            }
+        }
+        fifoRead = (fifoRead + numSamples) % fifo.getNumSamples();
+        fifoCount -= numSamples;
+    }
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::append(const juce::MidiBuffer& midi, int startSample, int numSamples, bool parametersChanged)
+{
+    while (numSamples > 0)
+    {
+        // The open job is the one after the last queued. Only the audio
+        // thread touches it until submit() queues it.
+        const uint64_t index = submitted.load(std::memory_order_relaxed);
+        jassert(index - nextToCollect < numJobs);
+        Job& job = jobs[size_t(index % numJobs)];
+
+        const int length = std::min(numSamples, latency - job.numSamples);
+        for (auto it = midi.findNextSamplePosition(startSample); it != midi.end(); ++it)
+        {
+            const auto event = *it;
+            if (event.samplePosition >= startSample + length)
+            {
+                break;
+            }
+            const int bytes = getEventBytes(event.numBytes);
+            if (job.midiBytes + bytes > midiCapacity)
+            {
+                ++droppedEvents;
+                continue;
+            }
+            job.midi.addEvent(event.data, event.numBytes, event.samplePosition - startSample + job.numSamples);
+            job.midiBytes += bytes;
+        }
+        job.numSamples += length;
+        job.parametersChanged = job.parametersChanged || parametersChanged;
+        parametersChanged = false;
+        startSample += length;
+        numSamples -= length;
+
+        if (job.numSamples >= jobSize)
+        {
+            submit();
+        }
+    }
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::submit()
+{
+    const uint64_t index = submitted.load(std::memory_order_relaxed);
+    jobs[size_t(index % numJobs)].state.store(JobState::pending, std::memory_order_relaxed);
+    submitted.store(index + 1, std::memory_order_release);
+
+    // Waking the worker takes a brief mutex inside WaitableEvent; the
+    // worker never holds it while rendering.
+    SUBSYNTH_REALTIME_ALLOW;
+    wakeUp.signal();
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::collect(uint64_t jobIndex)
+{
+    Job& job = jobs[size_t(jobIndex % numJobs)];
+
+    // runNextJob() only fails while the worker is rendering, and then this
+    // waits for that one job to finish; see the class comment.
+    while (job.state.load(std::memory_order_acquire) != JobState::done)
+    {
+        if (!runNextJob(true))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Append the job's audio to the fifo.
+    const int writePosition = (fifoRead + fifoCount) % fifo.getNumSamples();
+    const int firstPart = std::min(job.numSamples, fifo.getNumSamples() - writePosition);
+    for (int channel = 0; channel < fifo.getNumChannels(); ++channel)
+    {
+        fifo.copyFrom(channel, writePosition, job.block, channel, 0, firstPart);
+        if (firstPart < job.numSamples)
+        {
+            fifo.copyFrom(channel, 0, job.block, channel, firstPart, job.numSamples - firstPart);
+        }
+    }
+    fifoCount += job.numSamples;
+
+    job.numSamples = 0;
+    job.parametersChanged = false;
+    job.midi.clear();
+    job.midiBytes = 0;
+    job.state.store(JobState::free, std::memory_order_release);
+    ++nextToCollect;
+}
+
+template <typename SampleType>
+bool RenderAhead<SampleType>::runNextJob(bool onAudioThread)
+{
+    if (busy.exchange(true, std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    bool ran = false;
+    if (nextToRun < submitted.load(std::memory_order_acquire))
+    {
+        Job& job = jobs[size_t(nextToRun % numJobs)];
+        job.state.store(JobState::running, std::memory_order_relaxed);
+
+        juce::AudioBuffer<SampleType> block(job.block.getArrayOfWritePointers(), job.block.getNumChannels(), job.numSamples);
+        block.clear();
+        render(block, job.midi, job.parametersChanged);
+
+        job.state.store(JobState::done, std::memory_order_release);
+        ++nextToRun;
+        ran = true;
+
+        if (onAudioThread)
+        {
+            ++inlineRenders;
+        }
+    }
+
+    busy.store(false, std::memory_order_release);
+    return ran;
+}
+
+template <typename SampleType>
+void RenderAhead<SampleType>::run()
+{
+    while (!threadShouldExit())
+    {
+        {
+            SUBSYNTH_REALTIME_SCOPE;
+            while (runNextJob(false))
+            {
+            }
+        }
+        wakeUp.wait(100);
+    }
+}
+
+template class RenderAhead<float>;
+template class RenderAhead<double>;
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    RenderAhead.h
+    Created: 18 Oct 2026 7:02:35pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeAudit.h"
+
+// Renders the synth one block ahead on a real-time worker thread, so a heavy
+// patch can use a core other than the host's audio thread. Host blocks are
+// gathered into jobs (their MIDI, their length and whether parameters
+// changed) of at least a quarter of the maximum block; the audio thread
+// queues each job once it is that long, wakes the worker and plays out
+// audio from jobs queued earlier, delayed by one maximum block. Gathering
+// keeps a host that announces 1024 samples and delivers 64 from filling
+// the job ring with tiny jobs, and leaves the worker three quarters of a
+// maximum block to finish each one.
+//
+// Jobs run strictly in order on whichever thread gets to them first. When
+// the audio thread needs a job the worker has not started, it claims and
+// renders it inline, so the output is the same sample for sample whether
+// or not the worker keeps up. A job the worker has already started is
+// waited for, yielding, and that wait is not bounded by this class: it
+// lasts for the rest of one job's render on the worker. The worker is a
+// real-time thread, so in practice only another real-time thread taking
+// its core can stretch the wait; the stress harness's worst case is the
+// place to see it.
+template <typename SampleType>
+class RenderAhead : private juce::Thread
+{
+public:
+    // Renders one job into block (already sized and cleared). Called on
+    // the worker or, as the fallback, on the audio thread, never both at
+    // once.
+    using RenderFunction = std::function<void(juce::AudioBuffer<SampleType>& block, juce::MidiBuffer& midi, bool parametersChanged)>;
+
+    RenderAhead();
+    ~RenderAhead() override;
+
+    // Message thread, with processing stopped.
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, RenderFunction renderFunction);
+    void release();
+    bool isPrepared() const { return latency > 0; }
+
+    // The delay this adds, in samples: one maximum block.
+    int getLatencySamples() const { return latency; }
+
+    // Audio thread. Replaces buffer with the audio of earlier blocks.
+    void process(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midi, bool parametersChanged);
+
+    // Jobs the audio thread had to render itself since prepare().
+    int getInlineRenderCount() const { return inlineRenders; }
+
+    // MIDI events left out of a job since prepare() because its buffer was
+    // full.
+    int getDroppedEventCount() const { return droppedEvents; }
+
+    // Each job's MIDI buffer has room for this many three-byte messages per
+    // sample of a maximum block, reserved by prepare(). The audio thread
+    // never grows it: events past that are dropped and counted instead.
+    static constexpr int maxEventsPerSample = 8;
+
+private:
+    // Queued jobs hold at most two maximum blocks and all but the open
+    // one hold at least a quarter of one, so nine are ever in use.
+    static constexpr int numJobs = 10;
+
+    // What one event takes in a MidiBuffer: its sample position and size,
+    // then its bytes.
+    static constexpr int getEventBytes(int numBytes) { return int(sizeof(int32_t) + sizeof(uint16_t)) + numBytes; }
+
+    enum class JobState
+    {
+        free,
+        pending,
+        running,
+        done
+    };
+
+    struct Job
+    {
+        juce::AudioBuffer<SampleType> block;
+        juce::MidiBuffer midi;
+        int midiBytes = 0;
+        int numSamples = 0;
+        bool parametersChanged = false;
+        std::atomic<JobState> state { JobState::free };
+    };
+
+    void run() override;
+
+    // Runs the oldest pending job if no other thread is rendering. Returns
+    // false if there was nothing it could do.
+    bool runNextJob(bool onAudioThread);
+
+    // Adds a host block to the open job, queueing it and opening the next
+    // one whenever it reaches jobSize.
+    void append(const juce::MidiBuffer& midi, int startSample, int numSamples, bool parametersChanged);
+    void submit();
+    void collect(uint64_t jobIndex);
+
+    RenderFunction render;
+    std::array<Job, numJobs> jobs;
+
+    std::atomic<uint64_t> submitted { 0 };
+    std::atomic<bool> busy { false };
+    uint64_t nextToRun = 0;     // only touched while holding busy
+    uint64_t nextToCollect = 0; // audio thread only
+
+    // Rendered audio waiting to be played, as a ring.
+    juce::AudioBuffer<SampleType> fifo;
+    int fifoRead = 0;
+    int fifoCount = 0;
+
+    int latency = 0;
+    int jobSize = 0;
+    int midiCapacity = 0;
+    int inlineRenders = 0;
+    int droppedEvents = 0;
+    juce::WaitableEvent wakeUp;
+
+    JUCE_DECLARE_NON_COPYABLE(RenderAhead)
+};
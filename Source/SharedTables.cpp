@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    SharedTables.cpp
+    Created: 18 Oct 2026 8:14:52pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "SharedTables.h"
+
+juce::CriticalSection& SharedTables::getLock()
+{
+    static juce::CriticalSection lock;
+    return lock;
+}
+
+std::map<SharedTables::Key, SharedTables::Entry>& SharedTables::getRegistry()
+{
+    static std::map<Key, Entry> registry;
+    return registry;
+}
+
+std::shared_ptr<const void> SharedTables::getOrBuild(const Key& key, const Build& build)
+{
+    std::promise<std::shared_ptr<const void>> promise;
+    std::shared_future<std::shared_ptr<const void>> building;
+    {
+        const juce::ScopedLock lock(getLock());
+        auto& registry = getRegistry();
+
+        // Entries whose last user has gone are dropped here rather than by
+        // the tables themselves, which keeps them plain immutable objects.
+        for (auto entry = registry.begin(); entry != registry.end();)
+        {
+            const bool unused = entry->second.table.expired() && !entry->second.building.valid();
+            entry = unused ? registry.erase(entry) : std::next(entry);
+        }
+
+        Entry& entry = registry[key];
+        if (auto table = entry.table.lock())
+        {
+            return table;
+        }
+        if (entry.building.valid())
+        {
+            building = entry.building;
+        }
+        else
+        {
+            entry.building = promise.get_future().share();
+        }
+    }
+
+    // Another caller is building this table already.
+    if (building.valid())
+    {
+        return building.get();
+    }
+
+    auto table = build();
+    {
+        const juce::ScopedLock lock(getLock());
+        Entry& entry = getRegistry()[key];
+        entry.table = table;
+        entry.building = {};
+    }
+    promise.set_value(table);
+    return table;
+}
+
+juce::String SharedTables::getFileKey(const juce::File& file)
+{
+    return file.getFullPathName() + ":" + juce::String(file.getSize())
+         + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+int SharedTables::getNumTables()
+{
+    const juce::ScopedLock lock(getLock());
+    auto& registry = getRegistry();
+    return int(std::count_if(registry.begin(), registry.end(),
+                             [](const auto& entry) { return !entry.second.table.expired(); }));
+}
+
+juce::ThreadPool& SharedTables::getLoaderPool()
+{
+    static juce::ThreadPool pool(1);
+    return pool;
+}
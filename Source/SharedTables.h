@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    SharedTables.h
+    Created: 18 Oct 2026 8:14:52pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <future>
+#include <typeindex>
+
+// Process-wide cache of immutable tables that depend on the sample rate, a
+// quality setting or a file. The first engine to ask for a table builds it;
+// every other instance in the process shares that copy, and the table is
+// freed when the last one lets go of it. Like Wavetable::load(), this is
+// for prepare time and the loader thread, never the audio thread.
+//
+// Tables are built outside the registry's lock, so a slow build only holds
+// up callers asking for that same table, who wait for it rather than build
+// it again.
+class SharedTables
+{
+public:
+    // For a table type with a constructor taking (double rate, int
+    // quality). The rate is whatever identifies the table, usually the
+    // sample rate.
+    template <typename Table>
+    static std::shared_ptr<const Table> get(double rate, int quality = 0)
+    {
+        return get<Table>({}, rate, quality, [rate, quality]
+        {
+            return std::make_shared<const Table>(rate, quality);
+        });
+    }
+
+    // For tables built some other way, such as from a file named by name
+    // (see getFileKey()). create() returns the table, or nullptr if it
+    // cannot be built, which is passed on and not kept.
+    template <typename Table, typename Create>
+    static std::shared_ptr<const Table> get(const juce::String& name, double rate, int quality, Create&& create)
+    {
+        const Key key { std::type_index(typeid(Table)), rate, quality, name };
+        return std::static_pointer_cast<const Table>(getOrBuild(key, [&create]() -> std::shared_ptr<const void>
+        {
+            return std::shared_ptr<const Table>(create());
+        }));
+    }
+
+    // Names a file by its path, size and modification time, so a file that
+    // changes on disk is built again.
+    static juce::String getFileKey(const juce::File& file);
+
+    // Tables currently held by at least one instance.
+    static int getNumTables();
+
+    // One background thread for the whole process, for loads and builds
+    // that take too long for the message thread.
+    static juce::ThreadPool& getLoaderPool();
+
+private:
+    using Build = std::function<std::shared_ptr<const void>()>;
+
+    struct Key
+    {
+        std::type_index type;
+        double rate;
+        int quality;
+        juce::String name;
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(type, rate, quality, name) < std::tie(other.type, other.rate, other.quality, other.name);
+        }
+    };
+
+    // A table in use, or one being built; never both.
+    struct Entry
+    {
+        std::weak_ptr<const void> table;
+        std::shared_future<std::shared_ptr<const void>> building;
+    };
+
+    static juce::CriticalSection& getLock();
+    static std::map<Key, Entry>& getRegistry();
+    static std::shared_ptr<const void> getOrBuild(const Key& key, const Build& build);
+};
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    StressHarness.cpp
+    Created: 18 Oct 2026 6:20:52pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "StressHarness.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    using StressHarness::Pattern;
+
+    void addChord(juce::MidiBuffer& midi, int position, juce::Random& random)
+    {
+        for (int i = 0; i < Synth<float>::numVoices; ++i)
+        {
+            midi.addEvent(juce::MidiMessage::noteOn(1, 24 + random.nextInt(96), juce::uint8(1 + random.nextInt(127))), position);
+        }
+    }
+
+    void fillPattern(Pattern pattern, juce::MidiBuffer& midi, int blockSize, int blockIndex, juce::Random& random)
+    {
+        switch (pattern)
+        {
+            case Pattern::steadyChord:
+                if (blockIndex == 0)
+                {
+                    addChord(midi, 0, random);
+                }
+                break;
+
+            case Pattern::chordRetrigger:
+                for (int position = 0; position < blockSize; position += 2 + random.nextInt(6))
+                {
+                    addChord(midi, position, random);
+                }
+                break;
+
+            case Pattern::pitchBendFlood:
+                if (blockIndex % 64 == 0)
+                {
+                    addChord(midi, 0, random);
+                }
+                for (int position = 0; position < blockSize; ++position)
+                {
+                    midi.addEvent(juce::MidiMessage::pitchWheel(1, random.nextInt(16384)), position);
+                }
+                break;
+
+            case Pattern::controllerFlood:
+                if (blockIndex % 64 == 0)
+                {
+                    addChord(midi, 0, random);
+                }
+                for (int position = 0; position < blockSize; ++position)
+                {
+                    static constexpr int controllers[] = { 0x01, 0x02, 0x0B, 0x47, 0x4A, 0x4B };
+                    const int controller = controllers[random.nextInt(int(std::size(controllers)))];
+                    midi.addEvent(juce::MidiMessage::controllerEvent(1, controller, random.nextInt(128)), position);
+                    midi.addEvent(juce::MidiMessage::channelPressureChange(1, random.nextInt(128)), position);
+                }
+                break;
+
+            case Pattern::sustainStorm:
+                for (int position = 0; position < blockSize; position += 1 + random.nextInt(4))
+                {
+                    const int note = 24 + random.nextInt(96);
+                    midi.addEvent(juce::MidiMessage::controllerEvent(1, 0x40, 127), position);
+                    midi.addEvent(juce::MidiMessage::noteOn(1, note, juce::uint8(100)), position);
+                    midi.addEvent(juce::MidiMessage::noteOff(1, note), position);
+                    midi.addEvent(juce::MidiMessage::controllerEvent(1, 0x40, 0), position);
+                }
+                break;
+
+            case Pattern::allNotesOff:
+                addChord(midi, 0, random);
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 0x78 + random.nextInt(4), 0), blockSize / 2);
+                addChord(midi, blockSize / 2, random);
+                break;
+
+            case Pattern::multiChannel:
+                if (blockIndex % 64 == 0)
+                {
+                    for (int channel = 1; channel <= 16; ++channel)
+                    {
+                        midi.addEvent(juce::MidiMessage::noteOn(channel, 24 + random.nextInt(96), juce::uint8(1 + random.nextInt(127))), 0);
+                    }
+                }
+                for (int position = 0; position < blockSize; position += 1 + random.nextInt(4))
+                {
+                    const int channel = 1 + random.nextInt(16);
+                    const int note = 24 + random.nextInt(96);
+                    switch (random.nextInt(4))
+                    {
+                        case 0:
+                            midi.addEvent(juce::MidiMessage::noteOn(channel, note, juce::uint8(1 + random.nextInt(127))), position);
+                            break;
+                        case 1:
+                            midi.addEvent(juce::MidiMessage::noteOff(channel, note), position);
+                            break;
+                        case 2:
+                            midi.addEvent(juce::MidiMessage::pitchWheel(channel, random.nextInt(16384)), position);
+                            break;
+                        default:
+                            midi.addEvent(juce::MidiMessage::controllerEvent(channel, 0x01, random.nextInt(128)), position);
+                            break;
+                    }
+                }
+                break;
+
+            case Pattern::everything:
+            case Pattern::count:
+                break;
+        }
+    }
+}
+
+juce::String StressHarness::getPatternName(Pattern pattern)
+{
+    switch (pattern)
+    {
+        case Pattern::steadyChord:     return "steady-chord";
+        case Pattern::chordRetrigger:  return "chord-retrigger";
+        case Pattern::pitchBendFlood:  return "pitch-bend-flood";
+        case Pattern::controllerFlood: return "controller-flood";
+        case Pattern::sustainStorm:    return "sustain-storm";
+        case Pattern::allNotesOff:     return "all-notes-off";
+        case Pattern::multiChannel:    return "multi-channel";
+        case Pattern::everything:      return "everything";
+        case Pattern::count:           break;
+    }
+    return {};
+}
+
+void StressHarness::fillBlock(Pattern pattern, juce::MidiBuffer& midi, int blockSize, int blockIndex, juce::Random& random)
+{
+    if (pattern == Pattern::everything)
+    {
+        for (int p = 0; p < int(Pattern::everything); ++p)
+        {
+            fillPattern(Pattern(p), midi, blockSize, blockIndex, random);
+        }
+        return;
+    }
+    fillPattern(pattern, midi, blockSize, blockIndex, random);
+}
+
+template <typename SampleType>
+StressHarness::Result StressHarness::run(Pattern pattern, double sampleRate, int blockSize, double seconds)
+{
+    constexpr bool doublePrecision = std::is_same_v<SampleType, double>;
+    SubSynthAudioProcessor processor;
+    processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                     : juce::AudioProcessor::singlePrecision);
+
+    // Only a multitimbral patch gives each channel a part of its own. Set
+    // before prepareToPlay(), which makes the first block read it.
+    if (pattern == Pattern::multiChannel || pattern == Pattern::everything)
+    {
+        if (auto* parameter = processor.apvts.getParameter(ParameterID::multitimbral.getParamID()))
+        {
+            parameter->setValueNotifyingHost(1.0f);
+        }
+    }
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    Result result;
+    result.pattern = pattern;
+    result.doublePrecision = doublePrecision;
+    result.sampleRate = sampleRate;
+    result.blockSize = blockSize;
+    result.numBlocks = std::max(1, int(seconds * sampleRate / blockSize));
+    result.deadlineMicroseconds = 1.0e6 * blockSize / sampleRate;
+
+    juce::AudioBuffer<SampleType> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    midi.ensureSize(4096);
+    juce::Random random(0x5eed);
+
+    std::vector<double> times;
+    times.reserve(size_t(result.numBlocks));
+    const int stealsBefore = processor.getVoiceStealCount();
+    const int violationsBefore = RealtimeAudit::getViolationCount();
+
+    for (int block = 0; block < result.numBlocks; ++block)
+    {
+        midi.clear();
+        fillBlock(pattern, midi, blockSize, block, random);
+
+        const auto start = std::chrono::steady_clock::now();
+        processor.processBlock(buffer, midi);
+        const auto end = std::chrono::steady_clock::now();
+
+        const double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+        times.push_back(microseconds);
+        if (microseconds > result.deadlineMicroseconds)
+        {
+            ++result.blocksOverDeadline;
+        }
+    }
+
+    result.voiceSteals = processor.getVoiceStealCount() - stealsBefore;
+    result.realtimeViolations = RealtimeAudit::getViolationCount() - violationsBefore;
+    processor.releaseResources();
+
+    result.meanMicroseconds = std::accumulate(times.begin(), times.end(), 0.0) / double(times.size());
+    std::sort(times.begin(), times.end());
+    result.worstMicroseconds = times.back();
+    const size_t p999 = std::min(times.size() - 1, size_t(std::ceil(double(times.size()) * 0.999)) - 1);
+    result.p999Microseconds = times[p999];
+    return result;
+}
+
+template <typename SampleType>
+std::vector<StressHarness::Result> StressHarness::runAll(double sampleRate, const std::vector<int>& blockSizes, double seconds)
+{
+    std::vector<Result> results;
+    for (int p = 0; p < int(Pattern::count); ++p)
+    {
+        for (int blockSize : blockSizes)
+        {
+            results.push_back(run<SampleType>(Pattern(p), sampleRate, blockSize, seconds));
+        }
+    }
+
+    // The steady chord comes first, one result per block size.
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& steady = results[i % blockSizes.size()];
+        results[i].relativeCost = results[i].p999Microseconds / std::max(steady.p999Microseconds, 0.001);
+    }
+    return results;
+}
+
+juce::String StressHarness::formatReport(const std::vector<Result>& results)
+{
+    juce::String report;
+    report << "pattern              precision  block  deadline us    mean us    p99.9 us    worst us  x steady  overruns  steals  blocking\n";
+    for (const auto& result : results)
+    {
+        report << getPatternName(result.pattern).paddedRight(' ', 20)
+               << juce::String(result.doublePrecision ? "double" : "float").paddedLeft(' ', 11)
+               << juce::String(result.blockSize).paddedLeft(' ', 6)
+               << juce::String(result.deadlineMicroseconds, 1).paddedLeft(' ', 13)
+               << juce::String(result.meanMicroseconds, 1).paddedLeft(' ', 11)
+               << juce::String(result.p999Microseconds, 1).paddedLeft(' ', 12)
+               << juce::String(result.worstMicroseconds, 1).paddedLeft(' ', 12)
+               << juce::String(result.relativeCost, 2).paddedLeft(' ', 10)
+               << juce::String(result.blocksOverDeadline).paddedLeft(' ', 10)
+               << juce::String(result.voiceSteals).paddedLeft(' ', 8)
+               << juce::String(result.realtimeViolations).paddedLeft(' ', 10) << "\n";
+    }
+    return report;
+}
+
+juce::String StressHarness::formatComparison(const std::vector<Result>& floatResults, const std::vector<Result>& doubleResults)
+{
+    juce::String report;
+    report << "pattern              block  float mean us  float p99.9 us  double mean us  double p99.9 us  double/float p99.9\n";
+    for (const auto& single : floatResults)
+    {
+        const auto match = std::find_if(doubleResults.begin(), doubleResults.end(),
+                                        [&](const Result& result)
+                                        {
+                                            return result.pattern == single.pattern && result.blockSize == single.blockSize
+                                                && result.sampleRate == single.sampleRate;
+                                        });
+        if (match == doubleResults.end())
+        {
+            continue;
+        }
+        report << getPatternName(single.pattern).paddedRight(' ', 20)
+               << juce::String(single.blockSize).paddedLeft(' ', 6)
+               << juce::String(single.meanMicroseconds, 1).paddedLeft(' ', 15)
+               << juce::String(single.p999Microseconds, 1).paddedLeft(' ', 16)
+               << juce::String(match->meanMicroseconds, 1).paddedLeft(' ', 16)
+               << juce::String(match->p999Microseconds, 1).paddedLeft(' ', 17)
+               << juce::String(match->p999Microseconds / std::max(single.p999Microseconds, 0.001), 2).paddedLeft(' ', 20)
+               << "\n";
+    }
+    return report;
+}
+
+juce::String StressHarness::formatBaseline(const std::vector<Result>& results)
+{
+    juce::String baseline;
+    for (const auto& result : results)
+    {
+        baseline << getPatternName(result.pattern) << " " << juce::String(result.sampleRate, 0) << " "
+                 << juce::String(result.blockSize) << " " << juce::String(result.relativeCost, 3)
+                 << (result.doublePrecision ? " double" : "") << "\n";
+    }
+    return baseline;
+}
+
+bool StressHarness::meetsBaseline(const std::vector<Result>& results, const juce::String& baseline,
+                                  double tolerance, juce::StringArray& failures)
+{
+    const auto lines = juce::StringArray::fromLines(baseline);
+    for (const auto& result : results)
+    {
+        const juce::String name = getPatternName(result.pattern) + " at " + juce::String(result.blockSize)
+                                  + (result.doublePrecision ? " (double)" : "");
+        if (result.realtimeViolations > 0)
+        {
+            failures.add(name + ": " + juce::String(result.realtimeViolations) + " blocking calls");
+        }
+
+        for (const auto& line : lines)
+        {
+            // Baselines written before the double runs have no precision
+            // token; their lines are the float results.
+            const auto tokens = juce::StringArray::fromTokens(line, " ", "");
+            const bool doubleLine = tokens.size() == 5 && tokens[4] == "double";
+            if ((tokens.size() == 4 || doubleLine) && doubleLine == result.doublePrecision
+                && tokens[0] == getPatternName(result.pattern)
+                && tokens[1].getDoubleValue() == std::round(result.sampleRate) && tokens[2].getIntValue() == result.blockSize)
+            {
+                const double limit = tokens[3].getDoubleValue() * tolerance;
+                if (result.relativeCost > limit)
+                {
+                    failures.add(name + ": " + juce::String(result.relativeCost, 2) + "x the steady chord, "
+                                 + juce::String(limit, 2) + "x allowed");
+                }
+            }
+        }
+    }
+    return failures.isEmpty();
+}
+
+template StressHarness::Result StressHarness::run<float>(Pattern, double, int, double);
+template StressHarness::Result StressHarness::run<double>(Pattern, double, int, double);
+template std::vector<StressHarness::Result> StressHarness::runAll<float>(double, const std::vector<int>&, double);
+template std::vector<StressHarness::Result> StressHarness::runAll<double>(double, const std::vector<int>&, double);
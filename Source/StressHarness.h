@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    StressHarness.h
+    Created: 18 Oct 2026 6:20:52pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Drives SubSynthAudioProcessor headlessly with adversarial MIDI and
+// measures how long each processBlock() call takes against the real-time
+// deadline of its block size. The worst case and the 99.9th percentile are
+// what decide dropouts, so those are reported rather than averages. The
+// processor owns a Timer, so the caller needs a running JUCE message
+// manager (a ScopedJuceInitialiser_GUI in a console app is enough).
+//
+// Microseconds depend on the machine and on whatever else it is doing, so
+// the gate does not use them: each pattern is measured against a held
+// chord rendered in the same run, and that ratio is compared with the
+// ratio an earlier build reached. SubSynthStress is the runner.
+//
+// The sample type picks the processor's processing precision, so the same
+// patterns can be timed through the float and the double engine.
+namespace StressHarness
+{
+    enum class Pattern
+    {
+        steadyChord,      // one held 16-note chord and no other events; the baseline
+        chordRetrigger,   // 16-note chords restarted every few samples
+        pitchBendFlood,   // a held chord under a pitch bend on every sample
+        controllerFlood,  // mod wheel, breath, expression, filter and aftertouch on every sample
+        sustainStorm,     // sustain toggling between notes, releasing with noteOff(-1)
+        allNotesOff,      // chords cut by CC 0x78-0x7B in the middle of the block
+        multiChannel,     // notes, bends and controllers on all 16 channels of a multitimbral patch
+        everything,       // all of the above interleaved, multitimbral
+        count
+    };
+
+    juce::String getPatternName(Pattern pattern);
+
+    struct Result
+    {
+        Pattern pattern;
+        bool doublePrecision = false;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        int numBlocks = 0;
+
+        double deadlineMicroseconds = 0.0;
+        double meanMicroseconds = 0.0;
+        double p999Microseconds = 0.0;
+        double worstMicroseconds = 0.0;
+        int blocksOverDeadline = 0;
+        int voiceSteals = 0;
+
+        // p99.9 over the steady chord's p99.9 at the same rate, block size
+        // and precision, from the same runAll(). This is what the gate
+        // compares.
+        double relativeCost = 0.0;
+
+        // Blocking calls made inside processBlock(); always 0 unless the
+        // runner is built with SUBSYNTH_REALTIME_AUDIT.
+        int realtimeViolations = 0;
+    };
+
+    // Appends the events of one block to midi, at sample positions inside
+    // the block. Deterministic for a given Random seed.
+    void fillBlock(Pattern pattern, juce::MidiBuffer& midi, int blockSize, int blockIndex, juce::Random& random);
+
+    // Instantiated for float and double.
+    template <typename SampleType = float>
+    Result run(Pattern pattern, double sampleRate, int blockSize, double seconds = 10.0);
+
+    // Every pattern at every block size, with relativeCost filled in.
+    template <typename SampleType = float>
+    std::vector<Result> runAll(double sampleRate = 48000.0,
+                               const std::vector<int>& blockSizes = { 16, 32, 64, 128, 256, 512, 1024, 2048 },
+                               double seconds = 10.0);
+
+    juce::String formatReport(const std::vector<Result>& results);
+
+    // The float and double runAll() of the same patterns, one line per
+    // pattern and block size with both timings and their ratio.
+    juce::String formatComparison(const std::vector<Result>& floatResults, const std::vector<Result>& doubleResults);
+
+    // One "pattern sampleRate blockSize relativeCost" line per result, for
+    // a later run to be gated against. Double results end in "double".
+    juce::String formatBaseline(const std::vector<Result>& results);
+
+    // The upgrade gate. No block may make a blocking call, and no pattern's
+    // relativeCost may exceed tolerance times the one in baseline (the
+    // formatBaseline() of an earlier build) for the same block size and
+    // precision.
+    // Results the baseline has no line for are only checked for blocking
+    // calls. Describes each failure in failures.
+    bool meetsBaseline(const std::vector<Result>& results, const juce::String& baseline,
+                       double tolerance, juce::StringArray& failures);
+}
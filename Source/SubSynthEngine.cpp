@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    SubSynthEngine.cpp
+    Created: 19 Oct 2026 1:14:52am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "SubSynthEngine.h"
+#include "SynthParameters.h"
+#include "RealtimeAudit.h"
+
+static_assert(SUBSYNTH_NUM_PARTS == Synth<float>::numParts);
+
+namespace
+{
+    struct ParameterInfo
+    {
+        float SynthParameters::* field;
+        juce::NormalisableRange<float> range;
+    };
+
+    // In SubSynthParameter order, with the ranges and steps of
+    // SubSynthAudioProcessor::createParameterLayout().
+    const ParameterInfo parameterInfos[] = {
+        { &SynthParameters::oscMix, { 0.0f, 100.0f } },
+        { &SynthParameters::oscTune, { -24.0f, 24.0f, 1.0f } },
+        { &SynthParameters::oscFine, { -50.0f, 50.0f, 0.1f } },
+        { &SynthParameters::filterFreq, { 0.0f, 100.0f, 0.1f } },
+        { &SynthParameters::filterReso, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterEnv, { -100.0f, 100.0f, 0.1f } },
+        { &SynthParameters::filterLFO, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterVelocity, { -100.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterAttack, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterDecay, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterSustain, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::filterRelease, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::envAttack, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::envDecay, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::envSustain, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::envRelease, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::lfoRate, { 0.0f, 1.0f } },
+        { &SynthParameters::vibrato, { -100.0f, 100.0f, 0.1f } },
+        { &SynthParameters::noise, { 0.0f, 100.0f, 1.0f } },
+        { &SynthParameters::octave, { -2.0f, 2.0f, 1.0f } },
+        { &SynthParameters::tuning, { -100.0f, 100.0f, 0.1f } },
+        { &SynthParameters::outputLevel, { -24.0f, 6.0f, 0.1f } },
+        { &SynthParameters::polyphony, { 1.0f, float(Synth<float>::numVoices), 1.0f } },
+        { &SynthParameters::wavetablePosition, { 0.0f, 100.0f, 0.1f } },
+        { &SynthParameters::partials, { 0.0f, float(PartialBank<float>::maxPartials), 1.0f } },
+        { &SynthParameters::partialTilt, { -12.0f, 6.0f, 0.1f } },
+        { &SynthParameters::partialBalance, { -100.0f, 100.0f, 1.0f } },
+        { &SynthParameters::partialDecay, { 0.0f, 100.0f, 1.0f } },
+    };
+    static_assert(std::size(parameterInfos) == SUBSYNTH_PARAMETER_COUNT);
+
+    bool isValid(int part, SubSynthParameter parameter)
+    {
+        return part >= 0 && part < SUBSYNTH_NUM_PARTS
+            && parameter >= 0 && parameter < SUBSYNTH_PARAMETER_COUNT;
+    }
+}
+
+// The engine as SubSynthAudioProcessor drives it, minus the wrapper: the
+// parameters are plain SynthParameters, applied at the start of a render
+// that follows a change, and the MIDI waits in a fixed queue sorted by
+// sample.
+struct SubSynthEngine
+{
+    struct MidiEvent
+    {
+        int samplePosition;
+        uint8_t data[3];
+    };
+
+    Synth<float> synth;
+    double sampleRate = 0.0;
+    std::array<SynthParameters, SUBSYNTH_NUM_PARTS> parameters;
+    bool parametersChanged = true;
+
+    std::array<MidiEvent, SUBSYNTH_MAX_MIDI_EVENTS> midi;
+    int numMidiEvents = 0;
+
+    void update()
+    {
+        const int numParts = synth.multitimbral ? SUBSYNTH_NUM_PARTS : 1;
+        for (int i = 0; i < numParts; ++i)
+        {
+            parameters[size_t(i)].applyTo(synth, sampleRate / synth.getRateDivisor(), i);
+        }
+        parametersChanged = false;
+    }
+
+    // Splits the block at the queued events, as splitBuffer() does.
+    void render(juce::AudioBuffer<float>& buffer, int numChannels)
+    {
+        const int numSamples = buffer.getNumSamples();
+        int offset = 0;
+        int event = 0;
+        for (; event < numMidiEvents && midi[size_t(event)].samplePosition < numSamples; ++event)
+        {
+            const MidiEvent& message = midi[size_t(event)];
+            if (message.samplePosition > offset)
+            {
+                synth.render(buffer, offset, message.samplePosition - offset, numChannels);
+                offset = message.samplePosition;
+            }
+            synth.midiMessage(message.data[0], message.data[1], message.data[2]);
+        }
+        if (offset < numSamples)
+        {
+            synth.render(buffer, offset, numSamples - offset, numChannels);
+        }
+
+        // Later events move up and become relative to the next block.
+        std::copy(midi.begin() + event, midi.begin() + numMidiEvents, midi.begin());
+        numMidiEvents -= event;
+        for (int i = 0; i < numMidiEvents; ++i)
+        {
+            midi[size_t(i)].samplePosition -= numSamples;
+        }
+    }
+};
+
+int subsynth_get_api_version(void)
+{
+    return SUBSYNTH_API_VERSION;
+}
+
+SubSynthEngine* subsynth_create(double sampleRate, int maxBlockSize)
+{
+    if (!(sampleRate > 0.0) || maxBlockSize <= 0)
+    {
+        return nullptr;
+    }
+
+    // Nothing may throw across the C boundary.
+    try
+    {
+        auto engine = std::make_unique<SubSynthEngine>();
+        engine->sampleRate = sampleRate;
+        engine->synth.subBlockSize = 64;
+        // Partials can be turned on with any later set_parameter, which
+        // must not allocate.
+        engine->synth.additive = true;
+        engine->synth.allocateResources(sampleRate, maxBlockSize);
+        engine->synth.reset();
+        return engine.release();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void subsynth_destroy(SubSynthEngine* engine)
+{
+    delete engine;
+}
+
+void subsynth_reset(SubSynthEngine* engine)
+{
+    if (engine != nullptr)
+    {
+        engine->synth.reset();
+        engine->numMidiEvents = 0;
+        engine->parametersChanged = true;
+    }
+}
+
+SubSynthResult subsynth_set_parameter(SubSynthEngine* engine, int part, SubSynthParameter parameter, float value)
+{
+    if (engine == nullptr || !isValid(part, parameter) || !std::isfinite(value))
+    {
+        return SUBSYNTH_INVALID_ARGUMENT;
+    }
+    // The engine only ever sees values the plugin's parameters could hold.
+    const ParameterInfo& info = parameterInfos[parameter];
+    engine->parameters[size_t(part)].*info.field = info.range.snapToLegalValue(value);
+    engine->parametersChanged = true;
+    return SUBSYNTH_OK;
+}
+
+float subsynth_get_parameter(const SubSynthEngine* engine, int part, SubSynthParameter parameter)
+{
+    if (engine == nullptr || !isValid(part, parameter))
+    {
+        return 0.0f;
+    }
+    return engine->parameters[size_t(part)].*parameterInfos[parameter].field;
+}
+
+void subsynth_set_multitimbral(SubSynthEngine* engine, int multitimbral)
+{
+    if (engine != nullptr)
+    {
+        engine->synth.multitimbral = multitimbral != 0;
+        engine->parametersChanged = true;
+    }
+}
+
+SubSynthResult subsynth_push_midi(SubSynthEngine* engine, int sampleOffset, const unsigned char* data, int size)
+{
+    if (engine == nullptr || data == nullptr || size < 1 || size > 3 || sampleOffset < 0)
+    {
+        return SUBSYNTH_INVALID_ARGUMENT;
+    }
+    if (engine->numMidiEvents == SUBSYNTH_MAX_MIDI_EVENTS)
+    {
+        return SUBSYNTH_MIDI_QUEUE_FULL;
+    }
+
+    // Events usually arrive in order, so this rarely moves any.
+    SubSynthEngine::MidiEvent message { sampleOffset, { data[0], size >= 2 ? data[1] : uint8_t(0), size == 3 ? data[2] : uint8_t(0) } };
+    int i = engine->numMidiEvents++;
+    for (; i > 0 && engine->midi[size_t(i - 1)].samplePosition > sampleOffset; --i)
+    {
+        engine->midi[size_t(i)] = engine->midi[size_t(i - 1)];
+    }
+    engine->midi[size_t(i)] = message;
+    return SUBSYNTH_OK;
+}
+
+SubSynthResult subsynth_render(SubSynthEngine* engine, float* const* outputs, int numChannels, int numSamples)
+{
+    if (engine == nullptr || outputs == nullptr || numChannels < 1 || numChannels > 2 || numSamples < 0
+        || outputs[0] == nullptr || (numChannels == 2 && outputs[1] == nullptr))
+    {
+        return SUBSYNTH_INVALID_ARGUMENT;
+    }
+
+    juce::ScopedNoDenormals noDenormals;
+    SUBSYNTH_REALTIME_SCOPE;
+
+    if (engine->parametersChanged)
+    {
+        engine->update();
+    }
+
+    // The engine always takes two channels and only writes the second in
+    // stereo. Referring to the caller's memory copies nothing, and the
+    // channel list fits in the buffer's own space, so nothing allocates.
+    float* channels[2] = { outputs[0], outputs[numChannels - 1] };
+    juce::AudioBuffer<float> buffer(channels, 2, numSamples);
+    engine->render(buffer, numChannels);
+    return SUBSYNTH_OK;
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    SubSynthEngine.h
+    Created: 19 Oct 2026 1:14:52am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+    A C interface to the SubSynth engine for hosts that are not plugins:
+    render servers, game-audio runtimes and anything else that can call C.
+    It is built into the SubSynthEngine static library together with the
+    engine itself, and needs nothing from the plugin wrapper.
+
+    The interface is stable: functions and parameter numbers are only ever
+    added, never changed or renumbered, and subsynth_get_api_version()
+    tells a caller which ones exist.
+
+    Only subsynth_create() allocates. Setting parameters, pushing MIDI and
+    rendering use memory the engine set aside when it was created, and
+    render straight into the caller's buffers. An engine is not
+    thread-safe: make all calls for one engine from one thread at a time,
+    typically the audio thread, between renders. Separate engines are
+    independent.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUBSYNTH_API_VERSION 1
+
+typedef struct SubSynthEngine SubSynthEngine;
+
+typedef enum SubSynthResult
+{
+    SUBSYNTH_OK = 0,
+    SUBSYNTH_INVALID_ARGUMENT = -1,
+    SUBSYNTH_MIDI_QUEUE_FULL = -2
+} SubSynthResult;
+
+/* Patch parameters, in the units the plugin shows: percent, semitones,
+   cents, decibels and so on, with the same ranges and defaults. */
+typedef enum SubSynthParameter
+{
+    SUBSYNTH_PARAMETER_OSC_MIX = 0,
+    SUBSYNTH_PARAMETER_OSC_TUNE = 1,
+    SUBSYNTH_PARAMETER_OSC_FINE = 2,
+    SUBSYNTH_PARAMETER_FILTER_FREQ = 3,
+    SUBSYNTH_PARAMETER_FILTER_RESO = 4,
+    SUBSYNTH_PARAMETER_FILTER_ENV = 5,
+    SUBSYNTH_PARAMETER_FILTER_LFO = 6,
+    SUBSYNTH_PARAMETER_FILTER_VELOCITY = 7,
+    SUBSYNTH_PARAMETER_FILTER_ATTACK = 8,
+    SUBSYNTH_PARAMETER_FILTER_DECAY = 9,
+    SUBSYNTH_PARAMETER_FILTER_SUSTAIN = 10,
+    SUBSYNTH_PARAMETER_FILTER_RELEASE = 11,
+    SUBSYNTH_PARAMETER_ENV_ATTACK = 12,
+    SUBSYNTH_PARAMETER_ENV_DECAY = 13,
+    SUBSYNTH_PARAMETER_ENV_SUSTAIN = 14,
+    SUBSYNTH_PARAMETER_ENV_RELEASE = 15,
+    SUBSYNTH_PARAMETER_LFO_RATE = 16,
+    SUBSYNTH_PARAMETER_VIBRATO = 17,
+    SUBSYNTH_PARAMETER_NOISE = 18,
+    SUBSYNTH_PARAMETER_OCTAVE = 19,
+    SUBSYNTH_PARAMETER_TUNING = 20,
+    SUBSYNTH_PARAMETER_OUTPUT_LEVEL = 21,
+    SUBSYNTH_PARAMETER_POLYPHONY = 22,
+    SUBSYNTH_PARAMETER_WAVETABLE_POSITION = 23,
+    SUBSYNTH_PARAMETER_PARTIALS = 24,
+    SUBSYNTH_PARAMETER_PARTIAL_TILT = 25,
+    SUBSYNTH_PARAMETER_PARTIAL_BALANCE = 26,
+    SUBSYNTH_PARAMETER_PARTIAL_DECAY = 27,
+    SUBSYNTH_PARAMETER_COUNT = 28
+} SubSynthParameter;
+
+#define SUBSYNTH_NUM_PARTS 16
+#define SUBSYNTH_MAX_MIDI_EVENTS 1024
+
+int subsynth_get_api_version(void);
+
+/* Returns NULL if the arguments are out of range or memory runs out.
+   Renders may be longer than maxBlockSize; that only sizes scratch. */
+SubSynthEngine* subsynth_create(double sampleRate, int maxBlockSize);
+void subsynth_destroy(SubSynthEngine* engine);
+
+/* Silences every voice and drops queued MIDI; the parameters stay. */
+void subsynth_reset(SubSynthEngine* engine);
+
+/* Sets a parameter of one part. Part 0 is the only one that plays unless
+   the engine is multitimbral. A value outside the parameter's range is
+   clamped to it and a stepped parameter (semitones, octave, polyphony...)
+   rounds to its nearest step, as in the plugin; subsynth_get_parameter()
+   returns what was kept. NaN and infinity are rejected. Takes effect at
+   the start of the next render. */
+SubSynthResult subsynth_set_parameter(SubSynthEngine* engine, int part, SubSynthParameter parameter, float value);
+float subsynth_get_parameter(const SubSynthEngine* engine, int part, SubSynthParameter parameter);
+
+/* When nonzero, MIDI channel n plays part n; otherwise every channel
+   plays part 0. Off by default. */
+void subsynth_set_multitimbral(SubSynthEngine* engine, int multitimbral);
+
+/* Queues a MIDI message of one to three bytes for the sample sampleOffset
+   from the start of the next render. Offsets beyond that render carry
+   over to the ones after it. Messages for the same sample keep their
+   order. */
+SubSynthResult subsynth_push_midi(SubSynthEngine* engine, int sampleOffset, const unsigned char* data, int size);
+
+/* Renders numSamples into one (mono) or two (left, right) non-interleaved
+   channels owned by the caller, overwriting what they held. */
+SubSynthResult subsynth_render(SubSynthEngine* engine, float* const* outputs, int numChannels, int numSamples);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,123 +10,1030 @@
 
 #include "Synth.h"
 
-Synth::Synth()
+// One kernel per oscillator algorithm and noise on/off, picked once per
+// voice and segment instead of branching on every sample.
+template <typename SampleType>
+using VoiceKernel = void (Voice<SampleType>::*)(SampleType*, const SampleType*, const SampleType*, int);
+
+template <typename SampleType>
+static constexpr VoiceKernel<SampleType> voiceKernels[5][2] =
+{
+    { &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::naive, false>,
+      &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::naive, true> },
+    { &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::polyBLEP, false>,
+      &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::polyBLEP, true> },
+    { &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::fourier, false>,
+      &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::fourier, true> },
+    { &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::wavetable, false>,
+      &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::wavetable, true> },
+    { &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::additive, false>,
+      &Voice<SampleType>::template renderBlock<OscillatorAlgorithm::additive, true> },
+};
+
+template <typename SampleType>
+Synth<SampleType>::Synth()
 {
     this->sampleRate = 44100.0f;
+    stemChannels.fill(-1);
+    voiceBatch.synth = this;
 }
 
-void Synth::allocateResources(double sampleRate, int samplesPerBlock)
+template <typename SampleType>
+void Synth<SampleType>::allocateResources(double sampleRate, int samplesPerBlock)
 {
-    this->sampleRate = static_cast<float>(sampleRate);
+    // From here on sampleRate is the internal rate.
+    rateDivisor = 1;
+    if (minInternalRate > 0.0)
+    {
+        while (rateDivisor < 4 && sampleRate / (2 * rateDivisor) >= minInternalRate)
+        {
+            rateDivisor *= 2;
+        }
+    }
+    sampleRate /= rateDivisor;
+    
+    this->sampleRate = static_cast<SampleType>(sampleRate);
     
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 1;
+    if (controlIntervalMs <= 0.0f)
+    {
+        controlInterval = legacyControlInterval;
+    }
+    else
+    {
+        int interval = juce::roundToInt(double(controlIntervalMs) * 0.001 * sampleRate);
+        controlInterval = std::clamp(interval, minControlInterval, maxControlInterval);
+    }
     
-    for (int i = 0; i < numVoices; ++i)
+    // The modulation smoother was tuned for one step per 32 samples; keep
+    // its time constant when the tick is shorter or longer.
+    filterSmootherCoefficient = SampleType(0.005);
+    if (controlInterval != legacyControlInterval)
     {
-        voices[i].filter.setMode(juce::dsp::LadderFilterMode::LPF12);
-        voices[i].filter.prepare(spec);
+        const SampleType ticks = SampleType(controlInterval) / SampleType(legacyControlInterval);
+        filterSmootherCoefficient = SampleType(1) - std::pow(SampleType(1) - SampleType(0.005), ticks);
     }
+    
+    const SampleType inverseSampleRate = SampleType(1) / SampleType(sampleRate);
+    envelopeCurve.prepare(inverseSampleRate);
+    filterEnvelopeCurve.prepare(inverseSampleRate * controlInterval);
+    
+    // The voices are most of the engine, so there are only as many as the
+    // polyphony.
+    voiceCount = std::clamp(maxPolyphony, 1, int(numVoices));
+    std::vector<Voice<SampleType>>(size_t(voiceCount)).swap(voices);
+    std::vector<VoiceControl<SampleType>>(size_t(voiceCount)).swap(controls);
+    std::vector<typename NoteCache<SampleType>::Cursor>(size_t(voiceCount)).swap(cacheCursors);
+    std::vector<PartialBank<SampleType>>(additive ? size_t(voiceCount) * 2 : 0).swap(partialBanks);
+    if (additive)
+    {
+        for (int i = 0; i < voiceCount; ++i)
+        {
+            voices[i].partialsA = &partialBanks[size_t(i) * 2];
+            voices[i].partialsB = &partialBanks[size_t(i) * 2 + 1];
+        }
+    }
+    
+    subBlockLength = 0;
+    if (subBlockSize > 0)
+    {
+        subBlockLength = std::max(1, juce::roundToInt(double(subBlockSize) / controlInterval)) * controlInterval;
+    }
+    subBlockRemaining = 0;
+    
+    oversamplingFactor = oversampling >= 4 ? 4 : (oversampling >= 2 ? 2 : 1);
+    
+    const size_t stride = size_t(controlInterval);
+    const size_t oversampledStride = stride * size_t(oversamplingFactor);
+    envelopeBuffer.assign(size_t(voiceCount) * stride, SampleType(0));
+    noiseBuffer.assign(size_t(voiceCount) * stride, SampleType(0));
+    voiceBuffer.assign(oversampledStride, SampleType(0));
+    mixBufferL.assign(numParts * oversampledStride, SampleType(0));
+    mixBufferR.assign(numParts * oversampledStride, SampleType(0));
+    
+    levelBuffer.assign(oversampledStride, SampleType(0));
+    partBufferL.assign(oversampledStride, SampleType(0));
+    partBufferR.assign(oversampledStride, SampleType(0));
+    foldBuffer.assign(oversampledStride, SampleType(0));
+    
+    // The stage next to the output rate needs the steep transition; the
+    // 4x to 2x stage only has to protect what that one passes.
+    numDecimatorStages = 0;
+    if (oversamplingFactor == 4)
+    {
+        for (auto& stages : decimators)
+        {
+            stages[size_t(numDecimatorStages)].prepare(0.2, -70);
+        }
+        ++numDecimatorStages;
+    }
+    if (oversamplingFactor >= 2)
+    {
+        for (auto& stages : decimators)
+        {
+            stages[size_t(numDecimatorStages)].prepare(0.1, -70);
+        }
+        ++numDecimatorStages;
+    }
+    const size_t oversampledLength = oversamplingFactor > 1 ? oversampledStride : 0;
+    oversampledEnvelope.assign(oversampledLength, SampleType(0));
+    oversampledNoise.assign(oversampledLength, SampleType(0));
+    busL.assign(oversampledLength, SampleType(0));
+    busR.assign(oversampledLength, SampleType(0));
+    
+    const size_t voiceLength = workerPool != nullptr ? size_t(voiceCount) * oversampledStride : 0;
+    voiceOutputs.assign(voiceLength, SampleType(0));
+    voiceEnvelopes.assign(oversamplingFactor > 1 ? voiceLength : 0, SampleType(0));
+    voiceNoise.assign(oversamplingFactor > 1 ? voiceLength : 0, SampleType(0));
+    
+    // The decimators' delay, in internal samples: each stage's output is
+    // twice the rate of the one after it.
+    double latency = 0.0;
+    for (int stage = 0; stage < numDecimatorStages; ++stage)
+    {
+        latency += decimators[0][size_t(stage)].getLatency() / double(1 << (numDecimatorStages - 1 - stage));
+    }
+    latency *= rateDivisor;
+    
+    // Enough whole internal samples for a host block, plus one for a block
+    // that starts partway through the last one handed out. The stage next
+    // to the internal rate needs the steep transition, as in decimation.
+    if (rateDivisor > 1)
+    {
+        const int reducedLength = std::max(samplesPerBlock, 1) / rateDivisor + 1;
+        reducedBuffer.setSize(2 + 2 * numParts, reducedLength);
+        upsampledBuffer.setSize(2 + 2 * numParts, reducedLength * rateDivisor);
+        interpolatedL.assign(rateDivisor == 4 ? size_t(reducedLength) * 2 : 0, SampleType(0));
+        interpolatedR.assign(rateDivisor == 4 ? size_t(reducedLength) * 2 : 0, SampleType(0));
+        
+        for (auto& stages : interpolators)
+        {
+            stages[0].prepare(0.1, -70);
+            if (rateDivisor == 4)
+            {
+                stages[1].prepare(0.2, -70);
+            }
+        }
+        latency += interpolators[0][0].getLatency() * rateDivisor / 2;
+        if (rateDivisor == 4)
+        {
+            latency += interpolators[0][1].getLatency();
+        }
+    }
+    else
+    {
+        reducedBuffer.setSize(0, 0);
+        upsampledBuffer.setSize(0, 0);
+        interpolatedL.clear();
+        interpolatedR.clear();
+    }
+    latencySamples = juce::roundToInt(latency);
+    
+    int filterRampLength = controlInterval;
+    if (filterSmoothingMs > 0.0f)
+    {
+        filterRampLength = int(std::floor(double(filterSmoothingMs) * 0.001 * sampleRate));
+    }
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        voices[i].filter.prepare(sampleRate * oversamplingFactor, filterRampLength * oversamplingFactor);
+    }
+    
+    // Recordings are only valid for the rate and tick they were made at.
+    noteCache.prepare(noteCacheBytes, controlInterval * oversamplingFactor,
+                      int(maxCachedSeconds * sampleRate) * oversamplingFactor);
 }
 
-void Synth::deallocateResources() { }
+template <typename SampleType>
+void Synth<SampleType>::deallocateResources() { }
+
+template <typename SampleType>
+size_t Synth<SampleType>::getMemoryFootprint() const
+{
+    return sizeof(*this)
+         + (envelopeBuffer.capacity() + noiseBuffer.capacity() + voiceBuffer.capacity()
+            + mixBufferL.capacity() + mixBufferR.capacity() + oversampledEnvelope.capacity()
+            + oversampledNoise.capacity() + busL.capacity() + busR.capacity() + levelBuffer.capacity()
+            + partBufferL.capacity() + partBufferR.capacity() + foldBuffer.capacity()
+            + voiceOutputs.capacity() + voiceEnvelopes.capacity() + voiceNoise.capacity()
+            + size_t(reducedBuffer.getNumChannels() * reducedBuffer.getNumSamples())
+            + size_t(upsampledBuffer.getNumChannels() * upsampledBuffer.getNumSamples())
+            + interpolatedL.capacity() + interpolatedR.capacity()) * sizeof(SampleType)
+         + voices.capacity() * sizeof(Voice<SampleType>)
+         + controls.capacity() * sizeof(VoiceControl<SampleType>)
+         + partialBanks.capacity() * sizeof(PartialBank<SampleType>)
+         + cacheCursors.capacity() * sizeof(typename NoteCache<SampleType>::Cursor)
+         + noteCache.getMemoryFootprint();
+}
 
-void Synth::reset()
+template <typename SampleType>
+void Synth<SampleType>::reset()
 {
-    for (int i = 0; i < this->numVoices; ++i)
+    for (int i = 0; i < voiceCount; ++i)
     {
+        if (cacheCursors[i].isActive())
+        {
+            noteCache.detach(cacheCursors[i]);
+        }
         voices[i].reset();
+        controls[i].reset();
     }
     
     noiseGenerator.reset();
-    pitchBend = 1.0f;
-    sustainPedalPressed = false;
-    
-    outputLevelSmoother.reset(sampleRate, 0.05f);
-    oscMixSmoother.reset(sampleRate, 0.0001f);
-    
-    lfo = 0.0f;
     lfoStep = 0;
+    subBlockRemaining = 0;
     
-    modWheel = 0.0f;
-    
-    resonanceCtl = 1.0f;
-    filterCtl = 0.0f;
+    for (auto& stages : decimators)
+    {
+        for (auto& decimator : stages)
+        {
+            decimator.reset();
+        }
+    }
     
-    aftertouch = 0.0f;
+    for (auto& stages : interpolators)
+    {
+        for (auto& interpolator : stages)
+        {
+            interpolator.reset();
+        }
+    }
+    upsampledPosition = 0;
+    upsampledLength = 0;
+    upsampledStems.fill(false);
     
-    filterSmoother = 0.0f;
+    for (Part& part : parts)
+    {
+        part.pitchBend = 1.0f;
+        part.sustainPedalPressed = false;
+        
+        part.outputLevelSmoother.reset(sampleRate, 0.05f);
+        part.oscMixSmoother.reset(sampleRate, 0.0001f);
+        
+        part.lfo = 0.0f;
+        
+        part.modWheel = 0.0f;
+        part.controllers.fill(SampleType(0));
+        
+        part.resonanceCtl = 1.0f;
+        part.filterCtl = 0.0f;
+        
+        part.aftertouch = 0.0f;
+        
+        part.filterSmoother = 0.0f;
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::resetToIdle()
+{
+    reset();
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        voices[i].filter.resetToIdle();
+    }
 }
 
-void Synth::render(juce::AudioBuffer<float>& buffer, int bufferOffset, int sampleCount, int numChannels)
+template <typename SampleType>
+void Synth<SampleType>::render(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels)
 {
-    float* leftOutputBuffer = buffer.getWritePointer(0) + bufferOffset;
-    float* rightOutputBuffer = buffer.getWritePointer(1) + bufferOffset;
+    if (rateDivisor > 1)
+    {
+        renderReducedRate(buffer, bufferOffset, sampleCount, numChannels);
+        return;
+    }
+    renderInternal(buffer, bufferOffset, sampleCount, numChannels, stemChannels);
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderReducedRate(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels)
+{
+    const int numMainChannels = numChannels > 1 ? 2 : 1;
     
+    std::array<int, numParts> stems;
+    stems.fill(-1);
+    for (int p = 0; p < getNumPartsInUse(); ++p)
+    {
+        const int channel = stemChannels[size_t(p)];
+        if (channel >= 0 && channel + 1 < buffer.getNumChannels())
+        {
+            stems[size_t(p)] = 2 + 2 * p;
+        }
+    }
     
-    for (int i = 0; i < this->numVoices; ++i) 
+    int offset = 0;
+    while (offset < sampleCount)
     {
-        Voice& voice = voices[i];
-        if (voice.envelope.isActive())
+        if (upsampledPosition == upsampledLength)
         {
-            voice.oscillatorA.setFrequency(voice.frequency * pitchBend);
-            voice.oscillatorB.setFrequency(voice.oscillatorA.freq * oscBTune);
+            const int wanted = (sampleCount - offset + rateDivisor - 1) / rateDivisor;
+            const int length = std::min(wanted, reducedBuffer.getNumSamples());
+            renderInternal(reducedBuffer, 0, length, numChannels, stems);
             
-            voice.oscillatorA.amplitude = ((0.004f * float((voice.velocity + 64) * (voice.velocity + 64)) - 8.0f) / 127.0f) * 0.5f;
-            voice.oscillatorB.amplitude = voice.oscillatorA.amplitude * oscMixSmoother.getNextValue();
-            voice.filterQ = filterQ + resonanceCtl;
-            voice.pitchBend = pitchBend;
-            voice.filterEnvDepth = filterEnvDepth;
+            if (numMainChannels > 1) {
+                interpolate<2>(interpolators[0], 0, length);
+            } else {
+                interpolate<1>(interpolators[0], 0, length);
+            }
+            for (int p = 0; p < numParts; ++p)
+            {
+                auto& stages = interpolators[size_t(p) + 1];
+                if (stems[size_t(p)] >= 0)
+                {
+                    interpolate<2>(stages, stems[size_t(p)], length);
+                }
+                else if (upsampledStems[size_t(p)])
+                {
+                    // A stem that comes back later starts from silence.
+                    stages[0].reset();
+                    stages[1].reset();
+                    upsampledBuffer.clear(2 + 2 * p, 0, upsampledBuffer.getNumSamples());
+                    upsampledBuffer.clear(3 + 2 * p, 0, upsampledBuffer.getNumSamples());
+                }
+                upsampledStems[size_t(p)] = stems[size_t(p)] >= 0;
+            }
+            upsampledPosition = 0;
+            upsampledLength = length * rateDivisor;
         }
+        
+        const int length = std::min(upsampledLength - upsampledPosition, sampleCount - offset);
+        for (int channel = 0; channel < numMainChannels; ++channel)
+        {
+            buffer.copyFrom(channel, bufferOffset + offset, upsampledBuffer, channel, upsampledPosition, length);
+        }
+        for (int p = 0; p < numParts; ++p)
+        {
+            if (stems[size_t(p)] >= 0)
+            {
+                const int channel = stemChannels[size_t(p)];
+                buffer.copyFrom(channel, bufferOffset + offset, upsampledBuffer, 2 + 2 * p, upsampledPosition, length);
+                buffer.copyFrom(channel + 1, bufferOffset + offset, upsampledBuffer, 3 + 2 * p, upsampledPosition, length);
+            }
+        }
+        upsampledPosition += length;
+        offset += length;
+    }
+}
+
+template <typename SampleType>
+template <int numChannels>
+void Synth<SampleType>::interpolate(std::array<HalfBandInterpolator<SampleType>, 2>& stages, int channel, int length)
+{
+    const SampleType* input[2] = { reducedBuffer.getReadPointer(channel),
+                                   reducedBuffer.getReadPointer(channel + numChannels - 1) };
+    SampleType* output[2] = { upsampledBuffer.getWritePointer(channel),
+                              upsampledBuffer.getWritePointer(channel + numChannels - 1) };
+    if (rateDivisor == 2)
+    {
+        stages[0].template process<numChannels>(input, output, length);
+        return;
     }
     
-    for (int sample = 0; sample < sampleCount; ++sample)
+    SampleType* middle[2] = { interpolatedL.data(), interpolatedR.data() };
+    stages[0].template process<numChannels>(input, middle, length);
+    stages[1].template process<numChannels>(middle, output, length * 2);
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderInternal(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels,
+                                       const std::array<int, numParts>& stems)
+{
+    SampleType* leftOutputBuffer = buffer.getWritePointer(0) + bufferOffset;
+    SampleType* rightOutputBuffer = buffer.getWritePointer(1) + bufferOffset;
+    
+    for (int p = 0; p < numParts; ++p)
     {
-        updateLFO();
-        float outputL = 0.0f;
-        float outputR = 0.0f;
-        
-        for (int i = 0; i < this->numVoices; ++i) 
+        const int channel = stems[size_t(p)];
+        if (channel >= 0 && channel + 1 < buffer.getNumChannels() && p < getNumPartsInUse())
+        {
+            stemOutputs[size_t(p)] = { buffer.getWritePointer(channel) + bufferOffset,
+                                       buffer.getWritePointer(channel + 1) + bufferOffset };
+        }
+        else
         {
-            Voice& voice = voices[i];
-            if (voice.envelope.isActive())
+            stemOutputs[size_t(p)] = { nullptr, nullptr };
+        }
+    }
+    
+    int offset = 0;
+    
+    // Without a sub-block size every call is a sub-block of its own.
+    if (subBlockLength == 0)
+    {
+        subBlockRemaining = 0;
+    }
+    
+    // Split the block at the sub-blocks and the control ticks so that every
+    // voice renders a whole segment through one specialised kernel.
+    while (offset < sampleCount)
+    {
+        if (subBlockRemaining == 0)
+        {
+            beginSubBlock();
+            ++subBlocks;
+            subBlockRemaining = sampleCount - offset;
+            if (subBlockLength > 0)
             {
-                float noise = noiseGenerator.nextValue() * noiseMix;
-                float output = voice.render(noise);
-                outputL += output * voice.panLeft;
-                outputR += output * voice.panRight;
+                // A sub-block started by a MIDI message runs to a tick and
+                // then whole intervals, so the ones after it start on ticks
+                // again and are not cut at every one.
+                const int toTick = std::max(lfoStep - 1, 0);
+                subBlockRemaining = toTick > 0 ? toTick + subBlockLength - controlInterval : subBlockLength;
             }
         }
         
-        float outputLevel = outputLevelSmoother.getNextValue();
-        outputL *= outputLevel;
-        outputR *= outputLevel;
+        tickedThisSegment = --lfoStep <= 0;
+        if (tickedThisSegment)
+        {
+            lfoStep = controlInterval;
+            updateLFO();
+        }
+        
+        int segmentLength = std::min({ lfoStep, sampleCount - offset, subBlockRemaining });
+        lfoStep -= segmentLength - 1;
+        subBlockRemaining -= segmentLength;
+        
+        renderVoices(segmentLength);
         
         if (numChannels > 1) {
-            leftOutputBuffer[sample] = outputL;
-            rightOutputBuffer[sample] = outputR;
+            writeOutput<true>(leftOutputBuffer + offset, rightOutputBuffer + offset, segmentLength);
         } else {
-            leftOutputBuffer[sample] = (outputL + outputR) * 0.5f;
+            writeOutput<false>(leftOutputBuffer + offset, nullptr, segmentLength);
+        }
+        for (auto& stem : stemOutputs)
+        {
+            if (stem[0] != nullptr)
+            {
+                stem[0] += segmentLength;
+                stem[1] += segmentLength;
+            }
         }
+        offset += segmentLength;
     }
-    for (int i = 0; i < this->numVoices; ++i)
+    
+    for (int i = 0; i < voiceCount; ++i)
     {
-        Voice& voice = voices[i];
+        Voice<SampleType>& voice = voices[i];
         if (!voice.envelope.isActive()) {
             voice.envelope.reset();
             voice.filter.reset();
+            
+            // A note that died out before its sustain was recorded whole.
+            if (cacheCursors[i].isActive())
+            {
+                noteCache.detach(cacheCursors[i], true);
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+bool Synth<SampleType>::retune(const uint8_t* data, int size)
+{
+    if (!Tuning::applySysEx(data, size, tuningFrequencies))
+    {
+        return false;
+    }
+    for (Part& part : parts)
+    {
+        part.setTuning(&tuningFrequencies);
+    }
+    return true;
+}
+
+template <typename SampleType>
+void Synth<SampleType>::beginSubBlock()
+{
+    modProgram = modMatrix.acquire();
+    
+    // A newly published tuning replaces whatever SysEx had retuned.
+    bool tuningChanged = false;
+    const Tuning* publishedTuning = tuning.acquire(tuningChanged);
+    if (tuningChanged)
+    {
+        tuningFrequencies = (publishedTuning != nullptr ? *publishedTuning : equalTemperament).getFrequencies();
+        for (Part& part : parts)
+        {
+            part.setTuning(publishedTuning != nullptr ? &tuningFrequencies : nullptr);
+        }
+    }
+    
+    bool wavetablesChanged = false;
+    for (int p = 0; p < numParts; ++p)
+    {
+        const Wavetable* table = wavetables[size_t(p)].acquire();
+        if (table != parts[size_t(p)].wavetable)
+        {
+            parts[size_t(p)].wavetable = table;
+            wavetablesChanged = true;
+        }
+    }
+    if (wavetablesChanged)
+    {
+        // The cache keys on which parts share a table, so every entry goes,
+        // and the voices carry on live with their part's new table.
+        for (int i = 0; i < voiceCount; ++i)
+        {
+            leaveNoteCache(i);
+        }
+        noteCache.clear();
+        
+        for (int p = 0; p < numParts; ++p)
+        {
+            Part& part = parts[size_t(p)];
+            part.wavetableKey = 0;
+            for (int q = 0; q <= p && part.wavetable != nullptr; ++q)
+            {
+                if (parts[size_t(q)].wavetable == part.wavetable)
+                {
+                    part.wavetableKey = SampleType(q + 1);
+                    break;
+                }
+            }
+        }
+        
+        for (int i = 0; i < voiceCount; ++i)
+        {
+            const Wavetable* table = parts[size_t(controls[i].part)].wavetable;
+            voices[i].oscillatorA.setWavetable(table);
+            voices[i].oscillatorB.setWavetable(table);
+            if (voices[i].envelope.isActive())
+            {
+                voices[i].selectAlgorithm(controls[i].frequency, table != nullptr,
+                                          voices[i].algorithm == OscillatorAlgorithm::additive);
+            }
+        }
+    }
+    
+    // Voices leave the cache before this sub-block's settings reach them, so
+    // they catch up with the ones the entry was recorded with.
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        if (cacheCursors[i].isActive())
+        {
+            const Part& part = parts[size_t(controls[i].part)];
+            if (modProgram != nullptr || !isStatic(part) || getPartState(part) != noteCache.getKey(cacheCursors[i]).state)
+            {
+                leaveNoteCache(i);
+            }
+        }
+    }
+    
+    for (int i = 0; i < voiceCount; ++i) 
+    {
+        Voice<SampleType>& voice = voices[i];
+        if (voice.envelope.isActive())
+        {
+            VoiceControl<SampleType>& control = controls[i];
+            Part& part = parts[size_t(control.part)];
+            if (part.wavetable != nullptr)
+            {
+                voice.oscillatorA.setWavetablePosition(part.wavetablePosition);
+                voice.oscillatorB.setWavetablePosition(part.wavetablePosition);
+            }
+            voice.oscillatorA.setFrequency(control.frequency * part.pitchBend * control.pitchMod);
+            voice.oscillatorB.setFrequency(voice.oscillatorA.freq * part.oscBTune * control.oscBPitchMod);
+            
+            voice.oscillatorA.amplitude = LookupTables::velocityAmplitudes<SampleType>.data[size_t(control.velocity)];
+            voice.oscillatorB.amplitude = voice.oscillatorA.amplitude
+                                        * std::clamp(part.oscMixSmoother.getNextValue() + control.oscMixMod,
+                                                     SampleType(0), SampleType(1));
+            control.filterQ = part.filterQ + part.resonanceCtl;
+            control.pitchBend = part.pitchBend;
+            control.filterEnvDepth = part.filterEnvDepth;
+        }
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderVoices(int sampleCount)
+{
+    const size_t stride = size_t(controlInterval);
+    std::array<int, numVoices> activeLength;
+    int longest = 0;
+    
+    // Envelopes run first: they do not depend on the audio, and knowing where
+    // each voice goes silent keeps the shared noise sequence in sample order.
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        Voice<SampleType>& voice = voices[i];
+        activeLength[i] = 0;
+        if (voice.envelope.isActive())
+        {
+            activeLength[i] = voice.renderEnvelope(envelopeBuffer.data() + i * stride, sampleCount);
+            longest = std::max(longest, activeLength[i]);
+        }
+    }
+    
+    // The noise sequence is shared by all parts and drawn for every sounding
+    // voice as soon as any part uses noise, so adding a part does not change
+    // what the others hear.
+    bool withNoise = false;
+    for (int p = 0; p < getNumPartsInUse(); ++p)
+    {
+        withNoise = withNoise || parts[size_t(p)].noiseMix > 0.0f;
+    }
+    
+    if (withNoise)
+    {
+        for (int sample = 0; sample < longest; ++sample)
+        {
+            for (int i = 0; i < voiceCount; ++i)
+            {
+                if (sample < activeLength[i])
+                {
+                    noiseBuffer[i * stride + sample] = noiseGenerator.nextValue() * parts[size_t(controls[i].part)].noiseMix;
+                }
+            }
+        }
+    }
+    
+    partSounding.fill(false);
+    
+    const int factor = oversamplingFactor;
+    const size_t mixStride = stride * size_t(factor);
+    
+    // Voices in the cache share its pages, so they stay on this thread.
+    std::array<bool, numVoices> inBatch {};
+    if (workerPool != nullptr)
+    {
+        int numTasks = 0;
+        int work = 0;
+        for (int i = 0; i < voiceCount; ++i)
+        {
+            if (activeLength[i] > 0 && !cacheCursors[i].isActive())
+            {
+                voiceBatch.voices[size_t(numTasks)] = i;
+                voiceBatch.lengths[size_t(numTasks)] = activeLength[i];
+                ++numTasks;
+                work += activeLength[i] * factor;
+            }
+        }
+        
+        if (numTasks > 1 && work >= minParallelSamples)
+        {
+            SUBSYNTH_TRACE_SCOPE("voice batch", numTasks);
+            workerPool->run(voiceBatch, numTasks);
+            ++parallelBatches;
+            for (int task = 0; task < numTasks; ++task)
+            {
+                inBatch[size_t(voiceBatch.voices[size_t(task)])] = true;
+            }
+        }
+    }
+    
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        if (activeLength[i] == 0)
+        {
+            continue;
+        }
+        
+        Voice<SampleType>& voice = voices[i];
+        const VoiceControl<SampleType>& control = controls[i];
+        SampleType* mixL = mixBufferL.data() + control.part * mixStride;
+        SampleType* mixR = mixBufferR.data() + control.part * mixStride;
+        if (!partSounding[size_t(control.part)])
+        {
+            partSounding[size_t(control.part)] = true;
+            std::fill_n(mixL, sampleCount * factor, SampleType(0));
+            std::fill_n(mixR, sampleCount * factor, SampleType(0));
+        }
+        
+        SampleType* output = voiceBuffer.data();
+        if (inBatch[size_t(i)])
+        {
+            output = voiceOutputs.data() + size_t(i) * mixStride;
+        }
+        else
+        {
+            renderVoice(i, activeLength[i], output, oversampledEnvelope.data(), oversampledNoise.data());
+        }
+        
+        const int length = activeLength[i] * factor;
+        juce::FloatVectorOperations::addWithMultiply(mixL, output, voice.panLeft, length);
+        juce::FloatVectorOperations::addWithMultiply(mixR, output, voice.panRight, length);
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderBatchVoice(int index)
+{
+    const int i = voiceBatch.voices[size_t(index)];
+    const size_t offset = size_t(i) * size_t(controlInterval) * size_t(oversamplingFactor);
+    const bool oversampled = oversamplingFactor > 1;
+    renderVoice(i, voiceBatch.lengths[size_t(index)], voiceOutputs.data() + offset,
+                oversampled ? voiceEnvelopes.data() + offset : nullptr,
+                oversampled ? voiceNoise.data() + offset : nullptr);
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderVoice(int voiceIndex, int length, SampleType* output, SampleType* envelopeScratch, SampleType* noiseScratch)
+{
+    const size_t stride = size_t(controlInterval);
+    const int factor = oversamplingFactor;
+    Voice<SampleType>& voice = voices[voiceIndex];
+    const VoiceControl<SampleType>& control = controls[voiceIndex];
+    
+    const bool voiceNoise = parts[size_t(control.part)].noiseMix > 0.0f;
+    const SampleType* envelope = envelopeBuffer.data() + voiceIndex * stride;
+    const SampleType* noise = noiseBuffer.data() + voiceIndex * stride;
+    
+    if (factor > 1)
+    {
+        for (int sample = 0; sample < length; ++sample)
+        {
+            std::fill_n(envelopeScratch + sample * factor, factor, envelope[sample]);
+        }
+        envelope = envelopeScratch;
+        
+        if (voiceNoise)
+        {
+            for (int sample = 0; sample < length; ++sample)
+            {
+                std::fill_n(noiseScratch + sample * factor, factor, noise[sample]);
+            }
+            noise = noiseScratch;
+        }
+        length *= factor;
+    }
+    
+    if (cacheCursors[voiceIndex].isActive())
+    {
+        renderCachedVoice(voiceIndex, envelope, length, output);
+    }
+    else
+    {
+        auto kernel = voiceKernels<SampleType>[int(voice.algorithm)][voiceNoise ? 1 : 0];
+        (voice.*kernel)(output, envelope, noise, length);
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::renderCachedVoice(int voiceIndex, const SampleType* envelope, int length, SampleType* output)
+{
+    Voice<SampleType>& voice = voices[voiceIndex];
+    auto& cursor = cacheCursors[size_t(voiceIndex)];
+    auto kernel = voiceKernels<SampleType>[int(voice.algorithm)][0];
+    
+    if (!cursor.recording)
+    {
+        const int replayed = noteCache.read(cursor, output, length);
+        
+        // At the end of the entry the voice carries on live, from before
+        // the next tick, and records if the entry is unfinished and free.
+        if (noteCache.isAtEnd(cursor))
+        {
+            catchUp(voiceIndex);
+            if (noteCache.canExtend(cursor))
+            {
+                noteCache.extend(cursor);
+            }
+            else
+            {
+                noteCache.detach(cursor);
+            }
+        }
+        if (replayed == length)
+        {
+            return;
+        }
+        
+        output += replayed;
+        envelope += replayed;
+        length -= replayed;
+        if (!cursor.isActive())
+        {
+            (voice.*kernel)(output, envelope, nullptr, length);
+            return;
+        }
+    }
+    else if ((tickedThisSegment || noteCache.getLength(cursor) == 0) && !noteCache.addSnapshot(cursor, voice))
+    {
+        noteCache.detach(cursor);
+    }
+    
+    (voice.*kernel)(output, envelope, nullptr, length);
+    
+    if (cursor.isActive())
+    {
+        if (!noteCache.append(cursor, output, length))
+        {
+            noteCache.detach(cursor);
+        }
+        else if (reachedSustain(voiceIndex) || noteCache.isFull(cursor))
+        {
+            noteCache.detach(cursor, true);
+        }
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::catchUp(int voiceIndex)
+{
+    Voice<SampleType>& voice = voices[voiceIndex];
+    const int length = noteCache.restore(cacheCursors[size_t(voiceIndex)], voice);
+    auto kernel = voiceKernels<SampleType>[int(voice.algorithm)][0];
+    (voice.*kernel)(noteCache.getScratch(), noteCache.getSilence(), nullptr, length);
+}
+
+template <typename SampleType>
+void Synth<SampleType>::leaveNoteCache(int voiceIndex)
+{
+    auto& cursor = cacheCursors[size_t(voiceIndex)];
+    if (!cursor.isActive())
+    {
+        return;
+    }
+    if (!cursor.recording)
+    {
+        catchUp(voiceIndex);
+    }
+    noteCache.detach(cursor);
+}
+
+template <typename SampleType>
+bool Synth<SampleType>::reachedSustain(int voiceIndex) const
+{
+    const Envelope<SampleType>& envelope = voices[voiceIndex].envelope;
+    const Envelope<SampleType>& filterEnv = controls[voiceIndex].filterEnv;
+    return !envelope.isInAttack() && !filterEnv.isInAttack()
+        && std::abs(envelope.level - envelope.sustainLevel) < SampleType(0.001)
+        && std::abs(filterEnv.level - filterEnv.sustainLevel) < SampleType(0.001);
+}
+
+template <typename SampleType>
+bool Synth<SampleType>::isStatic(const Part& part) const
+{
+    if (part.noiseMix > 0.0f || part.vibrato != 0 || part.pwmDepth != 0 || part.filterLFODepth != 0
+        || part.modWheel != 0 || part.aftertouch != 0 || part.pitchBend != 1 || part.oscMixSmoother.isSmoothing())
+    {
+        return false;
+    }
+    
+    // The modulation smoother has to have settled to the last bit, or the
+    // cutoff keeps creeping from tick to tick.
+    const SampleType filterMod = part.filterKeyTracking + part.filterCtl + (part.filterLFODepth + part.aftertouch) * part.sine;
+    return part.filterSmoother + filterSmootherCoefficient * (filterMod - part.filterSmoother) == part.filterSmoother;
+}
+
+template <typename SampleType>
+std::array<SampleType, NoteCache<SampleType>::stateSize> Synth<SampleType>::getPartState(const Part& part) const
+{
+    return {
+        part.envAttack, part.envDecay, part.envSustain, part.envRelease,
+        part.oscBTune, part.oscMixSmoother.getTargetValue(), part.velocitySensitivity,
+        part.filterQ, part.resonanceCtl, part.filterSmoother, part.filterEnvDepth,
+        part.filterAttack, part.filterDecay, part.filterSustain, part.filterRelease,
+        part.wavetablePosition, part.wavetableKey
+    };
+}
+
+template <typename SampleType>
+template <bool stereo>
+void Synth<SampleType>::writeOutput(SampleType* left, SampleType* right, int sampleCount)
+{
+    using FloatOps = juce::FloatVectorOperations;
+    
+    const int factor = oversamplingFactor;
+    const size_t mixStride = size_t(controlInterval) * size_t(factor);
+    const int length = sampleCount * factor;
+    
+    // At the host rate the parts are summed straight into the output;
+    // oversampled, into a bus that is decimated once for all of them.
+    SampleType* mainL = factor > 1 ? busL.data() : left;
+    SampleType* mainR = factor > 1 ? busR.data() : right;
+    
+    FloatOps::clear(mainL, length);
+    if constexpr (stereo) {
+        FloatOps::clear(mainR, length);
+    }
+    
+    for (int p = 0; p < getNumPartsInUse(); ++p)
+    {
+        Part& part = parts[size_t(p)];
+        std::array<SampleType*, 2>& stem = stemOutputs[size_t(p)];
+        
+        // A silent part only has to keep its level ramp moving.
+        if (!partSounding[size_t(p)])
+        {
+            for (int sample = 0; sample < sampleCount && part.outputLevelSmoother.isSmoothing(); ++sample)
+            {
+                part.outputLevelSmoother.getNextValue();
+            }
+            if (stem[0] != nullptr)
+            {
+                FloatOps::clear(stem[0], sampleCount);
+                FloatOps::clear(stem[1], sampleCount);
+            }
+            continue;
+        }
+        
+        const SampleType* mixL = mixBufferL.data() + size_t(p) * mixStride;
+        const SampleType* mixR = mixBufferR.data() + size_t(p) * mixStride;
+        
+        SampleType level = 0;
+        const SampleType* levels = nextOutputLevels(part, sampleCount, level);
+        
+        // The common case, stereo without a stem, needs no scratch at all.
+        if (stereo && stem[0] == nullptr)
+        {
+            if (levels != nullptr)
+            {
+                FloatOps::addWithMultiply(mainL, mixL, levels, length);
+                FloatOps::addWithMultiply(mainR, mixR, levels, length);
+            }
+            else
+            {
+                FloatOps::addWithMultiply(mainL, mixL, level, length);
+                FloatOps::addWithMultiply(mainR, mixR, level, length);
+            }
+            continue;
+        }
+        
+        SampleType* partL = stem[0] != nullptr && factor == 1 ? stem[0] : partBufferL.data();
+        SampleType* partR = stem[0] != nullptr && factor == 1 ? stem[1] : partBufferR.data();
+        if (levels != nullptr)
+        {
+            FloatOps::multiply(partL, mixL, levels, length);
+            FloatOps::multiply(partR, mixR, levels, length);
+        }
+        else
+        {
+            FloatOps::multiply(partL, mixL, level, length);
+            FloatOps::multiply(partR, mixR, level, length);
+        }
+        
+        if constexpr (stereo) {
+            FloatOps::add(mainL, partL, length);
+            FloatOps::add(mainR, partR, length);
+        } else {
+            FloatOps::add(foldBuffer.data(), partL, partR, length);
+            FloatOps::addWithMultiply(mainL, foldBuffer.data(), SampleType(0.5), length);
+        }
+        
+        if (stem[0] != nullptr && factor > 1)
+        {
+            decimate<2>(decimators[size_t(p) + 1], partL, partR, length);
+            FloatOps::copy(stem[0], partL, sampleCount);
+            FloatOps::copy(stem[1], partR, sampleCount);
         }
     }
+    
+    if (factor > 1)
+    {
+        decimate<stereo ? 2 : 1>(decimators[0], mainL, mainR, length);
+        FloatOps::copy(left, mainL, sampleCount);
+        if constexpr (stereo) {
+            FloatOps::copy(right, mainR, sampleCount);
+        }
+    }
+    
+    juce::ignoreUnused(right);
 }
 
-void Synth::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
+template <typename SampleType>
+const SampleType* Synth<SampleType>::nextOutputLevels(Part& part, int sampleCount, SampleType& level)
 {
+    if (!part.outputLevelSmoother.isSmoothing())
+    {
+        level = part.outputLevelSmoother.getTargetValue();
+        return nullptr;
+    }
+    
+    const int factor = oversamplingFactor;
+    for (int sample = 0; sample < sampleCount; ++sample)
+    {
+        std::fill_n(levelBuffer.data() + sample * factor, factor, part.outputLevelSmoother.getNextValue());
+    }
+    return levelBuffer.data();
+}
+
+template <typename SampleType>
+template <int numChannels>
+void Synth<SampleType>::decimate(std::array<HalfBandDecimator<SampleType>, 2>& stages, SampleType* left, SampleType* right, int length)
+{
+    SampleType* channels[2] = { left, right };
+    for (int stage = 0; stage < numDecimatorStages; ++stage)
+    {
+        length /= 2;
+        stages[size_t(stage)].template process<numChannels>(channels, length);
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
+{
+    const int partIndex = multitimbral ? (data0 & 0x0F) : 0;
+    Part& part = parts[size_t(partIndex)];
+    
+    // The message takes effect at this sample: the next render() starts a
+    // new sub-block, which picks up what it changed.
+    subBlockRemaining = 0;
+    
     switch (data0 & 0xF0) 
     {
         case 0x80:
-            noteOff(data1 & 0x7F);
+            noteOff(partIndex, data1 & 0x7F);
             break;
             
         case 0x90: {
@@ -134,168 +1041,504 @@ void Synth::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
             uint8_t velocity = data2 & 0x7F;
             if (velocity > 0)
             {
-                noteOn(note, velocity);
+                noteOn(partIndex, note, velocity);
             }
             else
             {
-                noteOff(note);
+                noteOff(partIndex, note);
             }
             break;
         }
             
         case 0xE0:
-            pitchBend = std::exp(0.000014102f * float(data1 + 128 * data2 - 8192));
+            part.pitchBend = std::exp(SampleType(0.000014102) * SampleType(data1 + 128 * data2 - 8192));
             break;
         
         case 0xB0:
-            controlChange(data1, data2);
+            controlChange(partIndex, data1, data2);
             break;
             
         case 0xD0:
-            aftertouch = 0.0001f * float(data1 * data1);
+            part.aftertouch = SampleType(0.0001) * SampleType(data1 * data1);
+            part.controllers[size_t(ModSource::aftertouch)] = SampleType(data1) / SampleType(127);
             break;
     }
 }
 
-void Synth::controlChange(uint8_t data1, uint8_t data2)
+template <typename SampleType>
+void Synth<SampleType>::controlChange(int partIndex, uint8_t data1, uint8_t data2)
 {
+    Part& part = parts[size_t(partIndex)];
+    
     switch (data1) {
         case 0x40:
-            sustainPedalPressed = (data2 >= 64);
+            part.sustainPedalPressed = (data2 >= 64);
 
-            if (!sustainPedalPressed) {
-                noteOff(-1);
+            if (!part.sustainPedalPressed) {
+                noteOff(partIndex, -1);
             }
             break;
             
         case 0x01:
-            modWheel = 0.000005f * float(data2 * data2); 
+            part.modWheel = SampleType(0.000005) * SampleType(data2 * data2); 
+            part.controllers[size_t(ModSource::modWheel)] = SampleType(data2) / SampleType(127);
+            break;
+            
+        case 0x02:
+            part.controllers[size_t(ModSource::breath)] = SampleType(data2) / SampleType(127);
+            break;
+            
+        case 0x0B:
+            part.controllers[size_t(ModSource::expression)] = SampleType(data2) / SampleType(127);
             break;
         
         case 0x47:
-            resonanceCtl = 154.0f / float(154 - data2); 
+            part.resonanceCtl = 154.0f / SampleType(154 - data2); 
             break;
             
         // Filter +
         case 0x4A:
-            filterCtl = 0.02f * float(data2); break;
+            part.filterCtl = SampleType(0.02) * SampleType(data2); break;
         // Filter -
         case 0x4B:
-            filterCtl = -0.03f * float(data2); break;
+            part.filterCtl = SampleType(-0.03) * SampleType(data2); break;
 
         // All notes off
         default:
             if (data1 >= 0x78) {
-                for (int i = 0; i < this->numVoices; ++i) {
-                    voices[i].reset();
+                for (int i = 0; i < voiceCount; ++i) {
+                    if (controls[i].part == partIndex) {
+                        if (cacheCursors[i].isActive()) {
+                            noteCache.detach(cacheCursors[i]);
+                        }
+                        voices[i].reset();
+                        controls[i].reset();
+                    }
                 }
-                sustainPedalPressed = false;
+                part.sustainPedalPressed = false;
             }
             break;
     }
 }
 
-void Synth::noteOn(int note, int velocity)
+template <typename SampleType>
+int Synth<SampleType>::findVoice(int partIndex, int note) const
 {
-    if (this->ignoreVelocity) velocity = 80;
-    int voiceIndex = 0;
-    float minAmp = 9999.0f;
-    for (int i = 0; i < this->numVoices; ++i)
+    int partVoices = 0;
+    for (int i = 0; i < voiceCount; ++i)
     {
-        if (!voices[i].envelope.isActive() || voices[i].note == note)
+        if (voices[i].envelope.isActive() && controls[i].part == partIndex)
         {
-            voiceIndex = i;
-            break;
+            ++partVoices;
+        }
+    }
+    
+    // At its limit a part can only steal from its own sounding voices; a
+    // free voice would take it over the limit, even one that last played
+    // this part. Otherwise it takes a free voice, or steals the quietest
+    // voice of any part.
+    const bool atLimit = partVoices >= parts[size_t(partIndex)].voiceLimit;
+    
+    int voiceIndex = -1;
+    SampleType minAmp = 9999.0f;
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        const Voice<SampleType>& voice = voices[i];
+        const VoiceControl<SampleType>& control = controls[i];
+        if (atLimit && (control.part != partIndex || !voice.envelope.isActive()))
+        {
+            continue;
+        }
+        
+        if ((!atLimit && !voice.envelope.isActive()) || (control.note == note && control.part == partIndex))
+        {
+            return i;
         }
         
-        if ((voices[i].velocity * voices[i].envelope.level) < minAmp && !voices[i].envelope.isInAttack()) {
-            minAmp = voices[i].velocity * voices[i].envelope.level;
+        if (voiceIndex < 0)
+        {
             voiceIndex = i;
         }
         
+        if ((control.velocity * voice.envelope.level) < minAmp && !voice.envelope.isInAttack()) {
+            minAmp = control.velocity * voice.envelope.level;
+            voiceIndex = i;
+        }
     }
     
-    Voice& voice = voices[voiceIndex];
-    voice.note = note;
-    float frequency = 440.0f * std::exp2(float(note - 69 + masterTune) / 12.0f);
+    return std::max(voiceIndex, 0);
+}
+
+template <typename SampleType>
+void Synth<SampleType>::noteOn(int partIndex, int note, int velocity)
+{
+    Part& part = parts[size_t(partIndex)];
+    if (part.ignoreVelocity) velocity = 80;
     
-    voice.frequency = frequency;
-    voice.cutoff = frequency / PI;
-    voice.cutoff *= std::exp(velocitySensitivity * float(velocity - 64));
-    voice.velocity = velocity;
-    voice.updatePanning();
+    // Keys the tuning leaves unmapped do not sound, and nothing sounds
+    // before allocateResources().
+    if (part.noteFrequencies[size_t(note)] <= SampleType(0) || voiceCount == 0)
+    {
+        return;
+    }
     
-    voice.oscillatorA.setSampleRate(this->sampleRate);
-    voice.oscillatorB.setSampleRate(this->sampleRate);
+    SUBSYNTH_TRACE_SCOPE("noteOn", note);
+    const int voiceIndex = findVoice(partIndex, note);
+    const bool wasActive = voices[voiceIndex].envelope.isActive();
+    if (wasActive)
+    {
+        ++voiceSteals;
+        SUBSYNTH_TRACE_INSTANT("voice steal", voiceIndex);
+    }
+    
+    // A stolen voice keeps its filter state, so it has to be exact.
+    leaveNoteCache(voiceIndex);
+    Voice<SampleType>& voice = voices[voiceIndex];
+    VoiceControl<SampleType>& control = controls[voiceIndex];
+    control.part = partIndex;
+    control.note = note;
+    SampleType frequency = part.noteFrequencies[size_t(note)];
+    
+    control.frequency = frequency;
+    voice.oscillatorA.setWavetable(part.wavetable);
+    voice.oscillatorB.setWavetable(part.wavetable);
+    voice.selectAlgorithm(frequency, part.wavetable != nullptr, part.partialShape.count > 0);
+    control.cutoff = frequency / juce::MathConstants<SampleType>::pi;
+    control.cutoff *= part.velocityCutoffScales != nullptr ? part.velocityCutoffScales[velocity]
+                                                          : std::exp(part.velocitySensitivity * SampleType(velocity - 64));
+    control.velocity = velocity;
+    voice.noiseGain = SampleType(velocity / 127.0f);
+    control.key = SampleType(note - 60) / SampleType(64);
+    control.pitchMod = 1;
+    control.oscBPitchMod = 1;
+    control.oscMixMod = 0;
+    control.envelopeTimeMod = 0;
+    control.panning = LookupTables::notePanning<SampleType>.position[size_t(note)];
+    voice.updatePanning(note);
+    
+    voice.oscillatorA.setSampleRate(this->sampleRate * SampleType(oversamplingFactor));
+    voice.oscillatorB.setSampleRate(this->sampleRate * SampleType(oversamplingFactor));
     
     voice.oscillatorA.reset();
     voice.oscillatorB.reset();
+    if (voice.algorithm == OscillatorAlgorithm::additive)
+    {
+        voice.startPartials(part.partialShape, this->sampleRate * SampleType(oversamplingFactor));
+    }
     
-    voice.envelope.attackA = envAttack;
-    voice.envelope.decayA = envDecay;
-    voice.envelope.sustainLevel = envSustain;
-    voice.envelope.releaseA = envRelease;
+    voice.envelope.attackA = part.envAttack;
+    voice.envelope.decayA = part.envDecay;
+    voice.envelope.sustainLevel = part.envSustain;
+    voice.envelope.releaseA = part.envRelease;
     voice.envelope.attack();
     
-    voice.filterEnv.attackA = filterAttack;
-    voice.filterEnv.decayA = filterDecay;
-    voice.filterEnv.sustainLevel = filterSustain;
-    voice.filterEnv.releaseA = filterRelease;
-    voice.filterEnv.attack();
+    control.filterEnv.attackA = part.filterAttack;
+    control.filterEnv.decayA = part.filterDecay;
+    control.filterEnv.sustainLevel = part.filterSustain;
+    control.filterEnv.releaseA = part.filterRelease;
+    
+    // Only a voice starting from silence sounds the same every time. The
+    // filter envelope stops where the last note's amplitude died out, and
+    // the filter's ramps still sit at that note's cutoff, so a cached note
+    // starts both from idle instead. Without a filter envelope its
+    // cutoff never moves, so it starts there and every tick just holds it:
+    // where the ticks fall makes no difference, and notes at any tick phase
+    // share one entry.
+    const bool cacheable = noteCache.isEnabled() && !wasActive && modProgram == nullptr
+        && voice.algorithm != OscillatorAlgorithm::additive && isStatic(part);
+    const bool fixedCutoff = part.filterEnvDepth == SampleType(0);
+    if (cacheable)
+    {
+        control.filterEnv.reset();
+        if (fixedCutoff)
+        {
+            voice.filter.resetTo(getCutoffCoefficient(control.cutoff, part.filterSmoother, part.pitchBend,
+                                                      voice.filter.getCutoffScaler()),
+                                 Filter<SampleType>::scaleResonance(part.filterQ + part.resonanceCtl));
+        }
+        else
+        {
+            voice.filter.resetToIdle();
+        }
+    }
+    control.filterEnv.attack();
+    
+    if (cacheable)
+    {
+        noteCache.start({ getPartState(part), frequency, velocity, fixedCutoff ? -1 : lfoStep },
+                        cacheCursors[size_t(voiceIndex)]);
+    }
 }
 
-void Synth::noteOff(int note)
+template <typename SampleType>
+void Synth<SampleType>::noteOff(int partIndex, int note)
 {
-    for (int i = 0; i < this->numVoices; ++i)
+    const Part& part = parts[size_t(partIndex)];
+    for (int i = 0; i < voiceCount; ++i)
     {
-        Voice& voice = voices[i];
-        if (voice.note == note) 
+        VoiceControl<SampleType>& control = controls[i];
+        if (control.note == note && control.part == partIndex) 
         {
-            if (sustainPedalPressed) 
+            if (part.sustainPedalPressed) 
             {
-                voice.note = -1;
+                control.note = -1;
             }
             else
             {
-                voice.envelope.release();
-                voice.filterEnv.release();
-                voice.note = 0;
+                leaveNoteCache(i);
+                voices[i].envelope.release();
+                control.filterEnv.release();
+                control.note = 0;
             }
         }
     }
 }
 
-void Synth::updateLFO() 
+template <typename SampleType>
+void Synth<SampleType>::updateLFO() 
 {
+    SUBSYNTH_TRACE_SCOPE("control tick");
     
-    if (--lfoStep <= 0)
+    for (int p = 0; p < getNumPartsInUse(); ++p)
     {
-        lfoStep = LFO_MAX;
-        lfo += lfoInc;
-        if (lfo > PI) 
+        Part& part = parts[size_t(p)];
+        
+        part.lfo += part.lfoInc;
+        if (part.lfo > juce::MathConstants<SampleType>::pi) 
         { 
-            lfo -= TWO_PI;
+            part.lfo -= juce::MathConstants<SampleType>::twoPi;
         }
         
-        const float sine = std::sin(lfo);
-        float vibratoMod = 1.0f + sine * (modWheel + vibrato);
-        float pwm = 1.0f + sine * (modWheel + pwmDepth);
+        part.sine = std::sin(part.lfo);
+        part.vibratoMod = 1.0f + part.sine * (part.modWheel + part.vibrato);
+        part.pwm = 1.0f + part.sine * (part.modWheel + part.pwmDepth);
         
-        float filterMod = filterKeyTracking + filterCtl + (filterLFODepth + aftertouch) * sine;
+        SampleType filterMod = part.filterKeyTracking + part.filterCtl + (part.filterLFODepth + part.aftertouch) * part.sine;
         
-        filterSmoother += 0.005f * (filterMod - filterSmoother);
+        part.filterSmoother += filterSmootherCoefficient * (filterMod - part.filterSmoother);
+    }
+    
+    // The filter part of the tick is done for all voices at once in lanes,
+    // so the exp() calls run as plain loops the compiler can vectorise.
+    // Silent voices get harmless values and are skipped when scattering.
+    alignas(32) std::array<SampleType, numVoices> filterEnvelope;
+    alignas(32) std::array<SampleType, numVoices> exponent;
+    alignas(32) std::array<SampleType, numVoices> cutoff;
+    alignas(32) std::array<SampleType, numVoices> pitch;
+    alignas(32) std::array<SampleType, numVoices> resonance;
+    
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        if (voices[i].envelope.isActive())
+        {
+            VoiceControl<SampleType>& control = controls[i];
+            filterEnvelope[i] = control.filterEnv.nextValue();
+            exponent[i] = parts[size_t(control.part)].filterSmoother + control.filterEnvDepth * filterEnvelope[i];
+            cutoff[i] = control.cutoff;
+            pitch[i] = control.pitchBend;
+            resonance[i] = control.filterQ;
+        }
+        else
+        {
+            filterEnvelope[i] = 0.0f;
+            exponent[i] = 0.0f;
+            cutoff[i] = 1000.0f;
+            pitch[i] = 1.0f;
+            resonance[i] = 0.0f;
+        }
+    }
+    
+    alignas(32) std::array<SampleType, numVoices> pitchFactor;
+    alignas(32) std::array<SampleType, numVoices> oscBPitchFactor;
+    pitchFactor.fill(SampleType(1));
+    oscBPitchFactor.fill(SampleType(1));
+    
+    // The destinations set directly on the voices are written once more
+    // after their last route goes, with no modulation, which puts the
+    // voices back where their notes started them.
+    const uint32_t destinationMask = modProgram != nullptr ? modProgram->destinationMask : 0;
+    const bool modulateVoices = ((destinationMask | appliedVoiceDestinations) & voiceDestinations) != 0;
+    appliedVoiceDestinations = destinationMask & voiceDestinations;
+    
+    alignas(32) std::array<std::array<SampleType, numVoices>, numModDestinations> amounts;
+    if (modProgram == nullptr && modulateVoices)
+    {
+        for (auto& lane : amounts)
+        {
+            lane.fill(SampleType(0));
+        }
+    }
+    
+    if (modProgram != nullptr)
+    {
+        evaluateModMatrix(filterEnvelope, amounts);
         
-        for (int i = 0; i < numVoices; ++i)
+        if (modProgram->uses(ModDestination::cutoff))
+        {
+            for (int i = 0; i < voiceCount; ++i)
+            {
+                exponent[i] += amounts[size_t(ModDestination::cutoff)][i];
+            }
+        }
+        if (modProgram->uses(ModDestination::resonance))
+        {
+            for (int i = 0; i < voiceCount; ++i)
+            {
+                resonance[i] += amounts[size_t(ModDestination::resonance)][i];
+            }
+        }
+        if (modProgram->uses(ModDestination::pitch))
+        {
+            for (int i = 0; i < voiceCount; ++i)
+            {
+                pitchFactor[i] = std::exp(amounts[size_t(ModDestination::pitch)][i]);
+            }
+        }
+        if (modProgram->uses(ModDestination::oscBPitch))
+        {
+            for (int i = 0; i < voiceCount; ++i)
+            {
+                oscBPitchFactor[i] = std::exp(amounts[size_t(ModDestination::oscBPitch)][i]);
+            }
+        }
+    }
+    
+    const SampleType cutoffScaler = voices[0].filter.getCutoffScaler();
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        cutoff[i] = getCutoffCoefficient(cutoff[i], exponent[i], pitch[i], cutoffScaler);
+    }
+    
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        resonance[i] = Filter<SampleType>::scaleResonance(resonance[i]);
+    }
+    
+    for (int i = 0; i < voiceCount; ++i)
+    {
+        Voice<SampleType>& voice = voices[i];
+        if (voice.envelope.isActive())
         {
-            Voice& voice = voices[i];
-            if (voice.envelope.isActive())
+            VoiceControl<SampleType>& control = controls[i];
+            
+            // The oscillators carry the previous tick's pitch modulation, so
+            // only the change is applied.
+            const SampleType pitchRatio = pitchFactor[i] / control.pitchMod;
+            const SampleType oscBPitchRatio = oscBPitchFactor[i] / control.oscBPitchMod;
+            control.pitchMod = pitchFactor[i];
+            control.oscBPitchMod = oscBPitchFactor[i];
+            
+            const Part& part = parts[size_t(control.part)];
+            voice.oscillatorA.setFrequency(voice.oscillatorA.freq * part.vibratoMod * pitchRatio);
+            voice.oscillatorB.setFrequency(voice.oscillatorB.freq * part.pwm * pitchRatio * oscBPitchRatio);
+            voice.filter.setTargets(cutoff[i], resonance[i]);
+            
+            if (modulateVoices)
             {
-                voice.oscillatorA.setFrequency(voice.oscillatorA.freq * vibratoMod);
-                voice.oscillatorB.setFrequency(voice.oscillatorB.freq * pwm);
-                voice.filterMod = filterSmoother;
-                voice.updateLFO();
+                control.oscMixMod = amounts[size_t(ModDestination::oscMix)][i];
+                voice.oscillatorB.amplitude = voice.oscillatorA.amplitude
+                                            * std::clamp(part.oscMixSmoother.getCurrentValue() + control.oscMixMod,
+                                                         SampleType(0), SampleType(1));
+                
+                // Noise only plays in parts that have some.
+                voice.noiseGain = SampleType(control.velocity / 127.0f)
+                                * std::max(SampleType(0), SampleType(1) + amounts[size_t(ModDestination::noise)][i]);
+                
+                voice.setPanning(control.panning + amounts[size_t(ModDestination::pan)][i],
+                                 std::exp(amounts[size_t(ModDestination::level)][i]));
+                
+                // Only the change is applied, as with pitch.
+                const SampleType times = amounts[size_t(ModDestination::envelopeTimes)][i];
+                if (times != control.envelopeTimeMod)
+                {
+                    const SampleType exponent = std::exp(control.envelopeTimeMod - times);
+                    voice.envelope.stretch(exponent);
+                    control.filterEnv.stretch(exponent);
+                    control.envelopeTimeMod = times;
+                }
             }
         }
     }
 }
 
+template <typename SampleType>
+void Synth<SampleType>::evaluateModMatrix(const std::array<SampleType, numVoices>& filterEnvelope,
+                                          std::array<std::array<SampleType, numVoices>, numModDestinations>& amounts)
+{
+    const ModProgram& program = *modProgram;
+    
+    // Gather the sources the program reads into one lane per source, so
+    // every operation below is a plain multiply-add across all voices.
+    alignas(32) std::array<std::array<SampleType, numVoices>, numModSources> sources;
+    
+    for (int s = 1; s < numModSources; ++s)
+    {
+        const auto source = ModSource(s);
+        if (!program.uses(source))
+        {
+            continue;
+        }
+        
+        auto& lane = sources[size_t(s)];
+        switch (source)
+        {
+            case ModSource::lfo:
+                for (int i = 0; i < voiceCount; ++i)
+                {
+                    lane[i] = parts[size_t(controls[i].part)].sine;
+                }
+                break;
+                
+            case ModSource::envelope:
+                for (int i = 0; i < voiceCount; ++i)
+                {
+                    lane[i] = voices[i].envelope.level;
+                }
+                break;
+                
+            case ModSource::filterEnvelope:
+                lane = filterEnvelope;
+                break;
+                
+            case ModSource::velocity:
+                for (int i = 0; i < voiceCount; ++i)
+                {
+                    lane[i] = SampleType(controls[i].velocity) / SampleType(127);
+                }
+                break;
+                
+            case ModSource::key:
+                for (int i = 0; i < voiceCount; ++i)
+                {
+                    lane[i] = controls[i].key;
+                }
+                break;
+                
+            default:
+                for (int i = 0; i < voiceCount; ++i)
+                {
+                    lane[i] = parts[size_t(controls[i].part)].controllers[size_t(s)];
+                }
+                break;
+        }
+    }
+    
+    for (auto& lane : amounts)
+    {
+        lane.fill(SampleType(0));
+    }
+    
+    for (const auto& operation : program.operations)
+    {
+        const auto& source = sources[operation.source];
+        auto& destination = amounts[operation.destination];
+        const SampleType amount = SampleType(operation.amount);
+        for (int i = 0; i < voiceCount; ++i)
+        {
+            destination[i] += amount * source[i];
+        }
+    }
+}
+
+template class Synth<float>;
+template class Synth<double>;
@@ -12,8 +12,19 @@
 
 #include <JuceHeader.h>
 #include "Voice.h"
+#include "NoteCache.h"
+#include "WorkerPool.h"
 #include "NoiseGenerator.h"
+#include "ModMatrix.h"
+#include "Tuning.h"
+#include "LookupTables.h"
+#include "Tracer.h"
+#include "HalfBandDecimator.h"
+#include "HalfBandInterpolator.h"
 
+// Float is the default engine; Synth<double> backs the processor's
+// double-precision processBlock.
+template <typename SampleType = float>
 class Synth
 {
 public:
@@ -24,60 +35,444 @@ public:
     void deallocateResources();
     
     void reset();
-    void render(juce::AudioBuffer<float>& buffer, int bufferOffser, int sampleCount, int numChannels);
+    
+    // reset(), and every voice's filter back to its idle cutoff as well, so
+    // what is rendered next does not depend on what was rendered before.
+    void resetToIdle();
+    
+    void render(juce::AudioBuffer<SampleType>& buffer, int bufferOffser, int sampleCount, int numChannels);
     void midiMessage(uint8_t data0, uint8_t data1, uint8_t data2);
     
-    float noiseMix;
-    float envAttack, envDecay, envSustain, envRelease;
-    float oscBTune;
-    float masterTune;
+    // MIDI Tuning Standard SysEx, applied to every part from the next
+    // sample on. Retunes the engine's copy of the tuning in place, so it
+    // neither allocates nor waits for the message thread. Returns false
+    // for a message that is not a valid tuning change.
+    bool retune(const uint8_t* data, int size);
     
     static constexpr int numVoices = 16;
-
-    juce::LinearSmoothedValue<float> outputLevelSmoother;
-    juce::LinearSmoothedValue<float> oscMixSmoother;
+    static constexpr int numParts = 16;
+    
+    // One patch and the controller state of one MIDI channel. All parts
+    // share the voice pool; a part never holds more than voiceLimit voices.
+    struct Part
+    {
+        SampleType noiseMix;
+        SampleType envAttack, envDecay, envSustain, envRelease;
+        SampleType oscBTune;
+        SampleType masterTune;
+        
+        // The oscillator B tuning and LFO rate in Hz are only recomputed
+        // when their parameters move; these are the values they were last
+        // computed from.
+        float oscTune = std::numeric_limits<float>::quiet_NaN();
+        float oscFine = std::numeric_limits<float>::quiet_NaN();
+        float lfoRate = std::numeric_limits<float>::quiet_NaN();
+        SampleType lfoRateHz = 0;
+        
+        // 440 * 2^((note - 69 + masterTune) / 12) for every note, or the
+        // tuning's frequencies shifted by masterTune, so note-on is a
+        // lookup. Rebuilt when either changes: 128 exp2() while the octave
+        // or tuning knob moves, and 128 multiplies for a new tuning or a
+        // tuning SysEx. 0 marks a key the tuning leaves unmapped.
+        std::array<SampleType, LookupTables::numNotes> noteFrequencies {};
+        bool noteFrequenciesBuilt = false;
+        const Tuning::Frequencies* tuning = nullptr;
+        SampleType tuningShift = 1;
+        
+        void setMasterTune(SampleType tune)
+        {
+            if (noteFrequenciesBuilt && tune == masterTune)
+            {
+                return;
+            }
+            masterTune = tune;
+            tuningShift = std::exp2(masterTune / SampleType(12));
+            buildNoteFrequencies();
+        }
+        
+        // The frequencies may have changed in place, so this always
+        // rebuilds.
+        void setTuning(const Tuning::Frequencies* newTuning)
+        {
+            tuning = newTuning;
+            if (noteFrequenciesBuilt)
+            {
+                buildNoteFrequencies();
+            }
+        }
+        
+        void buildNoteFrequencies()
+        {
+            if (tuning == nullptr)
+            {
+                for (int note = 0; note < LookupTables::numNotes; ++note)
+                {
+                    noteFrequencies[size_t(note)] = 440.0f * std::exp2(SampleType(note - 69 + masterTune) / 12.0f);
+                }
+            }
+            else
+            {
+                for (int note = 0; note < LookupTables::numNotes; ++note)
+                {
+                    noteFrequencies[size_t(note)] = SampleType((*tuning)[size_t(note)]) * tuningShift;
+                }
+            }
+            noteFrequenciesBuilt = true;
+        }
+        
+        juce::LinearSmoothedValue<SampleType> outputLevelSmoother;
+        juce::LinearSmoothedValue<SampleType> oscMixSmoother;
+        
+        SampleType velocitySensitivity;
+        bool ignoreVelocity;
+        
+        // exp(velocitySensitivity * (velocity - 64)) for each velocity while
+        // the filter velocity parameter is on one of its steps.
+        const SampleType* velocityCutoffScales = nullptr;
+        
+        SampleType lfoInc;
+        SampleType vibrato;
+        SampleType pwmDepth;
+        
+        SampleType filterKeyTracking;
+        SampleType filterQ;
+        SampleType filterLFODepth;
+        
+        SampleType filterAttack, filterDecay, filterSustain, filterRelease;
+        SampleType filterEnvDepth;
+        
+        int voiceLimit = numVoices;
+        
+        // Morph position through the part's wavetable, 0 to 1.
+        SampleType wavetablePosition = 0;
+        
+        // The table the part plays while one is loaded, set at the start
+        // of a sub-block, and a number the note cache keys on that is the
+        // same for parts sharing a table.
+        const Wavetable* wavetable = nullptr;
+        SampleType wavetableKey = 0;
+        
+        // With a partial count, notes play on the additive oscillator.
+        PartialShape partialShape;
+        
+        // Set by the engine from incoming MIDI.
+        SampleType pitchBend;
+        SampleType modWheel;
+        SampleType resonanceCtl;
+        SampleType filterCtl;
+        SampleType aftertouch;
+        bool sustainPedalPressed;
+        
+        // Controller sources for the mod matrix, normalised to 0..1.
+        std::array<SampleType, size_t(ModSource::count)> controllers {};
+        
+        // Control-rate state.
+        SampleType lfo;
+        SampleType sine;
+        SampleType vibratoMod;
+        SampleType pwm;
+        SampleType filterSmoother;
+    };
+    
+    Part& getPart(int index) { return parts[size_t(index)]; }
+    
+    // When false every MIDI channel plays part 0, as a single-patch synth.
+    bool multitimbral = false;
+    
+    // Control-rate work (LFO, filter envelope and filter coefficients) runs
+    // every controlInterval samples, derived from controlIntervalMs so the
+    // modulation resolution is the same at every sample rate; zero keeps the
+    // fixed 32-sample tick of v0.0.2. Between ticks the filter ramps
+    // linearly to the new coefficients over exactly one control interval,
+    // or over filterSmoothingMs if that is set (50 ms is the JUCE ladder's
+    // smoothing that v0.0.2 had). Both take effect in allocateResources().
+    float controlIntervalMs = 0.5f;
+    float filterSmoothingMs = 0.0f;
+    
+    static constexpr int legacyControlInterval = 32;
+    static constexpr int minControlInterval = 8;
+    static constexpr int maxControlInterval = 256;
+    
+    int getControlInterval() const { return controlInterval; }
+    
+    // Block-rate work (handing over the mod matrix, tuning and wavetable,
+    // and updating the oscillator pitch, mix and filter settings of every
+    // voice) runs once per sub-block of about subBlockSize samples,
+    // rounded to whole control intervals, rather than once per render()
+    // call. Its cost per sample then no longer depends on the host block
+    // size, and neither does the output. A MIDI message still takes effect
+    // at its own sample, by starting a new sub-block there that runs on to
+    // the next control tick plus whole intervals. Zero makes every render()
+    // call a sub-block, as in v0.0.2. Takes effect in allocateResources().
+    int subBlockSize = 0;
+    int getSubBlockLength() const { return subBlockLength; }
+    
+    // Sub-blocks begun since construction.
+    int getSubBlockCount() const { return subBlocks; }
+    
+    // The oscillators and filters run at 1, 2 or 4 times the sample rate,
+    // and the summed voices are decimated back with IIR half-band filters.
+    // Takes effect in allocateResources().
+    int oversampling = 1;
+    int getOversamplingFactor() const { return oversamplingFactor; }
+    
+    // Opt-in: at host rates of at least twice minInternalRate, everything
+    // runs at the host rate halved once or twice (never below it, nor more
+    // than four times lower), and the output and stems are upsampled back
+    // with IIR half-band interpolators. allocateResources() then sizes
+    // everything for the internal rate. Zero always renders at the host
+    // rate. Takes effect in allocateResources().
+    double minInternalRate = 0.0;
+    int getRateDivisor() const { return rateDivisor; }
+    
+    // The oversampling decimators' and upsampling interpolators' delay at
+    // low frequencies, in host samples, rounded; 0 with neither.
+    int getLatencySamples() const { return latencySamples; }
+    
+    // Optional stereo stems, one per part: the first of two channels in the
+    // buffer passed to render(), or -1 for none. The main output still
+    // carries every part.
+    std::array<int, numParts> stemChannels;
+    
+    // allocateResources() creates maxPolyphony voices, up to numVoices, and
+    // sizes the scratch for them; nothing plays before it.
+    int maxPolyphony = numVoices;
+    int getVoiceCount() const { return voiceCount; }
+    
+    // Each voice's two partial banks are several kilobytes, so they are
+    // kept apart from the voices and only allocated when this is set;
+    // without them a part with a partial count plays the saws. Takes
+    // effect in allocateResources().
+    bool additive = false;
+    
+    // Note-ons that took over a sounding voice since construction.
+    int getVoiceStealCount() const { return voiceSteals; }
+    
+    // Bytes owned by this engine: the object itself plus its voices and
+    // scratch.
+    size_t getMemoryFootprint() const;
+    
+    // Opt-in: notes of parts nothing modulates are recorded up to their
+    // sustain and replayed from memory, within this many bytes. Zero turns
+    // the cache off. Takes effect in allocateResources().
+    size_t noteCacheBytes = 0;
+    const NoteCache<SampleType>& getNoteCache() const { return noteCache; }
+    
+    // Opt-in: with a pool, the voices of a segment render as one batch of
+    // tasks on it, each into its own buffer, and are mixed in voice order
+    // afterwards, so the output is the same on any number of threads.
+    // Takes effect in allocateResources().
+    //
+    // A segment is at most one control interval long, 24 samples at 48 kHz
+    // with the default 0.5 ms, so a full 16-voice segment at 1x is 384
+    // voice samples. Every batch costs the same handoff however little is
+    // in it, so segments with less work than minParallelSamples (at the
+    // oscillator rate, summed over the voices) stay on the calling thread:
+    // the few samples a block edge or a MIDI event cuts off a tick, and a
+    // voice or two. Raise it on machines where waking the workers is slow.
+    WorkerPool* workerPool = nullptr;
+    int minParallelSamples = 128;
     
-    float velocitySensitivity;
-    bool ignoreVelocity;
+    // Segments rendered as a batch on the pool since construction.
+    int getParallelBatchCount() const { return parallelBatches; }
     
-    const int LFO_MAX = 32;
-    float lfoInc;
-    float vibrato;
-    float pwmDepth;
+    // Envelope coefficients tabulated for the audio rate and the control
+    // rate by allocateResources().
+    const EnvelopeCurve<SampleType>& getEnvelopeCurve() const { return envelopeCurve; }
+    const EnvelopeCurve<SampleType>& getFilterEnvelopeCurve() const { return filterEnvelopeCurve; }
     
-    float filterKeyTracking;
-    float filterQ;
-    float filterLFODepth;
+    // User routings, applied on top of the fixed modulation above at every
+    // control tick. Set them from the message thread.
+    ModMatrix modMatrix;
     
-    float filterAttack, filterDecay, filterSustain, filterRelease;
-    float filterEnvDepth;
+    // A user wavetable replaces the saw oscillators of a part while one is
+    // loaded into its slot. Load them from the message thread.
+    std::array<WavetableSlot, numParts> wavetables;
+    
+    // A microtonal tuning shared by all parts, with each part's master tune
+    // on top. Publish it from the message thread; tuning SysEx goes to
+    // retune() instead.
+    TuningSlot tuning;
     
 private:
-    void noteOn(int note, int velocity);
-    void noteOff(int note);
+    void noteOn(int partIndex, int note, int velocity);
+    void noteOff(int partIndex, int note);
+    
+    void controlChange(int partIndex, uint8_t data1, uint8_t data2);
+    
+    int findVoice(int partIndex, int note) const;
+    
+    // Only part 0 is used unless the synth is multitimbral.
+    int getNumPartsInUse() const { return multitimbral ? numParts : 1; }
+    
+    // The tuning the parts play: the one last published, retuned in place
+    // by any SysEx since. The parts only point at it once it differs from
+    // equal temperament, which they compute exactly as they always have.
+    const Tuning equalTemperament;
+    Tuning::Frequencies tuningFrequencies = equalTemperament.getFrequencies();
+    
+    SampleType sampleRate;
     
-    void controlChange(uint8_t data1, uint8_t data2);
+    // render() at the internal rate, with the stems of the parts in the
+    // given channels of buffer.
+    void renderInternal(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels,
+                        const std::array<int, numParts>& stems);
     
-    float sampleRate;
+    // Renders whole internal samples into reducedBuffer, upsamples them
+    // into upsampledBuffer and hands them out from there, so a call for
+    // fewer host samples than the divisor may render nothing at all.
+    // Channels 0 and 1 carry the main output and 2 + 2p the stem of part p.
+    void renderReducedRate(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels);
+    int rateDivisor = 1;
+    int latencySamples = 0;
+    juce::AudioBuffer<SampleType> reducedBuffer;
+    juce::AudioBuffer<SampleType> upsampledBuffer;
+    std::vector<SampleType> interpolatedL;
+    std::vector<SampleType> interpolatedR;
+    int upsampledPosition = 0;
+    int upsampledLength = 0;
+    std::array<bool, numParts> upsampledStems {};
+    // Index 0 upsamples the main output, index 1 + p the stem of part p.
+    std::array<std::array<HalfBandInterpolator<SampleType>, 2>, numParts + 1> interpolators;
+    template <int numChannels>
+    void interpolate(std::array<HalfBandInterpolator<SampleType>, 2>& stages, int channel, int length);
     
     NoiseGenerator noiseGenerator;
     
-    float pitchBend;
+    std::array<Part, numParts> parts;
+    // voiceCount of each, sized by allocateResources(); none before it.
+    std::vector<Voice<SampleType>> voices;
+    std::vector<VoiceControl<SampleType>> controls;
+    std::vector<PartialBank<SampleType>> partialBanks;
+    int voiceCount = 0;
+    int voiceSteals = 0;
+    int parallelBatches = 0;
+    
+    void renderVoices(int sampleCount);
+    
+    // One voice's segment into output, length samples at the output rate.
+    // The scratch holds the envelope and noise at the oscillator rate.
+    void renderVoice(int voiceIndex, int length, SampleType* output, SampleType* envelopeScratch, SampleType* noiseScratch);
+    
+    struct VoiceBatch : WorkerPool::Batch
+    {
+        Synth* synth = nullptr;
+        int sampleCount = 0;
+        std::array<int, numVoices> voices {};
+        std::array<int, numVoices> lengths {};
+        
+        void runTask(int index) override { synth->renderBatchVoice(index); }
+    };
+    VoiceBatch voiceBatch;
+    void renderBatchVoice(int index);
+    
+    // Per-voice buffers for batches, one oversampled segment each; only
+    // allocated with a worker pool.
+    std::vector<SampleType> voiceOutputs;
+    std::vector<SampleType> voiceEnvelopes;
+    std::vector<SampleType> voiceNoise;
+    template <bool stereo>
+    void writeOutput(SampleType* left, SampleType* right, int sampleCount);
+    
+    // The part's level for each sample, held across oversampled samples, or
+    // nullptr with the steady level in level when it is not ramping.
+    const SampleType* nextOutputLevels(Part& part, int sampleCount, SampleType& level);
     
-    std::array<Voice, numVoices> voices;
+    // In place, through the prepared half-band stages, leaving
+    // length / oversamplingFactor samples at the start of each channel.
+    template <int numChannels>
+    void decimate(std::array<HalfBandDecimator<SampleType>, 2>& stages, SampleType* left, SampleType* right, int length);
     
-    bool sustainPedalPressed;
+    int controlInterval = legacyControlInterval;
     
+    // Runs at the start of every sub-block.
+    void beginSubBlock();
+    int subBlockLength = 0;
+    int subBlockRemaining = 0;
+    int subBlocks = 0;
+    
+    // Per-segment scratch, at most controlInterval samples long. The mix
+    // buffers hold one segment per part.
+    std::vector<SampleType> envelopeBuffer;
+    std::vector<SampleType> noiseBuffer;
+    std::vector<SampleType> voiceBuffer;
+    std::vector<SampleType> mixBufferL;
+    std::vector<SampleType> mixBufferR;
+    std::array<bool, numParts> partSounding {};
+    
+    // The mix stage's scratch, one oversampled segment each: a part's level
+    // ramp, the part scaled by it, and its mono fold-down.
+    std::vector<SampleType> levelBuffer;
+    std::vector<SampleType> partBufferL;
+    std::vector<SampleType> partBufferR;
+    std::vector<SampleType> foldBuffer;
+    
+    // Where the current segment's stems go; null for parts without one.
+    std::array<std::array<SampleType*, 2>, numParts> stemOutputs {};
+    
+    // With oversampling, the voice and mix buffers above hold
+    // oversamplingFactor samples per output sample. The envelope and noise
+    // are generated at the output rate and held for the oversampled kernel.
+    int oversamplingFactor = 1;
+    int numDecimatorStages = 0;
+    std::vector<SampleType> oversampledEnvelope;
+    std::vector<SampleType> oversampledNoise;
+    std::vector<SampleType> busL;
+    std::vector<SampleType> busR;
+    // Index 0 decimates the main output, index 1 + p the stem of part p.
+    std::array<std::array<HalfBandDecimator<SampleType>, 2>, numParts + 1> decimators;
+    
+    // Runs once per control tick (every controlInterval samples).
     void updateLFO();
     int lfoStep;
-    float lfo;
     
-    float modWheel;
+    // The one-pole coefficient a tick sets a voice's filter to.
+    static SampleType getCutoffCoefficient(SampleType cutoff, SampleType exponent, SampleType pitch, SampleType cutoffScaler)
+    {
+        SampleType modulatedCutoff = cutoff * std::exp(exponent) / pitch;
+        modulatedCutoff = std::min(std::max(modulatedCutoff, SampleType(20)), SampleType(20000));
+        return std::exp(modulatedCutoff * cutoffScaler);
+    }
+    
+    // Replaying voices skip the kernel; recording ones add a snapshot to
+    // their entry whenever the segment starts with a tick.
+    NoteCache<SampleType> noteCache;
+    std::vector<typename NoteCache<SampleType>::Cursor> cacheCursors;
+    bool tickedThisSegment = false;
+    static constexpr double maxCachedSeconds = 4.0;
+    
+    // Whether the part's voices sound the same on every note, and the
+    // settings they then depend on.
+    bool isStatic(const Part& part) const;
+    std::array<SampleType, NoteCache<SampleType>::stateSize> getPartState(const Part& part) const;
+    
+    // Brings a replaying voice's oscillators and filter up to its place in
+    // the entry, so it can carry on live.
+    void catchUp(int voiceIndex);
+    void leaveNoteCache(int voiceIndex);
+    void renderCachedVoice(int voiceIndex, const SampleType* envelope, int length, SampleType* output);
+    bool reachedSustain(int voiceIndex) const;
+    
+    const ModProgram* modProgram = nullptr;
+    static constexpr int numModSources = int(ModSource::count);
+    static constexpr int numModDestinations = int(ModDestination::count);
+    
+    // The destinations the control tick sets on the voices rather than
+    // folding into the pitch and filter, and those of them the last tick
+    // modulated.
+    static constexpr uint32_t voiceDestinations = (1u << unsigned(ModDestination::oscMix))
+                                                | (1u << unsigned(ModDestination::noise))
+                                                | (1u << unsigned(ModDestination::pan))
+                                                | (1u << unsigned(ModDestination::level))
+                                                | (1u << unsigned(ModDestination::envelopeTimes));
+    uint32_t appliedVoiceDestinations = 0;
     
-    float resonanceCtl;
-    float filterCtl;
+    // Evaluates the mod matrix for all voices into one lane per destination.
+    void evaluateModMatrix(const std::array<SampleType, numVoices>& filterEnvelope,
+                           std::array<std::array<SampleType, numVoices>, numModDestinations>& amounts);
     
-    float aftertouch;
+    SampleType filterSmootherCoefficient = SampleType(0.005);
     
-    float filterSmoother;
+    EnvelopeCurve<SampleType> envelopeCurve;
+    EnvelopeCurve<SampleType> filterEnvelopeCurve;
 };
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SynthParameters.cpp
+    Created: 18 Oct 2026 9:12:40am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "SynthParameters.h"
+
+template <typename SampleType>
+void SynthParameters::applyTo(Synth<SampleType>& synth, double sampleRate, int partIndex) const
+{
+    using T = SampleType;
+    auto& part = synth.getPart(partIndex);
+    T inverseSampleRate = T(1) / T(sampleRate);
+
+    const auto& envelopeCurve = synth.getEnvelopeCurve();
+    part.envAttack = envelopeCurve(envAttack, inverseSampleRate);
+    part.envDecay = envelopeCurve(envDecay, inverseSampleRate);
+
+    part.envSustain = T(envSustain) / T(100);
+
+    if (envRelease < 1.0f) {
+        part.envRelease = T(0.75);
+    } else {
+        part.envRelease = envelopeCurve(envRelease, inverseSampleRate);
+    }
+
+    T noiseMix = T(noise) / T(100);
+    noiseMix *= noiseMix;
+    part.noiseMix = noiseMix * T(0.1);
+
+    part.oscMixSmoother.setTargetValue(T(oscMix) / T(100));
+
+    if (oscTune != part.oscTune || oscFine != part.oscFine)
+    {
+        part.oscTune = oscTune;
+        part.oscFine = oscFine;
+        T semi = oscTune;
+        T cent = oscFine * T(0.01);
+        part.oscBTune = std::pow(T(1.059463094359), semi + cent);
+    }
+
+    part.setMasterTune((octave * T(12)) + (tuning / T(100)));
+
+    part.outputLevelSmoother.setTargetValue(LookupTables::outputGains<T>(outputLevel));
+
+    if (filterVelocity < -90.0f)
+    {
+        part.velocitySensitivity = T(0);
+        part.ignoreVelocity = true;
+        part.velocityCutoffScales = LookupTables::velocityCutoffScales<T>.getRow(0.0f);
+    }
+    else
+    {
+        part.velocitySensitivity = T(0.0005) * filterVelocity;
+        part.ignoreVelocity = false;
+        part.velocityCutoffScales = LookupTables::velocityCutoffScales<T>.getRow(filterVelocity);
+    }
+
+    const T inverseUpdateRate = inverseSampleRate * synth.getControlInterval();
+    if (lfoRate != part.lfoRate)
+    {
+        part.lfoRate = lfoRate;
+        part.lfoRateHz = std::exp(T(7) * lfoRate - T(4));
+    }
+    part.lfoInc = part.lfoRateHz * inverseUpdateRate * juce::MathConstants<T>::twoPi;
+
+    T vibratoAmount = vibrato / T(200);
+    part.vibrato = T(0.2) * vibratoAmount * vibratoAmount;
+
+    part.pwmDepth = part.vibrato;
+    if (vibratoAmount < T(0))
+    {
+        part.vibrato = T(0);
+    }
+
+    part.filterKeyTracking = T(0.08) * filterFreq - T(1.5);
+
+    part.filterQ = LookupTables::filterQs<T>(filterReso);
+
+    T filterLFOAmount = filterLFO / T(100);
+    part.filterLFODepth = T(2.5) * filterLFOAmount * filterLFOAmount;
+
+    const auto& filterEnvelopeCurve = synth.getFilterEnvelopeCurve();
+    part.filterAttack = filterEnvelopeCurve(filterAttack, inverseUpdateRate);
+    part.filterDecay = filterEnvelopeCurve(filterDecay, inverseUpdateRate);
+    T filterSustainLevel = filterSustain / T(100);
+    part.filterSustain = filterSustainLevel * filterSustainLevel;
+    part.filterRelease = filterEnvelopeCurve(filterRelease, inverseUpdateRate);
+
+    part.filterEnvDepth = T(0.06) * filterEnv;
+
+    part.wavetablePosition = T(wavetablePosition) / T(100);
+
+    part.partialShape.count = juce::roundToInt(partials);
+    part.partialShape.tilt = partialTilt;
+    part.partialShape.oddEven = partialBalance / 100.0f;
+    part.partialShape.decay = partialDecay / 10.0f;
+
+    part.voiceLimit = std::clamp(juce::roundToInt(polyphony), 1, Synth<SampleType>::numVoices);
+}
+
+template void SynthParameters::applyTo(Synth<float>&, double, int) const;
+template void SynthParameters::applyTo(Synth<double>&, double, int) const;
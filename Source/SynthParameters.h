@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    SynthParameters.h
+    Created: 18 Oct 2026 9:12:40am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Synth.h"
+
+// Plain snapshot of the user-facing parameter values (same units and defaults
+// as the APVTS layout), so the engine can be driven without a plugin wrapper.
+struct SynthParameters
+{
+    float oscMix = 0.0f;
+    float oscTune = -12.0f;
+    float oscFine = 0.0f;
+    float filterFreq = 100.0f;
+    float filterReso = 15.0f;
+    float filterEnv = 50.0f;
+    float filterLFO = 0.0f;
+    float filterVelocity = 0.0f;
+    float filterAttack = 0.0f;
+    float filterDecay = 30.0f;
+    float filterSustain = 0.0f;
+    float filterRelease = 25.0f;
+    float envAttack = 0.0f;
+    float envDecay = 50.0f;
+    float envSustain = 100.0f;
+    float envRelease = 30.0f;
+    float lfoRate = 0.96f;
+    float vibrato = 0.0f;
+    float noise = 0.0f;
+    float octave = 0.0f;
+    float tuning = 0.0f;
+    float outputLevel = -6.0f;
+    float polyphony = 16.0f;
+    float wavetablePosition = 0.0f;
+    float partials = 0.0f;
+    float partialTilt = 0.0f;
+    float partialBalance = 0.0f;
+    float partialDecay = 0.0f;
+
+    // Sets up one part of the engine; part 0 is the only one a
+    // single-patch synth plays.
+    template <typename SampleType>
+    void applyTo(Synth<SampleType>& synth, double sampleRate, int partIndex = 0) const;
+};
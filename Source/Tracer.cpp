@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    Tracer.cpp
+    Created: 18 Oct 2026 5:41:27pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "Tracer.h"
+
+Tracer& Tracer::getInstance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+    : juce::Thread("SubSynth trace writer")
+{
+}
+
+Tracer::~Tracer()
+{
+    stop();
+    delete[] slots.load();
+}
+
+bool Tracer::start(const juce::File& file)
+{
+    stop();
+
+    auto newStream = std::make_unique<juce::FileOutputStream>(file);
+    if (!newStream->openedOk())
+    {
+        return false;
+    }
+    newStream->setPosition(0);
+    newStream->truncate();
+    newStream->writeText("{\"traceEvents\":[\n", false, false, nullptr);
+
+    // The ring is only allocated the first time tracing is used, and then
+    // kept, since a producer may still be writing into it after stop().
+    if (slots.load(std::memory_order_relaxed) == nullptr)
+    {
+        auto* ring = new Slot[capacity];
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        slots.store(ring, std::memory_order_release);
+    }
+
+    {
+        // Whatever was pushed after the last trace stopped is thrown away
+        // here; anything still on its way in is older than startTime and
+        // dropped by drain().
+        const juce::ScopedLock lock(fileLock);
+        startTime = now();
+        drain();
+        stream = std::move(newStream);
+        firstEvent = true;
+    }
+
+    enabled.store(true, std::memory_order_release);
+    startThread();
+    return true;
+}
+
+void Tracer::stop()
+{
+    if (!enabled.exchange(false))
+    {
+        return;
+    }
+
+    stopThread(1000);
+    drain();
+
+    const juce::ScopedLock lock(fileLock);
+    stream->writeText("\n]}\n", false, false, nullptr);
+    stream->flush();
+    stream.reset();
+}
+
+void Tracer::recordDuration(const char* name, uint64_t begin, uint64_t end, int64_t value)
+{
+    const auto thread = uint64_t(juce::pointer_sized_uint(juce::Thread::getCurrentThreadId()));
+    push({ name, begin, end - begin, thread, value, false });
+}
+
+void Tracer::recordInstant(const char* name, int64_t value)
+{
+    const auto thread = uint64_t(juce::pointer_sized_uint(juce::Thread::getCurrentThreadId()));
+    push({ name, now(), 0, thread, value, true });
+}
+
+void Tracer::push(const Event& event)
+{
+    Slot* const ring = slots.load(std::memory_order_acquire);
+    if (ring == nullptr)
+    {
+        return;
+    }
+
+    uint64_t position = head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = ring[position & (capacity - 1)];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = int64_t(sequence - position);
+        if (difference == 0)
+        {
+            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return;
+            }
+        }
+        else if (difference < 0)
+        {
+            return;
+        }
+        else
+        {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Tracer::run()
+{
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(50);
+    }
+}
+
+void Tracer::drain()
+{
+    const juce::ScopedLock lock(fileLock);
+    Slot* const ring = slots.load(std::memory_order_acquire);
+    if (ring == nullptr)
+    {
+        return;
+    }
+
+    for (;;)
+    {
+        Slot& slot = ring[tail & (capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+        {
+            break;
+        }
+        const Event event = slot.event;
+        slot.sequence.store(tail + capacity, std::memory_order_release);
+        ++tail;
+
+        if (stream == nullptr || event.begin < startTime)
+        {
+            continue;
+        }
+
+        // Chrome trace timestamps are microseconds; three decimals keep
+        // the nanoseconds.
+        const double begin = double(int64_t(event.begin - startTime)) * 0.001;
+        juce::String line;
+        line << (firstEvent ? "" : ",\n")
+             << "{\"name\":\"" << event.name << "\",\"ph\":\"" << (event.instant ? "i\",\"s\":\"t" : "X")
+             << "\",\"ts\":" << juce::String(begin, 3);
+        if (!event.instant)
+        {
+            line << ",\"dur\":" << juce::String(double(event.duration) * 0.001, 3);
+        }
+        line << ",\"pid\":1,\"tid\":" << juce::String(juce::int64(event.thread % 1000000))
+             << ",\"args\":{\"value\":" << juce::String(juce::int64(event.value)) << "}}";
+        stream->writeText(line, false, false, nullptr);
+        firstEvent = false;
+    }
+
+    if (stream != nullptr)
+    {
+        stream->flush();
+    }
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    Tracer.h
+    Created: 18 Oct 2026 5:41:27pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Timeline tracing of audio-thread activity, for finding out what a dropout
+// was spent on. Events go into a preallocated lock-free ring shared by all
+// instances in the process; a background thread drains it into a Chrome
+// trace JSON file, which chrome://tracing and ui.perfetto.dev both open.
+// While tracing is off every trace point costs one acquire load (a plain
+// load on x86) and a branch. Tracing is switched on and off at run time,
+// from the editor or with the SUBSYNTH_TRACE environment variable.
+class Tracer : private juce::Thread
+{
+public:
+    static Tracer& getInstance();
+
+    // Message thread. Opens the file and turns recording on; returns false
+    // if the file cannot be written.
+    bool start(const juce::File& file);
+    // Message thread. Turns recording off and finishes the file.
+    void stop();
+
+    // Acquire, so that a producer that sees tracing on also sees the ring
+    // start() allocated before turning it on.
+    static bool isEnabled()
+    {
+        return enabled.load(std::memory_order_acquire);
+    }
+
+    // Nanoseconds on a monotonic clock.
+    static uint64_t now()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Audio thread. Names must be string literals. A full ring drops the
+    // event rather than waiting. Events that began before the current
+    // trace started, such as a scope still open when the last one
+    // stopped, are dropped when the ring is drained.
+    void recordDuration(const char* name, uint64_t begin, uint64_t end, int64_t value = 0);
+    void recordInstant(const char* name, int64_t value = 0);
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* eventName, int64_t eventValue = 0)
+            : name(eventName), value(eventValue), begin(isEnabled() ? now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (begin != 0)
+            {
+                getInstance().recordDuration(name, begin, now(), value);
+            }
+        }
+
+    private:
+        const char* name;
+        int64_t value;
+        uint64_t begin;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+    Tracer();
+    ~Tracer() override;
+
+    void run() override;
+    void drain();
+
+    struct Event
+    {
+        const char* name;
+        uint64_t begin;
+        uint64_t duration;
+        uint64_t thread;
+        int64_t value;
+        bool instant;
+    };
+
+    // Bounded multi-producer, single-consumer queue: each slot carries a
+    // sequence number that says whether it is free to write or ready to
+    // read, so producers never block each other or the drain thread.
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence { 0 };
+        Event event;
+    };
+
+    static constexpr size_t capacity = 1 << 16;
+    void push(const Event& event);
+
+    static inline std::atomic<bool> enabled { false };
+
+    // Published before enabled, and loaded again by every producer, since
+    // recordDuration() and recordInstant() can be called without checking
+    // isEnabled() first.
+    std::atomic<Slot*> slots { nullptr };
+    std::atomic<uint64_t> head { 0 };
+    uint64_t tail = 0;
+
+    juce::CriticalSection fileLock;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    bool firstEvent = true;
+    uint64_t startTime = 0;
+};
+
+#define SUBSYNTH_TRACE_SCOPE(name, ...) const Tracer::Scope JUCE_JOIN_MACRO(traceScope, __LINE__) (name, ##__VA_ARGS__)
+
+#define SUBSYNTH_TRACE_INSTANT(name, value) \
+    do { if (Tracer::isEnabled()) Tracer::getInstance().recordInstant(name, value); } while (false)
@@ -0,0 +1,328 @@
+/*
+  ==============================================================================
+
+    Tuning.cpp
+    Created: 18 Oct 2026 9:02:27pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "Tuning.h"
+
+namespace
+{
+    double equalTemperedFrequency(double note)
+    {
+        return 440.0 * std::exp2((note - 69.0) / 12.0);
+    }
+
+    // The lines of a Scala file that are not comments.
+    juce::StringArray getScalaLines(const juce::String& text)
+    {
+        juce::StringArray lines;
+        for (const auto& line : juce::StringArray::fromLines(text))
+        {
+            if (!line.startsWithChar('!'))
+            {
+                lines.add(line);
+            }
+        }
+        return lines;
+    }
+
+    // A pitch line of a .scl file: cents if it has a decimal point,
+    // otherwise a ratio or a whole number. Anything after the value is a
+    // comment.
+    bool parseScalaPitch(const juce::String& line, double& cents)
+    {
+        const juce::String value = line.trim().upToFirstOccurrenceOf(" ", false, false)
+                                              .upToFirstOccurrenceOf("\t", false, false);
+        if (value.isEmpty())
+        {
+            return false;
+        }
+        if (value.containsChar('.'))
+        {
+            cents = value.getDoubleValue();
+            return true;
+        }
+
+        const double numerator = value.upToFirstOccurrenceOf("/", false, false).getDoubleValue();
+        const double denominator = value.containsChar('/') ? value.fromFirstOccurrenceOf("/", false, false).getDoubleValue() : 1.0;
+        if (numerator <= 0.0 || denominator <= 0.0)
+        {
+            return false;
+        }
+        cents = 1200.0 * std::log2(numerator / denominator);
+        return true;
+    }
+
+    int floorDivide(int a, int b)
+    {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+}
+
+Tuning::Tuning()
+    : name("12-TET")
+{
+    for (int note = 0; note < numNotes; ++note)
+    {
+        frequencies[size_t(note)] = equalTemperedFrequency(double(note));
+    }
+}
+
+std::shared_ptr<const Tuning> Tuning::fromScala(const juce::String& scale, const juce::String& keyboardMapping,
+                                                juce::String& error)
+{
+    // The scale: a description, the number of pitches, then the pitches
+    // from the first degree up to and including the period.
+    const juce::StringArray scaleLines = getScalaLines(scale);
+    if (scaleLines.size() < 2)
+    {
+        error = "The scale has no pitch count.";
+        return nullptr;
+    }
+    const int numPitches = scaleLines[1].trim().getIntValue();
+    if (numPitches <= 0 || scaleLines.size() < 2 + numPitches)
+    {
+        error = "The scale lists fewer pitches than it declares.";
+        return nullptr;
+    }
+
+    std::vector<double> degrees { 0.0 };
+    for (int i = 0; i < numPitches; ++i)
+    {
+        double cents = 0.0;
+        if (!parseScalaPitch(scaleLines[2 + i], cents))
+        {
+            error = "Cannot read pitch " + juce::String(i + 1) + " of the scale.";
+            return nullptr;
+        }
+        degrees.push_back(cents);
+    }
+    const double period = degrees.back();
+    degrees.pop_back();
+
+    // The keyboard mapping: map size, first and last note, middle note,
+    // reference note and frequency, octave degree, then the map itself.
+    int mapSize = 0;
+    int firstNote = 0;
+    int lastNote = numNotes - 1;
+    int middleNote = 60;
+    int referenceNote = 69;
+    double referenceFrequency = 440.0;
+    int octaveDegree = numPitches;
+    std::vector<int> map;
+
+    if (keyboardMapping.trim().isNotEmpty())
+    {
+        const juce::StringArray lines = getScalaLines(keyboardMapping);
+        if (lines.size() < 7)
+        {
+            error = "The keyboard mapping is incomplete.";
+            return nullptr;
+        }
+        auto field = [&](int index) { return lines[index].trim().upToFirstOccurrenceOf(" ", false, false); };
+        mapSize = field(0).getIntValue();
+        firstNote = std::clamp(field(1).getIntValue(), 0, numNotes - 1);
+        lastNote = std::clamp(field(2).getIntValue(), 0, numNotes - 1);
+        middleNote = field(3).getIntValue();
+        referenceNote = std::clamp(field(4).getIntValue(), 0, numNotes - 1);
+        referenceFrequency = field(5).getDoubleValue();
+        octaveDegree = field(6).getIntValue();
+
+        if (mapSize < 0 || referenceFrequency <= 0.0 || lines.size() < 7 + mapSize)
+        {
+            error = "The keyboard mapping is malformed.";
+            return nullptr;
+        }
+        for (int i = 0; i < mapSize; ++i)
+        {
+            const juce::String entry = field(7 + i);
+            map.push_back(entry.startsWithIgnoreCase("x") ? -1 : entry.getIntValue());
+        }
+    }
+
+    // Cents above the middle note for a key, or false if it is unmapped.
+    auto centsForNote = [&](int note, double& cents)
+    {
+        int degree = note - middleNote;
+        if (mapSize > 0)
+        {
+            const int octave = floorDivide(degree, mapSize);
+            const int entry = map[size_t(degree - octave * mapSize)];
+            if (entry < 0)
+            {
+                return false;
+            }
+            degree = octave * octaveDegree + entry;
+        }
+        const int periods = floorDivide(degree, numPitches);
+        cents = double(periods) * period + degrees[size_t(degree - periods * numPitches)];
+        return true;
+    };
+
+    double referenceCents = 0.0;
+    if (!centsForNote(referenceNote, referenceCents))
+    {
+        error = "The reference note is not mapped.";
+        return nullptr;
+    }
+
+    auto tuning = std::make_shared<Tuning>();
+    tuning->name = scaleLines[0].trim();
+    tuning->equalTemperament = false;
+    for (int note = 0; note < numNotes; ++note)
+    {
+        double cents = 0.0;
+        const bool mapped = note >= firstNote && note <= lastNote && centsForNote(note, cents);
+        tuning->frequencies[size_t(note)] = mapped ? referenceFrequency * std::exp2((cents - referenceCents) / 1200.0) : 0.0;
+    }
+    return tuning;
+}
+
+std::shared_ptr<const Tuning> Tuning::loadScala(const juce::File& scaleFile, const juce::File& keyboardMappingFile,
+                                                juce::String& error)
+{
+    if (!scaleFile.existsAsFile())
+    {
+        error = "Cannot open " + scaleFile.getFullPathName();
+        return nullptr;
+    }
+    const juce::String keyboardMapping = keyboardMappingFile.existsAsFile() ? keyboardMappingFile.loadFileAsString() : juce::String();
+    return fromScala(scaleFile.loadFileAsString(), keyboardMapping, error);
+}
+
+bool Tuning::isTuningSysEx(const uint8_t* data, int size)
+{
+    // F0, non-real-time or real-time universal, device, MIDI Tuning.
+    return size >= 6 && data[0] == 0xf0 && (data[1] == 0x7e || data[1] == 0x7f) && data[3] == 0x08;
+}
+
+std::shared_ptr<const Tuning> Tuning::withSysEx(const uint8_t* data, int size) const
+{
+    auto tuning = std::make_shared<Tuning>(*this);
+    if (!applySysEx(data, size, tuning->frequencies))
+    {
+        return nullptr;
+    }
+    tuning->equalTemperament = false;
+
+    if (data[4] == 0x01)
+    {
+        tuning->name = juce::String(juce::CharPointer_ASCII(reinterpret_cast<const char*>(data + 6)), 16).trim();
+    }
+    return tuning;
+}
+
+bool Tuning::applySysEx(const uint8_t* data, int size, Frequencies& frequencies)
+{
+    if (!isTuningSysEx(data, size) || data[size - 1] != 0xf7)
+    {
+        return false;
+    }
+
+    // Three bytes per note: the semitone, then the fraction of a semitone
+    // above it in 14 bits. 7F 7F 7F leaves the note alone.
+    auto decode = [](const uint8_t* bytes, double& frequency)
+    {
+        if (bytes[0] == 0x7f && bytes[1] == 0x7f && bytes[2] == 0x7f)
+        {
+            return false;
+        }
+        const double fraction = double((bytes[1] << 7) | bytes[2]) / 16384.0;
+        frequency = equalTemperedFrequency(double(bytes[0]) + fraction);
+        return true;
+    };
+
+    const uint8_t subId = data[4];
+    if (subId == 0x01)
+    {
+        // Bulk dump: program, 16 name characters, 128 notes, checksum.
+        constexpr int dumpSize = 6 + 16 + 3 * numNotes + 2;
+        if (size != dumpSize)
+        {
+            return false;
+        }
+        for (int note = 0; note < numNotes; ++note)
+        {
+            decode(data + 22 + 3 * note, frequencies[size_t(note)]);
+        }
+        return true;
+    }
+
+    if (subId == 0x02 || subId == 0x07)
+    {
+        // Single note changes: [bank,] program, count, then key and
+        // three frequency bytes per change.
+        const int countIndex = subId == 0x02 ? 6 : 7;
+        if (size <= countIndex + 1)
+        {
+            return false;
+        }
+        const int count = data[countIndex];
+        if (size != countIndex + 1 + 4 * count + 1)
+        {
+            return false;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            const uint8_t* change = data + countIndex + 1 + 4 * i;
+            decode(change + 1, frequencies[size_t(change[0] & 0x7f)]);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+juce::String Tuning::toString() const
+{
+    juce::StringArray values;
+    values.add(name.replaceCharacter(';', ','));
+    for (double frequency : frequencies)
+    {
+        values.add(juce::String(frequency, 6));
+    }
+    return values.joinIntoString(";");
+}
+
+std::shared_ptr<const Tuning> Tuning::fromString(const juce::String& text)
+{
+    const juce::StringArray values = juce::StringArray::fromTokens(text, ";", {});
+    if (values.size() != 1 + numNotes)
+    {
+        return nullptr;
+    }
+    auto tuning = std::make_shared<Tuning>();
+    tuning->name = values[0];
+    tuning->equalTemperament = false;
+    for (int note = 0; note < numNotes; ++note)
+    {
+        tuning->frequencies[size_t(note)] = values[1 + note].getDoubleValue();
+    }
+    return tuning;
+}
+
+void TuningSlot::publish(std::shared_ptr<const Tuning> tuning)
+{
+    if (tuning != nullptr && tuning->isEqualTemperament())
+    {
+        tuning = nullptr;
+    }
+    holders.publish(std::make_unique<Holder>(Holder { std::move(tuning) }));
+}
+
+void TuningSlot::collectGarbage()
+{
+    holders.collectGarbage();
+}
+
+const Tuning* TuningSlot::acquire(bool& changed)
+{
+    changed = false;
+    const Holder* active = holders.acquire([&changed](const Holder&) { changed = true; });
+    return active != nullptr ? active->tuning.get() : nullptr;
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    Tuning.h
+    Created: 18 Oct 2026 9:02:27pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Handoff.h"
+
+// The frequency of every MIDI note, before a part's master tune. A tuning
+// is immutable once built, so engines and parts can share one. Building
+// one parses text or SysEx and allocates, so it happens on the message
+// thread.
+class Tuning
+{
+public:
+    static constexpr int numNotes = 128;
+    using Frequencies = std::array<double, numNotes>;
+
+    // 12-tone equal temperament with A4 at 440 Hz. The engine computes
+    // this one exactly as it always has.
+    Tuning();
+
+    // A Scala scale (.scl) and an optional keyboard mapping (.kbm, empty
+    // for the default: scale degree 0 on middle C, A4 at 440 Hz). Returns
+    // nullptr and describes the problem in error if either cannot be read.
+    static std::shared_ptr<const Tuning> fromScala(const juce::String& scale, const juce::String& keyboardMapping,
+                                                   juce::String& error);
+    static std::shared_ptr<const Tuning> loadScala(const juce::File& scaleFile, const juce::File& keyboardMappingFile,
+                                                   juce::String& error);
+
+    // MIDI Tuning Standard SysEx, with the F0 and F7. A bulk dump replaces
+    // every note; single note changes (with or without a bank) retune only
+    // the notes they list. Anything else, or a malformed message, returns
+    // nullptr.
+    static bool isTuningSysEx(const uint8_t* data, int size);
+    std::shared_ptr<const Tuning> withSysEx(const uint8_t* data, int size) const;
+
+    // The same retuning done in place, for the audio thread: it neither
+    // allocates nor locks. Returns false and leaves frequencies alone for
+    // a message withSysEx() would reject.
+    static bool applySysEx(const uint8_t* data, int size, Frequencies& frequencies);
+
+    // The frequencies as text, for the plugin state.
+    juce::String toString() const;
+    static std::shared_ptr<const Tuning> fromString(const juce::String& text);
+
+    bool isEqualTemperament() const { return equalTemperament; }
+    const juce::String& getName() const { return name; }
+
+    // 0 for a key the keyboard mapping leaves unmapped; such keys are
+    // silent.
+    double getFrequency(int note) const { return frequencies[size_t(note)]; }
+    const Frequencies& getFrequencies() const { return frequencies; }
+
+private:
+    Frequencies frequencies;
+    juce::String name;
+    bool equalTemperament = true;
+};
+
+// Hands tunings from the message thread to one engine, the same way the
+// mod matrix hands over programs: the audio thread picks the newest one up
+// with acquire() at the start of a block, and releases happen on the
+// message thread in publish() or collectGarbage().
+class TuningSlot
+{
+public:
+    TuningSlot() = default;
+
+    // Message thread. nullptr or an equal-temperament tuning switches back
+    // to the engine's own note table.
+    void publish(std::shared_ptr<const Tuning> tuning);
+    void collectGarbage();
+
+    // Audio thread. Returns nullptr for equal temperament, and sets changed
+    // when it picked up a newly published tuning.
+    const Tuning* acquire(bool& changed);
+
+private:
+    struct Holder
+    {
+        std::shared_ptr<const Tuning> tuning;
+    };
+
+    Handoff<Holder> holders;
+
+    JUCE_DECLARE_NON_COPYABLE(TuningSlot)
+};
@@ -13,74 +13,183 @@
 #include "Oscillator.h"
 #include "Envelope.h"
 #include "Filter.h"
+#include "LookupTables.h"
 
-class Voice
+// Everything a voice touches on every sample. The control tick and note
+// handling only read and write VoiceControl, so rendering a voice streams
+// through one compact, cache-line aligned object per voice.
+template <typename SampleType = float>
+class alignas(64) Voice
 {
 public:
-    int note;
-    int velocity;
-    float frequency;
-    Oscillator oscillatorA;
-    Oscillator oscillatorB;
-    Envelope envelope;
-    float panLeft, panRight;
-    float sawA = 0;
-    float sawB = 0;
-    Filter filter;
-    float cutoff;
-    float filterMod;
-    float filterQ;
-    float pitchBend;
-    Envelope filterEnv;
-    float filterEnvDepth;
+    OscillatorAlgorithm algorithm = OscillatorAlgorithm::polyBLEP;
+    Oscillator<SampleType> oscillatorA;
+    Oscillator<SampleType> oscillatorB;
+    Envelope<SampleType> envelope;
+    Filter<SampleType> filter;
+    SampleType panLeft, panRight;
+    SampleType noiseGain = 0;
+    
+    // The oscillators' banks in the engine's own array, which only engines
+    // that play additive notes have; null otherwise, and the voice plays
+    // the saws.
+    PartialBank<SampleType>* partialsA = nullptr;
+    PartialBank<SampleType>* partialsB = nullptr;
     
     void reset()
     {
-        note = 0;
-        
         oscillatorA.reset();
         oscillatorB.reset();
         envelope.reset();
         
         filter.reset();
-        filterEnv.reset();
         
         panLeft = 0.707f;
         panRight = 0.707f;
     }
     
-    float render(float noise)
+    // The algorithm only depends on the note frequency, so it is chosen at
+    // note-on rather than on every sample. A loaded wavetable replaces the
+    // saws at every pitch, and the additive oscillator replaces both.
+    void selectAlgorithm(SampleType frequency, bool useWavetable, bool useAdditive)
     {
-        if (frequency < 40.0f)
+        useAdditive = useAdditive && partialsA != nullptr;
+        oscillatorA.setPartials(useAdditive ? partialsA : nullptr);
+        oscillatorB.setPartials(useAdditive ? partialsB : nullptr);
+        
+        if (useAdditive)
+        {
+            algorithm = OscillatorAlgorithm::additive;
+        }
+        else if (useWavetable)
+        {
+            algorithm = OscillatorAlgorithm::wavetable;
+        }
+        else if (frequency < 40.0f)
         {
-            sawA = oscillatorA.nextNaiveSample();
-            sawB = oscillatorB.nextNaiveSample();
+            algorithm = OscillatorAlgorithm::naive;
         }
         else if (frequency < 1000.f)
         {
-            sawA = oscillatorA.nextPolyBLEPSample();
-            sawB = oscillatorB.nextPolyBLEPSample();
+            algorithm = OscillatorAlgorithm::polyBLEP;
         }
         else
         {
-            sawA = oscillatorA.nextFourierSample();
-            sawB = oscillatorB.nextFourierSample();
+            algorithm = OscillatorAlgorithm::fourier;
+        }
+    }
+    
+    // Returns the number of samples the voice stays audible for, counting
+    // the sample on which the envelope falls silent.
+    int renderEnvelope(SampleType* destination, int sampleCount)
+    {
+        for (int i = 0; i < sampleCount; ++i)
+        {
+            destination[i] = envelope.nextValue();
+            if (!envelope.isActive())
+            {
+                return i + 1;
+            }
+        }
+        return sampleCount;
+    }
+    
+    template <OscillatorAlgorithm oscillatorAlgorithm, bool withNoise>
+    void renderBlock(SampleType* destination, const SampleType* envelopeLevels, const SampleType* noise, int sampleCount)
+    {
+        for (int i = 0; i < sampleCount; ++i)
+        {
+            SampleType sawA, sawB;
+            if constexpr (oscillatorAlgorithm == OscillatorAlgorithm::naive)
+            {
+                sawA = oscillatorA.nextNaiveSample();
+                sawB = oscillatorB.nextNaiveSample();
+            }
+            else if constexpr (oscillatorAlgorithm == OscillatorAlgorithm::polyBLEP)
+            {
+                sawA = oscillatorA.nextPolyBLEPSample();
+                sawB = oscillatorB.nextPolyBLEPSample();
+            }
+            else if constexpr (oscillatorAlgorithm == OscillatorAlgorithm::fourier)
+            {
+                sawA = oscillatorA.nextFourierSample();
+                sawB = oscillatorB.nextFourierSample();
+            }
+            else if constexpr (oscillatorAlgorithm == OscillatorAlgorithm::wavetable)
+            {
+                sawA = oscillatorA.nextWavetableSample();
+                sawB = oscillatorB.nextWavetableSample();
+            }
+            else
+            {
+                sawA = oscillatorA.nextAdditiveSample();
+                sawB = oscillatorB.nextAdditiveSample();
+            }
+            
+            SampleType input = sawA + sawB;
+            if constexpr (withNoise)
+            {
+                input += noise[i] * noiseGain;
+            }
+            destination[i] = filter.render(input) * envelopeLevels[i];
         }
-        return filter.render(sawA + sawB + (noise * (velocity / 127.0f))) * envelope.nextValue();
     }
     
-    void updatePanning()
+    // Note-on, after the oscillators are reset.
+    void startPartials(const PartialShape& shape, SampleType sampleRate)
+    {
+        partialsA->start(shape, sampleRate);
+        partialsB->start(shape, sampleRate);
+    }
+    
+    void updatePanning(int note)
+    {
+        panLeft = LookupTables::notePanning<SampleType>.left[size_t(note)];
+        panRight = LookupTables::notePanning<SampleType>.right[size_t(note)];
+    }
+    
+    // The mod matrix's pan and level: a position from -1 (left) to 1
+    // (right) with the same law as the note panning, and a gain on top.
+    void setPanning(SampleType position, SampleType gain)
     {
-        float panning = std::clamp((note - 60.0f) / 96.0f, -0.3f, 0.3f);
-        panLeft = std::sin(PI_OVER_4 * (1.0f - panning));
-        panRight = std::sin(PI_OVER_4 * (1.0f + panning));
+        position = std::clamp(position, SampleType(-1), SampleType(1));
+        panLeft = gain * std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f - position));
+        panRight = gain * std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f + position));
     }
+};
+
+// The per-voice state that only changes at note events and control ticks.
+template <typename SampleType = float>
+struct VoiceControl
+{
+    int note = 0;
+    int velocity = 0;
+    int part = 0;
+    SampleType frequency = 0;
+    SampleType cutoff = 0;
+    SampleType filterQ = 0;
+    SampleType pitchBend = 1;
+    SampleType filterEnvDepth = 0;
+    Envelope<SampleType> filterEnv;
     
-    void updateLFO()
+    // Mod matrix state: the key as a bipolar value around middle C, the
+    // note's pan position, the pitch factors currently applied to the
+    // oscillators, the offset on the oscillator mix and the log-time the
+    // envelopes are stretched by.
+    SampleType key = 0;
+    SampleType panning = 0;
+    SampleType pitchMod = 1;
+    SampleType oscBPitchMod = 1;
+    SampleType oscMixMod = 0;
+    SampleType envelopeTimeMod = 0;
+    
+    void reset()
     {
-        float fenv = filterEnv.nextValue();
-        float modulatedCutoff = cutoff * std::exp(filterMod + filterEnvDepth * fenv) / pitchBend;
-        modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
-        filter.updateCoefficients(modulatedCutoff, filterQ);
+        note = 0;
+        filterEnv.reset();
+        pitchMod = 1;
+        oscBPitchMod = 1;
+        oscMixMod = 0;
+        envelopeTimeMod = 0;
     }
 };
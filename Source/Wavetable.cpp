@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    Wavetable.cpp
+    Created: 18 Oct 2026 4:12:09pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "Wavetable.h"
+#include "SharedTables.h"
+
+namespace
+{
+    struct CacheHeader
+    {
+        char magic[4];
+        int32_t frameSize;
+        int32_t numLevels;
+        int32_t numFrames;
+    };
+
+    constexpr char cacheMagic[4] = { 'S', 'S', 'W', 'T' };
+
+    juce::File getCacheDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("SubSynth Wavetables");
+    }
+
+    bool readFrames(const juce::File& file, juce::AudioBuffer<float>& frames)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+        {
+            return false;
+        }
+
+        const int length = int(std::min<juce::int64>(reader->lengthInSamples, juce::int64(Wavetable::frameSize) * Wavetable::maxFrames));
+        const int numChannels = int(reader->numChannels);
+        juce::AudioBuffer<float> source(numChannels, length);
+        reader->read(&source, 0, length, 0, true, numChannels > 1);
+
+        // Channels are mixed to mono.
+        for (int channel = 1; channel < numChannels; ++channel)
+        {
+            source.addFrom(0, 0, source, channel, 0, length);
+        }
+        source.applyGain(0, 0, length, 1.0f / float(numChannels));
+        const float* input = source.getReadPointer(0);
+
+        if (length < Wavetable::frameSize)
+        {
+            // A single cycle of any length, stretched to one frame.
+            frames.setSize(1, Wavetable::frameSize);
+            float* frame = frames.getWritePointer(0);
+            for (int i = 0; i < Wavetable::frameSize; ++i)
+            {
+                const double position = double(i) * length / Wavetable::frameSize;
+                const int index = int(position);
+                const float fraction = float(position - index);
+                frame[i] = input[index] + fraction * (input[(index + 1) % length] - input[index]);
+            }
+            return true;
+        }
+
+        const int numFrames = length / Wavetable::frameSize;
+        frames.setSize(numFrames, Wavetable::frameSize);
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            frames.copyFrom(frame, 0, input + frame * Wavetable::frameSize, Wavetable::frameSize);
+        }
+        return true;
+    }
+}
+
+std::shared_ptr<const Wavetable> Wavetable::load(const juce::File& file)
+{
+    // Engines loading the same file while it is still in use share it.
+    const juce::String key = SharedTables::getFileKey(file);
+    return SharedTables::get<Wavetable>(key, 0.0, 0, [&file, &key]
+    {
+        return build(file, key);
+    });
+}
+
+std::shared_ptr<const Wavetable> Wavetable::build(const juce::File& file, const juce::String& key)
+{
+    const juce::File cacheFile = getCacheDirectory().getChildFile(juce::String::toHexString(key.hashCode64()) + ".wtc");
+
+    std::shared_ptr<Wavetable> table = createFromCache(cacheFile, 0);
+    if (table == nullptr)
+    {
+        juce::AudioBuffer<float> frames;
+        if (!file.existsAsFile() || !readFrames(file, frames))
+        {
+            return nullptr;
+        }
+
+        const int numFrames = frames.getNumChannels();
+        const size_t numSamples = size_t(numFrames) * numLevels * levelSize;
+        juce::HeapBlock<float> mipMaps(numSamples);
+        buildMipMaps(frames, mipMaps.get());
+
+        // Written under a temporary name and moved into place, so another
+        // process never maps a half-written file.
+        const CacheHeader header { { cacheMagic[0], cacheMagic[1], cacheMagic[2], cacheMagic[3] },
+                                   frameSize, numLevels, numFrames };
+        getCacheDirectory().createDirectory();
+        juce::TemporaryFile temporary(cacheFile);
+        bool written = false;
+        {
+            juce::FileOutputStream stream(temporary.getFile());
+            written = stream.openedOk()
+                   && stream.write(&header, sizeof(header))
+                   && stream.write(mipMaps.get(), numSamples * sizeof(float));
+        }
+        if (written && temporary.overwriteTargetFileWithTemporary())
+        {
+            table = createFromCache(cacheFile, numFrames);
+        }
+
+        // Without a writable cache the table just lives on the heap.
+        if (table == nullptr)
+        {
+            table.reset(new Wavetable());
+            table->numFrames = numFrames;
+            table->memory = std::move(mipMaps);
+            table->samples = table->memory.get();
+        }
+    }
+
+    return table;
+}
+
+std::shared_ptr<Wavetable> Wavetable::createFromCache(const juce::File& cacheFile, int numFrames)
+{
+    if (!cacheFile.existsAsFile())
+    {
+        return nullptr;
+    }
+
+    auto mappedFile = std::make_unique<juce::MemoryMappedFile>(cacheFile, juce::MemoryMappedFile::readOnly);
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < sizeof(CacheHeader))
+    {
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, mappedFile->getData(), sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0
+        || header.frameSize != frameSize || header.numLevels != numLevels
+        || header.numFrames < 1 || header.numFrames > maxFrames
+        || (numFrames != 0 && header.numFrames != numFrames)
+        || mappedFile->getSize() != sizeof(header) + size_t(header.numFrames) * numLevels * levelSize * sizeof(float))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Wavetable> table(new Wavetable());
+    table->numFrames = header.numFrames;
+    table->samples = reinterpret_cast<const float*>(static_cast<const char*>(mappedFile->getData()) + sizeof(header));
+    table->mappedFile = std::move(mappedFile);
+    return table;
+}
+
+void Wavetable::buildMipMaps(const juce::AudioBuffer<float>& frames, float* destination)
+{
+    juce::dsp::FFT fft(frameOrder);
+    std::vector<float> spectrum(size_t(2 * frameSize));
+    std::vector<float> level(size_t(2 * frameSize));
+
+    for (int frame = 0; frame < frames.getNumChannels(); ++frame)
+    {
+        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+        std::copy_n(frames.getReadPointer(frame), frameSize, spectrum.begin());
+        fft.performRealOnlyForwardTransform(spectrum.data(), true);
+
+        // No DC: a table with an offset would thump at every note-on.
+        spectrum[0] = 0.0f;
+        spectrum[1] = 0.0f;
+
+        for (int l = 0; l < numLevels; ++l)
+        {
+            const int highestHarmonic = frameSize >> (l + 1);
+            std::fill(level.begin(), level.end(), 0.0f);
+            std::copy_n(spectrum.begin(), size_t(2 * (highestHarmonic + 1)), level.begin());
+            fft.performRealOnlyInverseTransform(level.data());
+
+            float* samples = destination + (size_t(frame) * numLevels + size_t(l)) * levelSize;
+            std::copy_n(level.begin(), frameSize, samples);
+            samples[frameSize] = samples[0];
+        }
+    }
+
+    // One gain for the whole table, so morphing between frames keeps their
+    // relative levels.
+    const size_t numSamples = size_t(frames.getNumChannels()) * numLevels * levelSize;
+    float peak = 0.0f;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        peak = std::max(peak, std::abs(destination[i]));
+    }
+    if (peak > 0.0f)
+    {
+        juce::FloatVectorOperations::multiply(destination, 1.0f / peak, int(numSamples));
+    }
+}
+
+WavetableSlot::WavetableSlot()
+    : state(std::make_shared<State>())
+{
+}
+
+void WavetableSlot::load(const juce::File& newFile)
+{
+    file = newFile;
+    const uint32_t request = ++state->latestRequest;
+
+    if (file == juce::File())
+    {
+        state->holders.publish(std::make_unique<Holder>());
+        return;
+    }
+
+    std::weak_ptr<State> weakState = state;
+    SharedTables::getLoaderPool().addJob([weakState, request, loadFile = file]
+    {
+        auto table = Wavetable::load(loadFile);
+        if (auto loaderState = weakState.lock())
+        {
+            // A newer load has been asked for; this one is stale.
+            if (loaderState->latestRequest.load() == request)
+            {
+                loaderState->holders.publish(std::make_unique<Holder>(Holder { std::move(table) }));
+            }
+        }
+    });
+}
+
+void WavetableSlot::collectGarbage()
+{
+    state->holders.collectGarbage();
+}
+
+const Wavetable* WavetableSlot::acquire()
+{
+    // As with the mod matrix, the swap waits a block while the previous
+    // table has not been collected yet.
+    const Holder* active = state->holders.acquire();
+    return active != nullptr ? active->table.get() : nullptr;
+}
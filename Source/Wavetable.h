@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    Wavetable.h
+    Created: 18 Oct 2026 4:12:09pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Handoff.h"
+
+// A multi-frame wavetable, band-limited for playback. Every frame is stored
+// as a chain of mip-map levels; level L keeps the harmonics up to
+// frameSize / 2^(L + 1), which is alias-free for phase increments up to
+// 2^L / frameSize. Levels carry one guard sample so that playback can
+// interpolate without wrapping. Tables are immutable once built and shared
+// by every engine in the process that loads the same file.
+class Wavetable
+{
+public:
+    static constexpr int frameSize = 2048;
+    static constexpr int frameOrder = 11;
+    static constexpr int numLevels = 11;
+    static constexpr int levelSize = frameSize + 1;
+    static constexpr int maxFrames = 256;
+
+    int getNumFrames() const { return numFrames; }
+
+    const float* getLevel(int frame, int level) const
+    {
+        return samples + (size_t(frame) * numLevels + size_t(level)) * levelSize;
+    }
+
+    // The level to play at a phase increment given in cycles per sample.
+    static int levelForIncrement(double increment)
+    {
+        const double harmonicsToNyquist = increment * frameSize;
+        if (harmonicsToNyquist <= 1.0)
+        {
+            return 0;
+        }
+        return std::min(int(std::ceil(std::log2(harmonicsToNyquist))), numLevels - 1);
+    }
+
+    // Reads a WAV (or any format JUCE reads) of consecutive frameSize-sample
+    // frames; a shorter file is taken as a single cycle. The mip-maps are
+    // cached on disk and memory-mapped, so a second process loading the same
+    // file shares its pages. Blocks for as long as the FFTs take: call it
+    // from a background thread. Returns nullptr if the file cannot be read.
+    static std::shared_ptr<const Wavetable> load(const juce::File& file);
+
+private:
+    Wavetable() = default;
+
+    // Reads the file, or its cache named after key, for load().
+    static std::shared_ptr<const Wavetable> build(const juce::File& file, const juce::String& key);
+    static void buildMipMaps(const juce::AudioBuffer<float>& frames, float* destination);
+    static std::shared_ptr<Wavetable> createFromCache(const juce::File& cacheFile, int numFrames);
+
+    int numFrames = 0;
+    const float* samples = nullptr;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    juce::HeapBlock<float> memory;
+
+    JUCE_DECLARE_NON_COPYABLE(Wavetable)
+};
+
+// Hands wavetables from the loader thread to one engine. Like ModMatrix,
+// the audio thread picks the newest table up with acquire() at the start of
+// a block, and tables are only ever released off the audio thread.
+class WavetableSlot
+{
+public:
+    WavetableSlot();
+
+    // Message thread. Loading and mip-mapping run on a shared background
+    // thread; a default-constructed File switches back to the saw
+    // oscillators. Of several loads in flight only the last one is kept.
+    void load(const juce::File& file);
+    juce::File getFile() const { return file; }
+
+    // Message thread. Releases the table the audio thread has let go of.
+    void collectGarbage();
+
+    // Audio thread. Returns nullptr while no table is loaded.
+    const Wavetable* acquire();
+
+private:
+    struct Holder
+    {
+        std::shared_ptr<const Wavetable> table;
+    };
+
+    // Shared with the loader jobs, so that a job finishing after the
+    // engine is gone has somewhere harmless to publish to.
+    struct State
+    {
+        Handoff<Holder> holders;
+        std::atomic<uint32_t> latestRequest { 0 };
+    };
+
+    std::shared_ptr<State> state;
+    juce::File file;
+
+    JUCE_DECLARE_NON_COPYABLE(WavetableSlot)
+};
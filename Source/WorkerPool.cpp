@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    WorkerPool.cpp
+    Created: 18 Oct 2026 11:12:08pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "WorkerPool.h"
+
+namespace
+{
+    int getNext(uint64_t claim) { return int(claim & 0xFFFF); }
+    int getCount(uint64_t claim) { return int((claim >> 16) & 0xFFFF); }
+}
+
+// The host's audio threads need cores too, so one is left to them.
+WorkerPool::WorkerPool()
+    : WorkerPool(juce::SystemStats::getNumCpus() - 1)
+{
+}
+
+WorkerPool::WorkerPool(int numWorkers)
+{
+    numWorkers = std::clamp(numWorkers, 0, maxWorkers);
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+    }
+    for (auto& worker : workers)
+    {
+        worker->startRealtimeThread(juce::Thread::RealtimeOptions());
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wakeUp.signal();
+    }
+    for (auto& worker : workers)
+    {
+        worker->stopThread(1000);
+    }
+}
+
+void WorkerPool::run(Batch& batch, int numTasks)
+{
+    if (numTasks <= 0)
+    {
+        return;
+    }
+
+    Slot* slot = nullptr;
+    if (!workers.empty() && numTasks > 1 && numTasks <= maxTasks)
+    {
+        for (Slot& candidate : slots)
+        {
+            bool expected = false;
+            if (!candidate.taken.load(std::memory_order_relaxed)
+                && candidate.taken.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                slot = &candidate;
+                break;
+            }
+        }
+    }
+
+    // Without workers, or with every slot in use, the batch simply runs here.
+    if (slot == nullptr)
+    {
+        for (int i = 0; i < numTasks; ++i)
+        {
+            batch.runTask(i);
+        }
+        return;
+    }
+
+    slot->batch = &batch;
+    slot->finished.store(0, std::memory_order_relaxed);
+    const uint64_t generation = (slot->claim.load(std::memory_order_relaxed) >> 32) + 1;
+    slot->claim.store(generation << 32 | uint64_t(numTasks) << 16);
+
+    // Waking a sleeping worker takes a brief mutex inside WaitableEvent, as
+    // in RenderAhead; workers that are still spinning need no call at all.
+    int wanted = numTasks - 1;
+    for (auto& worker : workers)
+    {
+        if (wanted == 0)
+        {
+            break;
+        }
+        if (worker->sleeping.load())
+        {
+            SUBSYNTH_REALTIME_ALLOW;
+            worker->wakeUp.signal();
+            --wanted;
+        }
+    }
+
+    while (runTask(*slot))
+    {
+    }
+
+    const int ownSlot = int(slot - slots.data());
+    while (slot->finished.load(std::memory_order_acquire) < numTasks)
+    {
+        if (!runAnyTask(ownSlot + 1))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    slot->taken.store(false, std::memory_order_release);
+}
+
+bool WorkerPool::runTask(Slot& slot)
+{
+    uint64_t claim = slot.claim.load(std::memory_order_acquire);
+    while (getNext(claim) < getCount(claim))
+    {
+        if (slot.claim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            // The batch cannot change before this task is counted finished.
+            slot.batch->runTask(getNext(claim));
+            slot.finished.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::runAnyTask(int firstSlot)
+{
+    for (int i = 0; i < numSlots; ++i)
+    {
+        if (runTask(slots[size_t((firstSlot + i) % numSlots)]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::hasWork() const
+{
+    for (const Slot& slot : slots)
+    {
+        const uint64_t claim = slot.claim.load();
+        if (getNext(claim) < getCount(claim))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+WorkerPool::Worker::Worker(WorkerPool& pool, int index)
+    : juce::Thread("SubSynth worker"), pool(pool), firstSlot(index * numSlots / maxWorkers)
+{
+}
+
+void WorkerPool::Worker::run()
+{
+    const auto spinTicks = juce::int64(spinSeconds * double(juce::Time::getHighResolutionTicksPerSecond()));
+
+    while (!threadShouldExit())
+    {
+        SUBSYNTH_REALTIME_SCOPE;
+        auto lastTask = juce::Time::getHighResolutionTicks();
+        while (!threadShouldExit())
+        {
+            if (pool.runAnyTask(firstSlot))
+            {
+                pool.workerTasks.fetch_add(1, std::memory_order_relaxed);
+                lastTask = juce::Time::getHighResolutionTicks();
+            }
+            else if (juce::Time::getHighResolutionTicks() - lastTask > spinTicks)
+            {
+                break;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Announced before looking for work one last time, and run()
+        // publishes before it looks for sleepers, so no batch goes unseen.
+        sleeping.store(true);
+        if (!pool.hasWork())
+        {
+            SUBSYNTH_REALTIME_ALLOW;
+            wakeUp.wait(100);
+        }
+        sleeping.store(false);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    WorkerPool.h
+    Created: 18 Oct 2026 11:12:08pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RealtimeAudit.h"
+
+// One set of real-time worker threads for every SubSynth instance in the
+// process, so any number of instances share the spare cores instead of
+// each one starting threads of its own. Hold it through a
+// juce::SharedResourcePointer: the workers start with the first holder and
+// stop with the last.
+//
+// Work comes in batches of independent tasks that an audio thread submits
+// with run(). Nothing on that path allocates or takes a lock: the batch is
+// published into a fixed table of slots, and every task is claimed with a
+// compare-and-swap by whichever thread gets to it first. The submitting
+// thread claims its own tasks as well, so a batch finishes even when every
+// worker is busy or asleep; it only ever waits for tasks a worker has
+// already started. While it waits it runs other instances' tasks and
+// otherwise yields. That wait is not bounded: a worker that the OS
+// preempts in the middle of a task holds the batch up until it runs again.
+class WorkerPool
+{
+public:
+    class Batch
+    {
+    public:
+        virtual ~Batch() = default;
+
+        // Called once for every index below the task count, on any thread
+        // and in any order.
+        virtual void runTask(int index) = 0;
+    };
+
+    static constexpr int maxWorkers = 8;
+    static constexpr int maxTasks = 0xFFFF;
+
+    // One worker per core but one, as SharedResourcePointer builds it.
+    WorkerPool();
+    explicit WorkerPool(int numWorkers);
+    ~WorkerPool();
+
+    // Audio thread. Returns once every task has run.
+    void run(Batch& batch, int numTasks);
+
+    int getNumWorkers() const { return int(workers.size()); }
+
+    // Tasks run by the workers rather than by the thread that submitted them.
+    juce::int64 getWorkerTaskCount() const { return workerTasks.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int numSlots = 64;
+
+    // A worker that found nothing to do for this long goes to sleep until
+    // a batch wakes it. Within a host block the segments come back to back,
+    // so the workers mostly stay awake through a block.
+    static constexpr double spinSeconds = 0.0005;
+
+    struct alignas(64) Slot
+    {
+        // The generation, the number of tasks and the next task to claim,
+        // in one word so a claim cannot land in a batch that replaced the
+        // one it was meant for: generation << 32 | tasks << 16 | next.
+        std::atomic<uint64_t> claim { 0 };
+        std::atomic<int> finished { 0 };
+        std::atomic<bool> taken { false };
+        Batch* batch = nullptr;
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(WorkerPool& pool, int index);
+        void run() override;
+
+        juce::WaitableEvent wakeUp;
+        std::atomic<bool> sleeping { false };
+
+    private:
+        WorkerPool& pool;
+        int firstSlot;
+    };
+
+    // Claims and runs one task of the slot; false if none was left.
+    bool runTask(Slot& slot);
+
+    // One task from any slot, searching from the given one on.
+    bool runAnyTask(int firstSlot);
+    bool hasWork() const;
+
+    std::array<Slot, numSlots> slots;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<juce::int64> workerTasks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(WorkerPool)
+};
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 6:02:44pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <JuceHeader.h>
+#include "../Source/StressHarness.h"
+
+// Runs the MIDI stress patterns against the plugin processor and prints the
+// block times, through the float and the double engine side by side.
+//
+//     SubSynthStress [--seconds <s>] [--rate <hz>] [--block-sizes 64,256,...]
+//                    [--precision float|double|both]
+//                    [--baseline <file> [--tolerance <ratio>]] [--write-baseline <file>]
+//
+// With --baseline it exits non-zero if a pattern got more expensive next to
+// the steady chord than the baseline allows (by default 1.25 times), or if
+// a block made a blocking call, which the project's SUBSYNTH_REALTIME_AUDIT
+// define catches on Linux. --write-baseline saves this run's ratios for the
+// next build to be gated against.
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juce;
+    const juce::File workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+    double seconds = 10.0;
+    double sampleRate = 48000.0;
+    std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048 };
+    double tolerance = 1.25;
+    juce::String precision = "both";
+    juce::File baselineFile;
+    juce::File outputFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--seconds" && hasValue)
+        {
+            seconds = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--rate" && hasValue)
+        {
+            sampleRate = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--block-sizes" && hasValue)
+        {
+            blockSizes.clear();
+            for (const auto& size : juce::StringArray::fromTokens(argv[++i], ",", ""))
+            {
+                blockSizes.push_back(size.getIntValue());
+            }
+        }
+        else if (argument == "--precision" && hasValue)
+        {
+            precision = argv[++i];
+        }
+        else if (argument == "--baseline" && hasValue)
+        {
+            baselineFile = workingDirectory.getChildFile(argv[++i]);
+        }
+        else if (argument == "--tolerance" && hasValue)
+        {
+            tolerance = juce::String(argv[++i]).getDoubleValue();
+        }
+        else if (argument == "--write-baseline" && hasValue)
+        {
+            outputFile = workingDirectory.getChildFile(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "usage: SubSynthStress [--seconds <s>] [--rate <hz>] [--block-sizes 64,256,...]"
+                      << " [--precision float|double|both]"
+                      << " [--baseline <file> [--tolerance <ratio>]] [--write-baseline <file>]" << std::endl;
+            return 2;
+        }
+    }
+
+    if (seconds <= 0.0 || sampleRate <= 0.0 || tolerance <= 0.0 || blockSizes.empty()
+        || std::any_of(blockSizes.begin(), blockSizes.end(), [](int size) { return size <= 0; }))
+    {
+        std::cerr << "SubSynthStress: seconds, rate, tolerance and block sizes must be positive" << std::endl;
+        return 2;
+    }
+    if (precision != "float" && precision != "double" && precision != "both")
+    {
+        std::cerr << "SubSynthStress: precision must be float, double or both" << std::endl;
+        return 2;
+    }
+
+    std::vector<StressHarness::Result> floatResults;
+    std::vector<StressHarness::Result> doubleResults;
+    if (precision != "double")
+    {
+        floatResults = StressHarness::runAll<float>(sampleRate, blockSizes, seconds);
+    }
+    if (precision != "float")
+    {
+        doubleResults = StressHarness::runAll<double>(sampleRate, blockSizes, seconds);
+    }
+
+    auto results = floatResults;
+    results.insert(results.end(), doubleResults.begin(), doubleResults.end());
+    std::cout << StressHarness::formatReport(results);
+    if (!floatResults.empty() && !doubleResults.empty())
+    {
+        std::cout << "\n" << StressHarness::formatComparison(floatResults, doubleResults);
+    }
+    std::cout << std::flush;
+
+    if (outputFile != juce::File() && !outputFile.replaceWithText(StressHarness::formatBaseline(results)))
+    {
+        std::cerr << "SubSynthStress: could not write " << outputFile.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    if (baselineFile != juce::File())
+    {
+        if (!baselineFile.existsAsFile())
+        {
+            std::cerr << "SubSynthStress: no baseline at " << baselineFile.getFullPathName() << std::endl;
+            return 2;
+        }
+
+        juce::StringArray failures;
+        if (!StressHarness::meetsBaseline(results, baselineFile.loadFileAsString(), tolerance, failures))
+        {
+            for (const auto& failure : failures)
+            {
+                std::cerr << failure << std::endl;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
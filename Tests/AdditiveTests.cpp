@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    AdditiveTests.cpp
+    Created: 19 Oct 2026 8:47:20pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class AdditiveTests : public juce::UnitTest
+{
+public:
+    AdditiveTests() : juce::UnitTest("Additive oscillator", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("The additive saw tracks the Fourier saw over ten seconds");
+        {
+            // A high note with few partials below Nyquist, and a low one
+            // with nearly every partial the bank has.
+            for (const float frequency : { 1760.0f, 380.0f })
+            {
+                const double error = measureError(frequency);
+                logMessage(juce::String(frequency) + " Hz: max abs error " + juce::String(error));
+                expectLessThan(error, 1.0e-4);
+            }
+        }
+
+        beginTest("Only an additive engine carries partial banks");
+        {
+            SynthParameters parameters;
+            parameters.partials = 32.0f;
+            Synth<float> saws;
+            Synth<float> additive;
+            additive.additive = true;
+            const auto sawOutput = renderNote(saws, parameters);
+            const auto additiveOutput = renderNote(additive, parameters);
+
+            expectEquals(additive.getMemoryFootprint() - saws.getMemoryFootprint(),
+                         size_t(2 * additive.getVoiceCount()) * sizeof(PartialBank<float>));
+            expect(sizeof(Voice<float>) < sizeof(PartialBank<float>));
+
+            // Without banks the part falls back to the saws.
+            float difference = 0.0f;
+            for (size_t i = 0; i < sawOutput.size(); ++i)
+            {
+                difference = std::max(difference, std::abs(sawOutput[i] - additiveOutput[i]));
+            }
+            expect(difference > 0.01f);
+        }
+    }
+
+private:
+    static constexpr float sampleRate = 48000.0f;
+    static constexpr int controlInterval = 32;
+
+    static std::vector<float> renderNote(Synth<float>& synth, const SynthParameters& parameters)
+    {
+        const int blockSize = 256;
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        parameters.applyTo(synth, sampleRate, 0);
+        synth.midiMessage(0x90, 57, 100);
+
+        std::vector<float> output;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int block = 0; block < 40; ++block)
+        {
+            buffer.clear();
+            synth.render(buffer, 0, blockSize, 2);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+        }
+        return output;
+    }
+
+    // Both oscillators get the frequency once per control interval, as in
+    // the engine, and share the saw amplitudes and the partials below
+    // Nyquist.
+    double measureError(float frequency)
+    {
+        PartialShape shape;
+        shape.count = PartialBank<float>::maxPartials;
+        auto bank = std::make_unique<PartialBank<float>>();
+        bank->start(shape, sampleRate);
+
+        Oscillator<float> additive, fourier;
+        for (Oscillator<float>* oscillator : { &additive, &fourier })
+        {
+            oscillator->setSampleRate(sampleRate);
+            oscillator->reset();
+            oscillator->amplitude = 1.0f;
+        }
+        additive.setPartials(bank.get());
+        expect(int(std::ceil(0.5f * sampleRate / frequency)) - 1 <= PartialBank<float>::maxPartials);
+
+        double maxError = 0.0;
+        const int numSamples = int(10.0f * sampleRate);
+        for (int n = 0; n < numSamples; ++n)
+        {
+            if (n % controlInterval == 0)
+            {
+                additive.setFrequency(frequency);
+                fourier.setFrequency(frequency);
+            }
+            const float expected = fourier.nextFourierSample();
+            maxError = std::max(maxError, std::abs(double(additive.nextAdditiveSample()) - double(expected)));
+        }
+        return maxError;
+    }
+};
+
+static AdditiveTests additiveTests;
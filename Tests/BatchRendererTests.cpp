@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    BatchRendererTests.cpp
+    Created: 19 Oct 2026 10:21:36pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/BatchRenderer.h"
+
+class BatchRendererTests : public juce::UnitTest
+{
+public:
+    BatchRendererTests() : juce::UnitTest("Batch renderer", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A reused engine renders what a fresh one does");
+        {
+            // Very different cutoffs, so a render that ramps from the last
+            // one's filter instead of from idle shows up.
+            BatchRenderer::Sweep sweep;
+            sweep.patches = BatchRenderer::makeGrid(SynthParameters(),
+                                                    { { &SynthParameters::filterFreq, { 100.0f, 0.0f, 60.0f } } });
+            sweep.notes = { 48, 72 };
+            sweep.velocities = { 100 };
+            sweep.noteSeconds = 0.1;
+            sweep.releaseSeconds = 0.05;
+
+            const juce::TemporaryFile temporary(".ssbr");
+            juce::String error;
+            expect(BatchRenderer::run(sweep, temporary.getFile(), error, 1), error);
+
+            juce::MemoryBlock data;
+            expect(temporary.getFile().loadFileAsData(data));
+            const int renderLength = sweep.getRenderLength();
+            const int64_t renderSize = int64_t(sweep.numChannels) * renderLength;
+            expectEquals(int64_t(data.getSize()),
+                         BatchRenderer::FileHeader::size + sweep.getNumRenders() * renderSize * int64_t(sizeof(float)));
+
+            juce::AudioBuffer<float> expected(sweep.numChannels, renderLength);
+            float difference = 0.0f;
+            for (int patch = 0; patch < int(sweep.patches.size()); ++patch)
+            {
+                for (int note = 0; note < int(sweep.notes.size()); ++note)
+                {
+                    BatchRenderer::renderOne(sweep, patch, note, 0, expected.getArrayOfWritePointers());
+                    const auto* rendered = reinterpret_cast<const float*>(static_cast<const char*>(data.getData())
+                                                                          + BatchRenderer::FileHeader::size)
+                                         + sweep.getRenderIndex(patch, note, 0) * renderSize;
+                    for (int channel = 0; channel < sweep.numChannels; ++channel)
+                    {
+                        for (int sample = 0; sample < renderLength; ++sample)
+                        {
+                            difference = std::max(difference, std::abs(rendered[int64_t(channel) * renderLength + sample]
+                                                                       - expected.getSample(channel, sample)));
+                        }
+                    }
+                }
+            }
+            expectEquals(difference, 0.0f);
+        }
+    }
+};
+
+static BatchRendererTests batchRendererTests;
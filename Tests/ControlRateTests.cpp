@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    ControlRateTests.cpp
+    Created: 19 Oct 2026 10:22:36am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "EquivalenceHarness.h"
+#include "../Source/Filter.h"
+
+class ControlRateTests : public juce::UnitTest
+{
+public:
+    ControlRateTests() : juce::UnitTest("Control rate", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A filter ramp ends on the next tick");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int controlInterval = 24;
+
+            // With silence going in the state stays at zero, so only the
+            // ramps move. Once the ramp is done the filter must behave as
+            // one that jumped straight to the new coefficients.
+            Filter<float> ramped;
+            Filter<float> jumped;
+            ramped.prepare(sampleRate, controlInterval);
+            jumped.prepare(sampleRate, 0);
+            ramped.updateCoefficients(3000.0f, 12.0f);
+            jumped.updateCoefficients(3000.0f, 12.0f);
+            for (int i = 0; i < controlInterval; ++i)
+            {
+                ramped.render(0.0f);
+                jumped.render(0.0f);
+            }
+
+            float error = 0.0f;
+            for (int i = 0; i < 256; ++i)
+            {
+                const float x = std::sin(0.05f * float(i));
+                error = std::max(error, std::abs(ramped.render(x) - jumped.render(x)));
+            }
+            expectEquals(error, 0.0f);
+        }
+
+        beginTest("The engine ramps the filter over one control interval by default");
+        {
+            EquivalenceScenario scenario;
+            for (const auto& s : EquivalenceHarness::createDefaultScenarios())
+            {
+                if (s.name == "filter-lfo-0.5ms")
+                {
+                    scenario = s;
+                }
+            }
+            expect(scenario.name.isNotEmpty());
+
+            // At 48 kHz a 0.5 ms tick is 24 samples, and so is 0.5 ms of
+            // smoothing.
+            scenario.filterSmoothingMs = Synth<float>().filterSmoothingMs;
+            auto byDefault = EquivalenceHarness::render(scenario);
+            scenario.filterSmoothingMs = scenario.controlIntervalMs;
+            auto oneTick = EquivalenceHarness::render(scenario);
+            scenario.filterSmoothingMs = 50.0f;
+            auto ladderSmoothing = EquivalenceHarness::render(scenario);
+
+            expectEquals(EquivalenceHarness::maxAbsError(byDefault, oneTick), 0.0f);
+            expectGreaterThan(EquivalenceHarness::maxAbsError(byDefault, ladderSmoothing), 1.0e-3f);
+        }
+    }
+};
+
+static ControlRateTests controlRateTests;
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    EngineApiTests.cpp
+    Created: 20 Oct 2026 1:52:09am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "EngineClient.h"
+#include "../Source/SubSynthEngine.h"
+#include "../Source/SynthParameters.h"
+#include "../Source/RealtimeAudit.h"
+
+class EngineApiTests : public juce::UnitTest
+{
+public:
+    EngineApiTests() : juce::UnitTest("Engine C API", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A C client renders what the engine driven directly does");
+        {
+            const int auditBefore = RealtimeAudit::getViolationCount();
+            juce::AudioBuffer<float> client(2, numSamples);
+            expectEquals(engine_client_render(sampleRate, blockSize, numSamples,
+                                              client.getWritePointer(0), client.getWritePointer(1)), 0);
+            expectEquals(RealtimeAudit::getViolationCount(), auditBefore);
+
+            // The same events in sample order, split at each one as the
+            // plugin does.
+            Synth<float> synth;
+            synth.subBlockSize = 64;
+            synth.allocateResources(sampleRate, blockSize);
+            synth.reset();
+            SynthParameters parameters;
+            parameters.filterFreq = ENGINE_CLIENT_FILTER_FREQ;
+            parameters.filterReso = ENGINE_CLIENT_FILTER_RESO;
+            parameters.applyTo(synth, sampleRate, 0);
+
+            std::vector<EngineClientEvent> events(engine_client_events, engine_client_events + ENGINE_CLIENT_NUM_EVENTS);
+            std::stable_sort(events.begin(), events.end(),
+                             [](const EngineClientEvent& a, const EngineClientEvent& b) { return a.sample < b.sample; });
+
+            juce::AudioBuffer<float> direct(2, numSamples);
+            direct.clear();
+            size_t next = 0;
+            for (int position = 0; position < numSamples;)
+            {
+                while (next < events.size() && events[next].sample == position)
+                {
+                    synth.midiMessage(events[next].data[0], events[next].data[1], events[next].data[2]);
+                    ++next;
+                }
+                int end = std::min(position + blockSize - position % blockSize, numSamples);
+                if (next < events.size())
+                {
+                    end = std::min(end, events[next].sample);
+                }
+                synth.render(direct, position, end - position, 2);
+                position = end;
+            }
+
+            float difference = 0.0f;
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    difference = std::max(difference, std::abs(client.getSample(channel, sample)
+                                                               - direct.getSample(channel, sample)));
+                }
+            }
+            expectEquals(difference, 0.0f);
+            expect(direct.getMagnitude(0, numSamples) > 0.01f);
+        }
+
+        beginTest("Parameters are kept to the plugin's ranges and steps");
+        {
+            SubSynthEngine* engine = subsynth_create(sampleRate, blockSize);
+            expect(engine != nullptr);
+
+            expectSet(engine, SUBSYNTH_PARAMETER_POLYPHONY, 1000.0f, float(Synth<float>::numVoices));
+            expectSet(engine, SUBSYNTH_PARAMETER_POLYPHONY, 0.0f, 1.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_POLYPHONY, 3.6f, 4.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_FILTER_FREQ, -5.0f, 0.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_OCTAVE, 2.6f, 2.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_OSC_TUNE, -7.4f, -7.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_LFO_RATE, 3.0f, 1.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_OUTPUT_LEVEL, 40.0f, 6.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_PARTIALS, -1.0f, 0.0f);
+            expectSet(engine, SUBSYNTH_PARAMETER_OSC_MIX, 37.25f, 37.25f);
+
+            expectEquals(int(subsynth_set_parameter(engine, 0, SUBSYNTH_PARAMETER_OSC_MIX, std::nanf(""))),
+                         int(SUBSYNTH_INVALID_ARGUMENT));
+            expectEquals(subsynth_get_parameter(engine, 0, SUBSYNTH_PARAMETER_OSC_MIX), 37.25f);
+            subsynth_destroy(engine);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numSamples = 12000;
+
+    void expectSet(SubSynthEngine* engine, SubSynthParameter parameter, float value, float expected)
+    {
+        expectEquals(int(subsynth_set_parameter(engine, 0, parameter, value)), int(SUBSYNTH_OK));
+        expectWithinAbsoluteError(subsynth_get_parameter(engine, 0, parameter), expected, 1.0e-4f,
+                                  "parameter " + juce::String(int(parameter)) + " set to " + juce::String(value));
+    }
+};
+
+static EngineApiTests engineApiTests;
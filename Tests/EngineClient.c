@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    EngineClient.c
+    Created: 20 Oct 2026 1:52:09am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <stddef.h>
+#include "EngineClient.h"
+#include "../Source/SubSynthEngine.h"
+
+const EngineClientEvent engine_client_events[ENGINE_CLIENT_NUM_EVENTS] = {
+    { 1000, { 0x90, 60, 90 } },
+    { 0, { 0x90, 48, 100 } },
+    { 9000, { 0x80, 60, 0 } },
+    { 5000, { 0x80, 48, 0 } },
+};
+
+#define CHECK(call) do { if ((call) != SUBSYNTH_OK) { result = __LINE__; goto done; } } while (0)
+
+int engine_client_render(double sampleRate, int blockSize, int numSamples, float* left, float* right)
+{
+    int result = 0;
+    int offset;
+    int i;
+
+    SubSynthEngine* engine = subsynth_create(sampleRate, blockSize);
+    if (engine == NULL || subsynth_get_api_version() < 1)
+    {
+        return __LINE__;
+    }
+
+    CHECK(subsynth_set_parameter(engine, 0, SUBSYNTH_PARAMETER_FILTER_FREQ, ENGINE_CLIENT_FILTER_FREQ));
+    CHECK(subsynth_set_parameter(engine, 0, SUBSYNTH_PARAMETER_FILTER_RESO, ENGINE_CLIENT_FILTER_RESO));
+
+    /* Events later than the first render wait in the engine's queue. */
+    for (i = 0; i < ENGINE_CLIENT_NUM_EVENTS; ++i)
+    {
+        CHECK(subsynth_push_midi(engine, engine_client_events[i].sample, engine_client_events[i].data, 3));
+    }
+
+    for (offset = 0; offset < numSamples; offset += blockSize)
+    {
+        float* outputs[2];
+        outputs[0] = left + offset;
+        outputs[1] = right + offset;
+        CHECK(subsynth_render(engine, outputs, 2, numSamples - offset < blockSize ? numSamples - offset : blockSize));
+    }
+
+done:
+    subsynth_destroy(engine);
+    return result;
+}
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    EngineClient.h
+    Created: 20 Oct 2026 1:52:09am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+    A minimal C99 program's use of the engine library, built as C so the
+    tests catch anything in SubSynthEngine.h that only compiles as C++.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The notes engine_client_render() plays, in the order it pushes them:
+   deliberately not in sample order. */
+typedef struct EngineClientEvent
+{
+    int sample;
+    unsigned char data[3];
+} EngineClientEvent;
+
+#define ENGINE_CLIENT_NUM_EVENTS 4
+extern const EngineClientEvent engine_client_events[ENGINE_CLIENT_NUM_EVENTS];
+
+/* The patch engine_client_render() sets on part 0. */
+#define ENGINE_CLIENT_FILTER_FREQ 60.0f
+#define ENGINE_CLIENT_FILTER_RESO 40.0f
+
+/* Creates an engine, sets the patch, queues every event up front and
+   renders numSamples in blocks of blockSize into left and right. Returns
+   0, or the line of the first call that failed. */
+int engine_client_render(double sampleRate, int blockSize, int numSamples, float* left, float* right);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,432 @@
+/*
+  ==============================================================================
+
+    EquivalenceHarness.cpp
+    Created: 18 Oct 2026 10:05:31am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "EquivalenceHarness.h"
+#include "ReferenceSynth.h"
+#include "../Source/RealtimeAudit.h"
+
+namespace
+{
+    // Mirrors SubSynthAudioProcessor: parameters are applied after reset()
+    // and every block is split at the MIDI event positions. An audited
+    // render runs the blocks as the audio thread would, inside a real-time
+    // scope; the frozen reference engine is never audited.
+    template <typename SampleType, typename SynthType, typename ApplyFunction>
+    juce::AudioBuffer<float> renderScenario(SynthType& synth, const EquivalenceScenario& scenario, bool audited,
+                                            ApplyFunction&& applyParameters)
+    {
+        auto events = scenario.events;
+        std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b)
+        {
+            return a.samplePosition < b.samplePosition;
+        });
+
+        juce::AudioBuffer<float> output(scenario.numChannels, scenario.lengthInSamples);
+        juce::AudioBuffer<SampleType> block(2, scenario.blockSize);
+        output.clear();
+
+        synth.allocateResources(scenario.sampleRate, scenario.blockSize);
+        synth.reset();
+        applyParameters(synth);
+
+        size_t nextEvent = 0;
+        for (int blockStart = 0; blockStart < scenario.lengthInSamples; blockStart += scenario.blockSize)
+        {
+            int blockLength = std::min(scenario.blockSize, scenario.lengthInSamples - blockStart);
+            int offset = 0;
+            block.clear();
+
+            std::optional<RealtimeAudit::Scope> realtimeScope;
+            if (audited)
+            {
+                realtimeScope.emplace();
+            }
+
+            while (nextEvent < events.size() && events[nextEvent].samplePosition < blockStart + blockLength)
+            {
+                const auto& event = events[nextEvent++];
+                int position = std::max(event.samplePosition - blockStart, 0);
+                if (position > offset)
+                {
+                    synth.render(block, offset, position - offset, scenario.numChannels);
+                    offset = position;
+                }
+                synth.midiMessage(event.data0, event.data1, event.data2);
+            }
+
+            if (offset < blockLength)
+            {
+                synth.render(block, offset, blockLength - offset, scenario.numChannels);
+            }
+            realtimeScope.reset();
+
+            for (int channel = 0; channel < scenario.numChannels; ++channel)
+            {
+                const SampleType* source = block.getReadPointer(channel);
+                float* destination = output.getWritePointer(channel, blockStart);
+                for (int i = 0; i < blockLength; ++i)
+                {
+                    destination[i] = float(source[i]);
+                }
+            }
+        }
+
+        synth.deallocateResources();
+        return output;
+    }
+
+    EquivalenceScenario::Event noteOn(int position, int note, int velocity)
+    {
+        return { position, 0x90, uint8_t(note), uint8_t(velocity) };
+    }
+
+    EquivalenceScenario::Event noteOff(int position, int note)
+    {
+        return { position, 0x80, uint8_t(note), 0 };
+    }
+
+    EquivalenceScenario::Event controlChange(int position, int controller, int value)
+    {
+        return { position, 0xB0, uint8_t(controller), uint8_t(value) };
+    }
+
+    EquivalenceScenario::Event pitchBend(int position, int value)
+    {
+        return { position, 0xE0, uint8_t(value & 0x7F), uint8_t((value >> 7) & 0x7F) };
+    }
+}
+
+std::vector<EquivalenceScenario> EquivalenceHarness::createDefaultScenarios()
+{
+    std::vector<EquivalenceScenario> scenarios;
+
+    {
+        // Below 40 Hz the voice uses the naive saw.
+        EquivalenceScenario scenario;
+        scenario.name = "naive-low-note";
+        scenario.lengthInSamples = 72000;
+        scenario.events = { noteOn(0, 24, 100), noteOff(48000, 24) };
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "polyblep-chord";
+        scenario.lengthInSamples = 60000;
+        scenario.events = { noteOn(0, 48, 90), noteOn(0, 52, 80), noteOn(113, 55, 70), noteOn(517, 60, 127),
+                            noteOff(36000, 48), noteOff(36000, 52), noteOff(36001, 55), noteOff(36002, 60) };
+        scenarios.push_back(scenario);
+    }
+    {
+        // Above 1 kHz the voice switches to the additive saw.
+        EquivalenceScenario scenario;
+        scenario.name = "fourier-high-notes";
+        scenario.parameters.oscTune = 0.0f;
+        scenario.lengthInSamples = 24000;
+        scenario.events = { noteOn(0, 96, 100), noteOn(4000, 100, 64), noteOff(16000, 96), noteOff(18000, 100) };
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "lfo-bend-modwheel";
+        scenario.parameters.vibrato = 40.0f;
+        scenario.parameters.filterLFO = 50.0f;
+        scenario.parameters.lfoRate = 0.6f;
+        scenario.lengthInSamples = 48000;
+        scenario.events = { noteOn(0, 57, 100), controlChange(2000, 0x01, 90) };
+        for (int i = 0; i < 64; ++i)
+        {
+            scenario.events.push_back(pitchBend(4000 + i * 480, 8192 + i * 120));
+        }
+        scenario.events.push_back({ 30000, 0xD0, 100, 0 });
+        scenario.events.push_back(controlChange(32000, 0x4A, 100));
+        scenario.events.push_back(controlChange(34000, 0x47, 60));
+        scenario.events.push_back(noteOff(40000, 57));
+        scenarios.push_back(scenario);
+    }
+    {
+        // Filter envelope and LFO at the plugin's default control rate, still
+        // with the reference's 50 ms filter smoothing. Pitch modulation is
+        // left out: a different tick moves the oscillator phases, which would
+        // swamp the comparison.
+        EquivalenceScenario scenario = scenarios.back();
+        scenario.name = "filter-lfo-0.5ms";
+        scenario.controlIntervalMs = 0.5f;
+        scenario.parameters.vibrato = 0.0f;
+        scenario.events = { noteOn(0, 57, 100), noteOff(40000, 57) };
+        scenario.maxAbsErrorTolerance = 0.05f;
+        scenario.spectralDifferenceTolerance = 3.0f;
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "sustain-pedal";
+        scenario.lengthInSamples = 48000;
+        scenario.events = { controlChange(0, 0x40, 127), noteOn(10, 60, 100), noteOn(2000, 64, 100),
+                            noteOff(4000, 60), noteOff(6000, 64), noteOn(8000, 60, 50),
+                            controlChange(24000, 0x40, 0) };
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "noise-velocity";
+        scenario.parameters.noise = 60.0f;
+        scenario.parameters.filterVelocity = 50.0f;
+        scenario.lengthInSamples = 36000;
+        scenario.events = { noteOn(0, 45, 20), noteOn(3000, 52, 127), noteOff(20000, 45), noteOff(22000, 52) };
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "ignore-velocity";
+        scenario.parameters.filterVelocity = -100.0f;
+        scenario.lengthInSamples = 24000;
+        scenario.events = { noteOn(0, 60, 10), noteOn(100, 67, 127), noteOff(12000, 60), noteOff(12000, 67) };
+        scenarios.push_back(scenario);
+    }
+    {
+        // More notes than voices, then All Notes Off in the middle of a block.
+        EquivalenceScenario scenario;
+        scenario.name = "voice-stealing";
+        scenario.parameters.envRelease = 60.0f;
+        scenario.lengthInSamples = 48000;
+        for (int i = 0; i < 24; ++i)
+        {
+            scenario.events.push_back(noteOn(i * 700, 36 + i * 2, 40 + i * 3));
+            scenario.events.push_back(noteOff(i * 700 + 350, 36 + i * 2));
+        }
+        scenario.events.push_back(controlChange(30123, 0x7B, 0));
+        scenarios.push_back(scenario);
+    }
+    {
+        EquivalenceScenario scenario;
+        scenario.name = "mono-small-blocks";
+        scenario.sampleRate = 44100.0;
+        scenario.blockSize = 32;
+        scenario.numChannels = 1;
+        scenario.lengthInSamples = 30000;
+        scenario.events = { noteOn(5, 62, 100), noteOn(7, 69, 90), noteOff(15000, 62), noteOff(15000, 69) };
+        scenarios.push_back(scenario);
+    }
+
+    return scenarios;
+}
+
+juce::AudioBuffer<float> EquivalenceHarness::renderReference(const EquivalenceScenario& scenario, bool doublePrecision)
+{
+    if (doublePrecision)
+    {
+        auto synth = std::make_unique<Reference::Synth<double>>();
+        return renderScenario<double>(*synth, scenario, false, [&](Reference::Synth<double>& s)
+        {
+            Reference::applyParameters(s, scenario.parameters, scenario.sampleRate);
+        });
+    }
+
+    auto synth = std::make_unique<Reference::Synth<float>>();
+    return renderScenario<float>(*synth, scenario, false, [&](Reference::Synth<float>& s)
+    {
+        Reference::applyParameters(s, scenario.parameters, float(scenario.sampleRate));
+    });
+}
+
+juce::AudioBuffer<float> EquivalenceHarness::render(const EquivalenceScenario& scenario, bool doublePrecision)
+{
+    if (doublePrecision)
+    {
+        auto synth = std::make_unique<Synth<double>>();
+        synth->controlIntervalMs = scenario.controlIntervalMs;
+        synth->filterSmoothingMs = scenario.filterSmoothingMs;
+        return renderScenario<double>(*synth, scenario, true, [&](Synth<double>& s)
+        {
+            scenario.parameters.applyTo(s, scenario.sampleRate);
+        });
+    }
+
+    auto synth = std::make_unique<Synth<float>>();
+    synth->controlIntervalMs = scenario.controlIntervalMs;
+    synth->filterSmoothingMs = scenario.filterSmoothingMs;
+    return renderScenario<float>(*synth, scenario, true, [&](Synth<float>& s)
+    {
+        scenario.parameters.applyTo(s, scenario.sampleRate);
+    });
+}
+
+float EquivalenceHarness::maxAbsError(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    float error = 0.0f;
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+    {
+        const float* x = a.getReadPointer(channel);
+        const float* y = b.getReadPointer(channel);
+        for (int i = 0; i < a.getNumSamples(); ++i)
+        {
+            error = std::max(error, std::abs(x[i] - y[i]));
+        }
+    }
+    return error;
+}
+
+float EquivalenceHarness::spectralDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    constexpr int fftOrder = 11;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int hopSize = fftSize / 2;
+    constexpr int numBins = fftSize / 2 + 1;
+    constexpr float floorDecibels = -120.0f;
+
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(size_t(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> frameA(size_t(fftSize * 2));
+    std::vector<float> frameB(size_t(fftSize * 2));
+
+    float worst = 0.0f;
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+    {
+        for (int start = 0; start < std::max(a.getNumSamples() - hopSize, 1); start += hopSize)
+        {
+            int length = std::min(fftSize, a.getNumSamples() - start);
+            std::fill(frameA.begin(), frameA.end(), 0.0f);
+            std::fill(frameB.begin(), frameB.end(), 0.0f);
+            std::copy_n(a.getReadPointer(channel, start), length, frameA.begin());
+            std::copy_n(b.getReadPointer(channel, start), length, frameB.begin());
+
+            window.multiplyWithWindowingTable(frameA.data(), size_t(fftSize));
+            window.multiplyWithWindowingTable(frameB.data(), size_t(fftSize));
+            fft.performFrequencyOnlyForwardTransform(frameA.data());
+            fft.performFrequencyOnlyForwardTransform(frameB.data());
+
+            float sum = 0.0f;
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                float dbA = juce::Decibels::gainToDecibels(frameA[size_t(bin)], floorDecibels);
+                float dbB = juce::Decibels::gainToDecibels(frameB[size_t(bin)], floorDecibels);
+                sum += (dbA - dbB) * (dbA - dbB);
+            }
+            worst = std::max(worst, std::sqrt(sum / float(numBins)));
+        }
+    }
+    return worst;
+}
+
+EquivalenceResult EquivalenceHarness::compare(const EquivalenceScenario& scenario,
+                                              const juce::AudioBuffer<float>& expected,
+                                              const juce::AudioBuffer<float>& actual)
+{
+    EquivalenceResult result;
+    result.name = scenario.name;
+    result.maxAbsError = maxAbsError(expected, actual);
+    result.spectralDifference = spectralDifference(expected, actual);
+    result.passed = result.maxAbsError <= scenario.maxAbsErrorTolerance
+                 && result.spectralDifference <= scenario.spectralDifferenceTolerance;
+    return result;
+}
+
+EquivalenceResult EquivalenceHarness::run(const EquivalenceScenario& scenario, const juce::File& fixtureDirectory,
+                                          bool doublePrecision)
+{
+    auto expected = renderReference(scenario, doublePrecision);
+    const int violationsBefore = RealtimeAudit::getViolationCount();
+    auto actual = render(scenario, doublePrecision);
+    auto result = compare(scenario, expected, actual);
+    result.realtimeViolations = RealtimeAudit::getViolationCount() - violationsBefore;
+    result.passed = result.passed && result.realtimeViolations == 0;
+
+    // The fixtures hold the float reference.
+    auto fixture = getFixtureFile(fixtureDirectory, scenario);
+    juce::AudioBuffer<float> golden;
+    if (!doublePrecision && fixture.existsAsFile() && readFixture(fixture, golden))
+    {
+        // 24-bit quantisation of the fixture is about 1.2e-7 full scale.
+        result.fixtureError = maxAbsError(golden, expected);
+        result.passed = result.passed && result.fixtureError <= 1.0e-6f;
+    }
+    return result;
+}
+
+std::vector<EquivalenceResult> EquivalenceHarness::runAll(const juce::File& fixtureDirectory, bool doublePrecision)
+{
+    std::vector<EquivalenceResult> results;
+    for (const auto& scenario : createDefaultScenarios())
+    {
+        results.push_back(run(scenario, fixtureDirectory, doublePrecision));
+    }
+    return results;
+}
+
+juce::File EquivalenceHarness::getFixtureFile(const juce::File& fixtureDirectory, const EquivalenceScenario& scenario)
+{
+    if (fixtureDirectory == juce::File())
+    {
+        return {};
+    }
+    return fixtureDirectory.getChildFile(scenario.name + ".flac");
+}
+
+bool EquivalenceHarness::writeFixture(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    file.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream = file.createOutputStream();
+    if (stream == nullptr)
+    {
+        return false;
+    }
+
+    juce::FlacAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatWriter> writer(flac.createWriterFor(stream.get(), sampleRate,
+                                                                         (unsigned int) buffer.getNumChannels(),
+                                                                         24, {}, 0));
+    if (writer == nullptr)
+    {
+        return false;
+    }
+
+    stream.release();  // now owned by the writer
+    return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+}
+
+bool EquivalenceHarness::readFixture(const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        return false;
+    }
+
+    buffer.setSize(int(reader->numChannels), int(reader->lengthInSamples));
+    return reader->read(&buffer, 0, int(reader->lengthInSamples), 0, true, true);
+}
+
+bool EquivalenceHarness::writeAllFixtures(const juce::File& fixtureDirectory)
+{
+    if (!fixtureDirectory.createDirectory())
+    {
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto& scenario : createDefaultScenarios())
+    {
+        ok = writeFixture(getFixtureFile(fixtureDirectory, scenario), renderReference(scenario), scenario.sampleRate) && ok;
+    }
+    return ok;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    EquivalenceHarness.h
+    Created: 18 Oct 2026 10:05:31am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Source/SynthParameters.h"
+
+// A scripted MIDI performance plus the tolerances the live engine has to meet
+// when it is rendered against the frozen reference engine.
+struct EquivalenceScenario
+{
+    struct Event
+    {
+        int samplePosition;
+        uint8_t data0, data1, data2;
+    };
+
+    juce::String name;
+    SynthParameters parameters;
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+    int numChannels = 2;
+    int lengthInSamples = 48000;
+    std::vector<Event> events;
+
+    // Control-rate settings for the live engine. Unlike the engine's own
+    // defaults these match the reference engine: a fixed 32-sample tick and
+    // 50 ms filter smoothing.
+    float controlIntervalMs = 0.0f;
+    float filterSmoothingMs = 50.0f;
+
+    float maxAbsErrorTolerance = 1.0e-5f;
+    float spectralDifferenceTolerance = 0.1f;  // dB, log-spectral distance
+};
+
+struct EquivalenceResult
+{
+    juce::String name;
+    float maxAbsError = 0.0f;
+    float spectralDifference = 0.0f;
+
+    // Blocking calls the live engine made while rendering; always 0 unless
+    // the runner is built with SUBSYNTH_REALTIME_AUDIT.
+    int realtimeViolations = 0;
+
+    // Largest difference between the reference render and its golden
+    // fixture, or -1 if there was no fixture to check against.
+    float fixtureError = -1.0f;
+    bool passed = false;
+};
+
+namespace EquivalenceHarness
+{
+    std::vector<EquivalenceScenario> createDefaultScenarios();
+
+    juce::AudioBuffer<float> renderReference(const EquivalenceScenario& scenario, bool doublePrecision = false);
+    juce::AudioBuffer<float> render(const EquivalenceScenario& scenario, bool doublePrecision = false);
+
+    // Largest per-sample difference across all channels.
+    float maxAbsError(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b);
+
+    // Worst per-frame RMS difference of the log magnitude spectra, in dB.
+    float spectralDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b);
+
+    EquivalenceResult compare(const EquivalenceScenario& scenario,
+                              const juce::AudioBuffer<float>& expected,
+                              const juce::AudioBuffer<float>& actual);
+
+    // Renders the scenario through both engines at the same precision. If a
+    // golden fixture for the scenario exists in fixtureDirectory, the float
+    // reference render is also checked against it, so a JUCE update cannot
+    // move the baseline.
+    EquivalenceResult run(const EquivalenceScenario& scenario, const juce::File& fixtureDirectory = {},
+                          bool doublePrecision = false);
+
+    std::vector<EquivalenceResult> runAll(const juce::File& fixtureDirectory = {}, bool doublePrecision = false);
+
+    // Golden renders are stored as 24-bit FLAC, which is lossless well below
+    // any tolerance used here and keeps the fixtures small.
+    juce::File getFixtureFile(const juce::File& fixtureDirectory, const EquivalenceScenario& scenario);
+    bool writeFixture(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate);
+    bool readFixture(const juce::File& file, juce::AudioBuffer<float>& buffer);
+    bool writeAllFixtures(const juce::File& fixtureDirectory);
+}
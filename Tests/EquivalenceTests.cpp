@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    EquivalenceTests.cpp
+    Created: 19 Oct 2026 9:41:03am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "EquivalenceHarness.h"
+#include "TestOptions.h"
+
+class EquivalenceTests : public juce::UnitTest
+{
+public:
+    EquivalenceTests() : juce::UnitTest("Equivalence", "SubSynth") {}
+
+    void runTest() override
+    {
+        const juce::File fixtures = TestOptions::get().fixtureDirectory;
+
+        if (TestOptions::get().writeFixtures)
+        {
+            beginTest("Write fixtures");
+            expect(EquivalenceHarness::writeAllFixtures(fixtures), "could not write to " + fixtures.getFullPathName());
+        }
+
+        for (bool doublePrecision : { false, true })
+        {
+            beginTest(doublePrecision ? "Double engine against the reference" : "Float engine against the reference");
+            for (const auto& result : EquivalenceHarness::runAll(fixtures, doublePrecision))
+            {
+                logMessage(result.name + ": max abs error " + juce::String(result.maxAbsError)
+                           + ", spectral difference " + juce::String(result.spectralDifference) + " dB"
+                           + ", fixture error " + juce::String(result.fixtureError));
+
+                // Without its fixture the reference could drift with JUCE and
+                // both renders would still agree.
+                expect(doublePrecision || result.fixtureError >= 0.0f,
+                       result.name + ": no golden fixture in " + fixtures.getFullPathName());
+                expect(result.realtimeViolations == 0, result.name + ": " + juce::String(result.realtimeViolations) + " blocking calls");
+                expect(result.passed, result.name + " is outside its tolerances");
+            }
+        }
+    }
+};
+
+static EquivalenceTests equivalenceTests;
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 9:38:47am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <JuceHeader.h>
+#include "TestOptions.h"
+
+// Runs the SubSynth unit tests and exits non-zero if any of them failed.
+//
+//     SubSynthTests [--fixtures <dir>] [--write-fixtures] [test name...]
+//
+// With names, only those tests run.
+int main(int argc, char* argv[])
+{
+    auto& options = TestOptions::get();
+    const juce::File workingDirectory = juce::File::getCurrentWorkingDirectory();
+    options.fixtureDirectory = workingDirectory.getChildFile("Tests/Fixtures");
+
+    juce::StringArray names;
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument(argv[i]);
+        if (argument == "--fixtures" && i + 1 < argc)
+        {
+            options.fixtureDirectory = workingDirectory.getChildFile(argv[++i]);
+        }
+        else if (argument == "--write-fixtures")
+        {
+            options.writeFixtures = true;
+        }
+        else if (argument.startsWith("--"))
+        {
+            std::cerr << "usage: SubSynthTests [--fixtures <dir>] [--write-fixtures] [test name...]" << std::endl;
+            return 2;
+        }
+        else
+        {
+            names.add(argument);
+        }
+    }
+
+    juce::Array<juce::UnitTest*> tests;
+    for (auto* test : juce::UnitTest::getAllTests())
+    {
+        if (test->getCategory() == "SubSynth" && (names.isEmpty() || names.contains(test->getName())))
+        {
+            tests.add(test);
+        }
+    }
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTests(tests);
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+    {
+        failures += runner.getResult(i)->failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
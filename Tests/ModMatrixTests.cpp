@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    ModMatrixTests.cpp
+    Created: 20 Oct 2026 9:37:15am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class ModMatrixTests : public juce::UnitTest
+{
+public:
+    ModMatrixTests() : juce::UnitTest("Mod matrix", "SubSynth") {}
+
+    void runTest() override
+    {
+        using Slots = std::array<ModSlot, ModMatrix::numSlots>;
+        constexpr float octave = 0.69314718056f;
+
+        beginTest("Duplicate routes merge, zero amounts drop and operations sort by destination");
+        {
+            const Slots slots = { {
+                { ModSource::lfo, ModDestination::cutoff, 0.5f },
+                { ModSource::velocity, ModDestination::pitch, 0.25f },
+                { ModSource::lfo, ModDestination::cutoff, 0.25f },
+                { ModSource::key, ModDestination::resonance, 0.0f },
+            } };
+            const ModProgram program = ModMatrix::compile(slots);
+
+            expectEquals(int(program.operations.size()), 2);
+            expectEquals(int(program.operations[0].destination), int(ModDestination::pitch));
+            expectEquals(int(program.operations[0].source), int(ModSource::velocity));
+            expectWithinAbsoluteError(program.operations[0].amount, 0.25f * octave, 1.0e-6f);
+            expectEquals(int(program.operations[1].destination), int(ModDestination::cutoff));
+            expectEquals(int(program.operations[1].source), int(ModSource::lfo));
+            expectWithinAbsoluteError(program.operations[1].amount, 0.75f * 4.0f * octave, 1.0e-6f);
+
+            expect(program.uses(ModSource::lfo) && program.uses(ModSource::velocity));
+            expect(!program.uses(ModSource::key) && !program.uses(ModSource::envelope));
+            expect(program.uses(ModDestination::pitch) && program.uses(ModDestination::cutoff));
+            expect(!program.uses(ModDestination::resonance) && !program.uses(ModDestination::oscBPitch));
+        }
+
+        beginTest("Routes that cancel out or lead nowhere compile to nothing");
+        {
+            const Slots slots = { {
+                { ModSource::lfo, ModDestination::pan, 0.5f },
+                { ModSource::lfo, ModDestination::pan, -0.5f },
+                { ModSource::none, ModDestination::cutoff, 1.0f },
+                { ModSource::velocity, ModDestination::none, 1.0f },
+            } };
+            const ModProgram program = ModMatrix::compile(slots);
+            expect(program.operations.empty());
+            expectEquals(int(program.sourceMask), 0);
+            expectEquals(int(program.destinationMask), 0);
+        }
+
+        beginTest("The newest routing is handed over, and an empty one clears it");
+        {
+            ModMatrix matrix;
+            expect(matrix.acquire() == nullptr);
+
+            // The first routing is superseded before the audio thread looks.
+            matrix.setRouting({ { { ModSource::lfo, ModDestination::cutoff, 1.0f } } });
+            matrix.setRouting({ { { ModSource::velocity, ModDestination::level, 1.0f } } });
+            const ModProgram* program = matrix.acquire();
+            expect(program != nullptr && program->uses(ModSource::velocity) && !program->uses(ModSource::lfo));
+
+            matrix.setRouting({ { { ModSource::key, ModDestination::pan, 1.0f } } });
+            program = matrix.acquire();
+            expect(program != nullptr && program->uses(ModDestination::pan) && !program->uses(ModDestination::level));
+
+            matrix.setRouting(Slots {});
+            expect(matrix.acquire() == nullptr);
+        }
+
+        beginTest("An empty matrix renders exactly what no matrix does");
+        {
+            const auto plain = render({}, nullptr);
+            const Slots empty {};
+            const auto routed = render({}, &empty);
+            expectEquals(getDifference(plain, routed), 0.0f);
+        }
+
+        beginTest("Every destination changes the output");
+        {
+            SynthParameters parameters;
+            parameters.noise = 50.0f;
+            parameters.oscMix = 50.0f;
+            parameters.filterFreq = 60.0f;
+            const auto plain = render(parameters, nullptr);
+
+            for (int d = 1; d < int(ModDestination::count); ++d)
+            {
+                const Slots slots = { { { ModSource::lfo, ModDestination(d), 0.5f } } };
+                const float difference = getDifference(plain, render(parameters, &slots));
+                expect(difference > 1.0e-3f, ModMatrix::getDestinationNames()[d] + ": " + juce::String(difference));
+            }
+        }
+
+        beginTest("Removing a pan or level route puts the voices back");
+        {
+            // Neither touches the oscillators or the filter, so once the
+            // route is gone the output is the unmodulated one again.
+            const Slots slots = { {
+                { ModSource::velocity, ModDestination::pan, 0.5f },
+                { ModSource::velocity, ModDestination::level, -0.5f },
+            } };
+            const auto plain = render({}, nullptr);
+            const auto routed = render({}, &slots, numBlocks / 2);
+
+            const size_t blockLength = 2 * size_t(blockSize);
+            const size_t half = size_t(numBlocks / 2) * blockLength;
+            const std::vector<float> plainFirst(plain.begin(), plain.begin() + std::ptrdiff_t(half));
+            const std::vector<float> routedFirst(routed.begin(), routed.begin() + std::ptrdiff_t(half));
+            expect(getDifference(plainFirst, routedFirst) > 1.0e-3f);
+
+            // One block for the removal to reach the engine.
+            const size_t settled = half + blockLength;
+            const std::vector<float> plainLast(plain.begin() + std::ptrdiff_t(settled), plain.end());
+            const std::vector<float> routedLast(routed.begin() + std::ptrdiff_t(settled), routed.end());
+            expectEquals(getDifference(plainLast, routedLast), 0.0f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numBlocks = 80;
+
+    // A held chord, with the routing set before the first block and, if
+    // removeAfter is positive, cleared after that many blocks. Returns both
+    // channels, one block after the other.
+    static std::vector<float> render(const SynthParameters& parameters,
+                                     const std::array<ModSlot, ModMatrix::numSlots>* slots, int removeAfter = 0)
+    {
+        Synth<float> synth;
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        parameters.applyTo(synth, sampleRate, 0);
+        if (slots != nullptr)
+        {
+            synth.modMatrix.setRouting(*slots);
+        }
+        for (const int note : { 48, 55, 64 })
+        {
+            synth.midiMessage(0x90, uint8_t(note), uint8_t(40 + note));
+        }
+
+        std::vector<float> output;
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            if (block == removeAfter && removeAfter > 0)
+            {
+                synth.modMatrix.setRouting({});
+            }
+            buffer.clear();
+            synth.render(buffer, 0, blockSize, 2);
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                output.insert(output.end(), buffer.getReadPointer(channel), buffer.getReadPointer(channel) + blockSize);
+            }
+        }
+        return output;
+    }
+
+    static float getDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float difference = 0.0f;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+        {
+            difference = std::max(difference, std::abs(a[i] - b[i]));
+        }
+        return difference;
+    }
+};
+
+static ModMatrixTests modMatrixTests;
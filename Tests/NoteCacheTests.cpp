@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    NoteCacheTests.cpp
+    Created: 19 Oct 2026 10:52:13pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class NoteCacheTests : public juce::UnitTest
+{
+public:
+    NoteCacheTests() : juce::UnitTest("Note cache", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A note without a filter envelope replays at any tick phase");
+        {
+            SynthParameters parameters;
+            parameters.filterEnv = 0.0f;
+            Synth<float> synth;
+            prepare(synth, parameters);
+
+            // The second note starts 12 samples later in the tick grid.
+            const auto first = playNote(synth, 5);
+            const auto second = playNote(synth, 17);
+            expectEquals(synth.getNoteCache().getHits(), 1);
+
+            float difference = 0.0f;
+            for (size_t i = 0; i < first.size(); ++i)
+            {
+                difference = std::max(difference, std::abs(first[i] - second[i]));
+            }
+            expectEquals(difference, 0.0f);
+        }
+
+        beginTest("A note with a filter envelope is keyed by its tick phase");
+        {
+            Synth<float> synth;
+            prepare(synth, SynthParameters());
+
+            playNote(synth, 5);
+            playNote(synth, 17);
+            expectEquals(synth.getNoteCache().getHits(), 0);
+            expectEquals(synth.getNoteCache().getMisses(), 2);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int noteLength = 24000;
+
+    static void prepare(Synth<float>& synth, const SynthParameters& parameters)
+    {
+        synth.noteCacheBytes = size_t(8) << 20;
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        parameters.applyTo(synth, sampleRate, 0);
+
+        // Long enough for every smoother to settle, which a cacheable part
+        // needs.
+        render(synth, 4 * int(sampleRate), nullptr);
+    }
+
+    // Plays one note after offset samples and lets it die out. Returns the
+    // left channel while the key is held.
+    static std::vector<float> playNote(Synth<float>& synth, int offset)
+    {
+        render(synth, offset, nullptr);
+        synth.midiMessage(0x90, 60, 100);
+        std::vector<float> output;
+        render(synth, noteLength, &output);
+        synth.midiMessage(0x80, 60, 0);
+        render(synth, 2 * int(sampleRate), nullptr);
+        return output;
+    }
+
+    static void render(Synth<float>& synth, int numSamples, std::vector<float>* output)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int length = std::min(blockSize, numSamples - start);
+            buffer.clear();
+            synth.render(buffer, 0, length, 2);
+            if (output != nullptr)
+            {
+                output->insert(output->end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + length);
+            }
+        }
+    }
+};
+
+static NoteCacheTests noteCacheTests;
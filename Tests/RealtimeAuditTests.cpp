@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    RealtimeAuditTests.cpp
+    Created: 19 Oct 2026 11:58:06pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <condition_variable>
+#include <mutex>
+#include "../Source/RealtimeAudit.h"
+
+class RealtimeAuditTests : public juce::UnitTest
+{
+public:
+    RealtimeAuditTests() : juce::UnitTest("Real-time audit", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("Blocking calls in a scope are reported, and only there");
+        {
+            if (!RealtimeAudit::isEnabled())
+            {
+                logMessage("Built without SUBSYNTH_REALTIME_AUDIT; nothing to check");
+                return;
+            }
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::unique_lock<std::mutex> lock(mutex);
+
+            // Waits on a condition variable go through pthread_cond_wait,
+            // pthread_cond_timedwait or pthread_cond_clockwait depending on
+            // the clock and the standard library.
+            expectReported("an allocation", [] { ::operator delete(::operator new(sizeof(int))); });
+            expectReported("a relative wait", [&] { condition.wait_for(lock, std::chrono::microseconds(10)); });
+            expectReported("a steady clock wait", [&] {
+                condition.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::microseconds(10));
+            });
+            expectReported("a system clock wait", [&] {
+                condition.wait_until(lock, std::chrono::system_clock::now() + std::chrono::microseconds(10));
+            });
+            expectReported("a WaitableEvent", [] { juce::WaitableEvent().wait(1); });
+
+            const int before = RealtimeAudit::getViolationCount();
+            {
+                SUBSYNTH_REALTIME_SCOPE;
+                SUBSYNTH_REALTIME_ALLOW;
+                condition.wait_for(lock, std::chrono::microseconds(10));
+            }
+            condition.wait_for(lock, std::chrono::microseconds(10));
+            expectEquals(RealtimeAudit::getViolationCount(), before);
+        }
+    }
+
+private:
+    template <typename Function>
+    void expectReported(const juce::String& name, Function&& function)
+    {
+        const int before = RealtimeAudit::getViolationCount();
+        {
+            SUBSYNTH_REALTIME_SCOPE;
+            function();
+        }
+        expect(RealtimeAudit::getViolationCount() > before, name + " was not reported");
+    }
+};
+
+static RealtimeAuditTests realtimeAuditTests;
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    ReducedRateTests.cpp
+    Created: 20 Oct 2026 12:31:47am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class ReducedRateTests : public juce::UnitTest
+{
+public:
+    ReducedRateTests() : juce::UnitTest("Reduced rate", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("The reported latency is the decimators' and interpolators' delay");
+        {
+            for (double hostRate : { 48000.0, 96000.0, 192000.0 })
+            {
+                for (int oversampling : { 1, 2, 4 })
+                {
+                    Synth<float> synth;
+                    synth.minInternalRate = 44100.0;
+                    synth.oversampling = oversampling;
+                    synth.allocateResources(hostRate, blockSize);
+
+                    const double measured = measureDelay(hostRate, synth.getRateDivisor(), oversampling);
+                    logMessage(juce::String(hostRate / 1000.0) + " kHz, " + juce::String(oversampling) + "x: reported "
+                               + juce::String(synth.getLatencySamples()) + ", measured " + juce::String(measured, 2));
+                    expect(std::abs(measured - synth.getLatencySamples()) < 0.6,
+                           "measured " + juce::String(measured, 2) + " samples");
+                }
+            }
+        }
+
+        beginTest("A reduced-rate render is the internal-rate render upsampled");
+        {
+            for (int rateDivisor : { 2, 4 })
+            {
+                Synth<float> reduced;
+                reduced.minInternalRate = 44100.0;
+                prepare(reduced, sampleRate * rateDivisor);
+                expectEquals(reduced.getRateDivisor(), rateDivisor);
+
+                Synth<float> internal;
+                prepare(internal, sampleRate);
+
+                std::array<HalfBandInterpolator<float>, 2> stages;
+                stages[0].prepare(0.1, -70);
+                stages[1].prepare(0.2, -70);
+
+                for (int note = 0; note < 4; ++note)
+                {
+                    reduced.midiMessage(0x90, uint8_t(48 + 7 * note), 100);
+                    internal.midiMessage(0x90, uint8_t(48 + 7 * note), 100);
+                }
+
+                // Host segments of any length, so internal samples are split
+                // across render() calls.
+                juce::Random random(rateDivisor);
+                juce::AudioBuffer<float> host(2, blockSize * rateDivisor);
+                juce::AudioBuffer<float> expected(2, blockSize * rateDivisor);
+                std::vector<float> pending[2];
+                float difference = 0.0f;
+                for (int segment = 0; segment < 400; ++segment)
+                {
+                    const int length = 1 + random.nextInt(blockSize * rateDivisor);
+                    host.clear();
+                    reduced.render(host, 0, length, 2);
+
+                    while (int(pending[0].size()) < length)
+                    {
+                        upsampleBlock(internal, stages, rateDivisor, expected);
+                        for (int channel = 0; channel < 2; ++channel)
+                        {
+                            pending[channel].insert(pending[channel].end(), expected.getReadPointer(channel),
+                                                    expected.getReadPointer(channel) + blockSize * rateDivisor);
+                        }
+                    }
+                    for (int channel = 0; channel < 2; ++channel)
+                    {
+                        for (int sample = 0; sample < length; ++sample)
+                        {
+                            difference = std::max(difference, std::abs(host.getSample(channel, sample)
+                                                                       - pending[channel][size_t(sample)]));
+                        }
+                        pending[channel].erase(pending[channel].begin(), pending[channel].begin() + length);
+                    }
+                }
+                expectEquals(difference, 0.0f);
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    static void prepare(Synth<float>& synth, double hostRate)
+    {
+        synth.allocateResources(hostRate, blockSize * 4);
+        synth.reset();
+        SynthParameters().applyTo(synth, hostRate / synth.getRateDivisor(), 0);
+    }
+
+    // Renders one block at the internal rate and upsamples it as the engine
+    // does: the stage next to the internal rate first.
+    static void upsampleBlock(Synth<float>& synth, std::array<HalfBandInterpolator<float>, 2>& stages, int rateDivisor,
+                              juce::AudioBuffer<float>& output)
+    {
+        juce::AudioBuffer<float> block(2, blockSize);
+        block.clear();
+        synth.render(block, 0, blockSize, 2);
+
+        const float* input[2] = { block.getReadPointer(0), block.getReadPointer(1) };
+        float* upsampled[2] = { output.getWritePointer(0), output.getWritePointer(1) };
+        if (rateDivisor == 2)
+        {
+            stages[0].process<2>(input, upsampled, blockSize);
+            return;
+        }
+        juce::AudioBuffer<float> middle(2, blockSize * 2);
+        float* halfway[2] = { middle.getWritePointer(0), middle.getWritePointer(1) };
+        stages[0].process<2>(input, halfway, blockSize);
+        const float* halfwayInput[2] = { middle.getReadPointer(0), middle.getReadPointer(1) };
+        stages[1].process<2>(halfwayInput, upsampled, blockSize * 2);
+    }
+
+    // Runs a 100 Hz sine through the decimators and interpolators set up as
+    // allocateResources() does and returns its delay in host samples, from
+    // the phase over a whole number of cycles.
+    static double measureDelay(double hostRate, int rateDivisor, int oversampling)
+    {
+        const double frequency = 100.0;
+        const int hostLength = int(hostRate);
+        const int internalLength = hostLength / rateDivisor;
+        const int oversampledLength = internalLength * oversampling;
+        const double oversampledRate = hostRate / rateDivisor * oversampling;
+
+        std::vector<float> signal(size_t(oversampledLength), 0.0f);
+        for (int i = 0; i < oversampledLength; ++i)
+        {
+            signal[size_t(i)] = float(std::sin(juce::MathConstants<double>::twoPi * frequency * i / oversampledRate));
+        }
+
+        // The stage next to the internal rate has the steep transition.
+        std::vector<HalfBandDecimator<float>> decimators(size_t(oversampling / 2));
+        if (oversampling == 4)
+        {
+            decimators[0].prepare(0.2, -70);
+        }
+        if (oversampling >= 2)
+        {
+            decimators.back().prepare(0.1, -70);
+        }
+        int length = oversampledLength;
+        for (auto& decimator : decimators)
+        {
+            float* channels[1] = { signal.data() };
+            length /= 2;
+            decimator.process<1>(channels, length);
+        }
+        signal.resize(size_t(length));
+
+        std::vector<HalfBandInterpolator<float>> interpolators(size_t(rateDivisor / 2));
+        if (rateDivisor >= 2)
+        {
+            interpolators[0].prepare(0.1, -70);
+        }
+        if (rateDivisor == 4)
+        {
+            interpolators[1].prepare(0.2, -70);
+        }
+        for (auto& interpolator : interpolators)
+        {
+            std::vector<float> upsampled(signal.size() * 2);
+            const float* input[1] = { signal.data() };
+            float* output[1] = { upsampled.data() };
+            interpolator.process<1>(input, output, int(signal.size()));
+            signal = std::move(upsampled);
+        }
+
+        // The second half of a second is 50 cycles.
+        double inPhase = 0.0;
+        double quadrature = 0.0;
+        for (int i = hostLength / 2; i < hostLength; ++i)
+        {
+            const double phase = juce::MathConstants<double>::twoPi * frequency * i / hostRate;
+            inPhase += signal[size_t(i)] * std::sin(phase);
+            quadrature += signal[size_t(i)] * std::cos(phase);
+        }
+        const double lag = std::atan2(-quadrature, inPhase);
+        return lag / (juce::MathConstants<double>::twoPi * frequency) * hostRate;
+    }
+};
+
+static ReducedRateTests reducedRateTests;
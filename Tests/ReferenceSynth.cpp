@@ -0,0 +1,393 @@
+/*
+  ==============================================================================
+
+    ReferenceSynth.cpp
+    Created: 18 Oct 2026 9:40:12am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "ReferenceSynth.h"
+
+namespace Reference
+{
+
+template <typename SampleType>
+Synth<SampleType>::Synth()
+{
+    this->sampleRate = 44100.0f;
+}
+
+template <typename SampleType>
+void Synth<SampleType>::allocateResources(double sampleRate, int samplesPerBlock)
+{
+    this->sampleRate = static_cast<SampleType>(sampleRate);
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = 1;
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices[i].filter.setMode(juce::dsp::LadderFilterMode::LPF12);
+        voices[i].filter.prepare(spec);
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::deallocateResources() { }
+
+template <typename SampleType>
+void Synth<SampleType>::reset()
+{
+    for (int i = 0; i < this->numVoices; ++i)
+    {
+        voices[i].reset();
+    }
+
+    noiseGenerator.reset();
+    pitchBend = 1.0f;
+    sustainPedalPressed = false;
+
+    outputLevelSmoother.reset(sampleRate, SampleType(0.05));
+    oscMixSmoother.reset(sampleRate, SampleType(0.0001));
+
+    lfo = 0.0f;
+    lfoStep = 0;
+
+    modWheel = 0.0f;
+
+    resonanceCtl = 1.0f;
+    filterCtl = 0.0f;
+
+    aftertouch = 0.0f;
+
+    filterSmoother = 0.0f;
+}
+
+template <typename SampleType>
+void Synth<SampleType>::render(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels)
+{
+    SampleType* leftOutputBuffer = buffer.getWritePointer(0) + bufferOffset;
+    SampleType* rightOutputBuffer = buffer.getWritePointer(1) + bufferOffset;
+
+
+    for (int i = 0; i < this->numVoices; ++i)
+    {
+        Voice<SampleType>& voice = voices[i];
+        if (voice.envelope.isActive())
+        {
+            voice.oscillatorA.setFrequency(voice.frequency * pitchBend);
+            voice.oscillatorB.setFrequency(voice.oscillatorA.freq * oscBTune);
+
+            voice.oscillatorA.amplitude = ((SampleType(0.004) * SampleType((voice.velocity + 64) * (voice.velocity + 64)) - 8.0f) / 127.0f) * 0.5f;
+            voice.oscillatorB.amplitude = voice.oscillatorA.amplitude * oscMixSmoother.getNextValue();
+            voice.filterQ = filterQ + resonanceCtl;
+            voice.pitchBend = pitchBend;
+            voice.filterEnvDepth = filterEnvDepth;
+        }
+    }
+
+    for (int sample = 0; sample < sampleCount; ++sample)
+    {
+        updateLFO();
+        SampleType outputL = 0.0f;
+        SampleType outputR = 0.0f;
+
+        for (int i = 0; i < this->numVoices; ++i)
+        {
+            Voice<SampleType>& voice = voices[i];
+            if (voice.envelope.isActive())
+            {
+                SampleType noise = noiseGenerator.nextValue() * noiseMix;
+                SampleType output = voice.render(noise);
+                outputL += output * voice.panLeft;
+                outputR += output * voice.panRight;
+            }
+        }
+
+        SampleType outputLevel = outputLevelSmoother.getNextValue();
+        outputL *= outputLevel;
+        outputR *= outputLevel;
+
+        if (numChannels > 1) {
+            leftOutputBuffer[sample] = outputL;
+            rightOutputBuffer[sample] = outputR;
+        } else {
+            leftOutputBuffer[sample] = (outputL + outputR) * 0.5f;
+        }
+    }
+    for (int i = 0; i < this->numVoices; ++i)
+    {
+        Voice<SampleType>& voice = voices[i];
+        if (!voice.envelope.isActive()) {
+            voice.envelope.reset();
+            voice.filter.reset();
+        }
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
+{
+    switch (data0 & 0xF0)
+    {
+        case 0x80:
+            noteOff(data1 & 0x7F);
+            break;
+
+        case 0x90: {
+            uint8_t note = data1 & 0x7F;
+            uint8_t velocity = data2 & 0x7F;
+            if (velocity > 0)
+            {
+                noteOn(note, velocity);
+            }
+            else
+            {
+                noteOff(note);
+            }
+            break;
+        }
+
+        case 0xE0:
+            pitchBend = std::exp(SampleType(0.000014102) * SampleType(data1 + 128 * data2 - 8192));
+            break;
+
+        case 0xB0:
+            controlChange(data1, data2);
+            break;
+
+        case 0xD0:
+            aftertouch = SampleType(0.0001) * SampleType(data1 * data1);
+            break;
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::controlChange(uint8_t data1, uint8_t data2)
+{
+    switch (data1) {
+        case 0x40:
+            sustainPedalPressed = (data2 >= 64);
+
+            if (!sustainPedalPressed) {
+                noteOff(-1);
+            }
+            break;
+
+        case 0x01:
+            modWheel = SampleType(0.000005) * SampleType(data2 * data2);
+            break;
+
+        case 0x47:
+            resonanceCtl = 154.0f / SampleType(154 - data2);
+            break;
+
+        // Filter +
+        case 0x4A:
+            filterCtl = SampleType(0.02) * SampleType(data2); break;
+        // Filter -
+        case 0x4B:
+            filterCtl = -SampleType(0.03) * SampleType(data2); break;
+
+        // All notes off
+        default:
+            if (data1 >= 0x78) {
+                for (int i = 0; i < this->numVoices; ++i) {
+                    voices[i].reset();
+                }
+                sustainPedalPressed = false;
+            }
+            break;
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::noteOn(int note, int velocity)
+{
+    if (this->ignoreVelocity) velocity = 80;
+    int voiceIndex = 0;
+    SampleType minAmp = 9999.0f;
+    for (int i = 0; i < this->numVoices; ++i)
+    {
+        if (!voices[i].envelope.isActive() || voices[i].note == note)
+        {
+            voiceIndex = i;
+            break;
+        }
+
+        if ((voices[i].velocity * voices[i].envelope.level) < minAmp && !voices[i].envelope.isInAttack()) {
+            minAmp = voices[i].velocity * voices[i].envelope.level;
+            voiceIndex = i;
+        }
+
+    }
+
+    Voice<SampleType>& voice = voices[voiceIndex];
+    voice.note = note;
+    SampleType frequency = 440.0f * std::exp2(SampleType(note - 69 + masterTune) / 12.0f);
+
+    voice.frequency = frequency;
+    voice.cutoff = frequency / juce::MathConstants<SampleType>::pi;
+    voice.cutoff *= std::exp(velocitySensitivity * SampleType(velocity - 64));
+    voice.velocity = velocity;
+    voice.updatePanning();
+
+    voice.oscillatorA.setSampleRate(this->sampleRate);
+    voice.oscillatorB.setSampleRate(this->sampleRate);
+
+    voice.oscillatorA.reset();
+    voice.oscillatorB.reset();
+
+    voice.envelope.attackA = envAttack;
+    voice.envelope.decayA = envDecay;
+    voice.envelope.sustainLevel = envSustain;
+    voice.envelope.releaseA = envRelease;
+    voice.envelope.attack();
+
+    voice.filterEnv.attackA = filterAttack;
+    voice.filterEnv.decayA = filterDecay;
+    voice.filterEnv.sustainLevel = filterSustain;
+    voice.filterEnv.releaseA = filterRelease;
+    voice.filterEnv.attack();
+}
+
+template <typename SampleType>
+void Synth<SampleType>::noteOff(int note)
+{
+    for (int i = 0; i < this->numVoices; ++i)
+    {
+        Voice<SampleType>& voice = voices[i];
+        if (voice.note == note)
+        {
+            if (sustainPedalPressed)
+            {
+                voice.note = -1;
+            }
+            else
+            {
+                voice.envelope.release();
+                voice.filterEnv.release();
+                voice.note = 0;
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void Synth<SampleType>::updateLFO()
+{
+
+    if (--lfoStep <= 0)
+    {
+        lfoStep = LFO_MAX;
+        lfo += lfoInc;
+        if (lfo > juce::MathConstants<SampleType>::pi)
+        {
+            lfo -= juce::MathConstants<SampleType>::twoPi;
+        }
+
+        const SampleType sine = std::sin(lfo);
+        SampleType vibratoMod = 1.0f + sine * (modWheel + vibrato);
+        SampleType pwm = 1.0f + sine * (modWheel + pwmDepth);
+
+        SampleType filterMod = filterKeyTracking + filterCtl + (filterLFODepth + aftertouch) * sine;
+
+        filterSmoother += SampleType(0.005) * (filterMod - filterSmoother);
+
+        for (int i = 0; i < numVoices; ++i)
+        {
+            Voice<SampleType>& voice = voices[i];
+            if (voice.envelope.isActive())
+            {
+                voice.oscillatorA.setFrequency(voice.oscillatorA.freq * vibratoMod);
+                voice.oscillatorB.setFrequency(voice.oscillatorB.freq * pwm);
+                voice.filterMod = filterSmoother;
+                voice.updateLFO();
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void applyParameters(Synth<SampleType>& synth, const SynthParameters& parameters, SampleType sampleRate)
+{
+    SampleType inverseSampleRate = 1.0f / sampleRate;
+
+    synth.envAttack = std::exp(-inverseSampleRate * std::exp(5.5f - SampleType(0.075) * SampleType(parameters.envAttack)));
+    synth.envDecay = std::exp(-inverseSampleRate * std::exp(5.5f - SampleType(0.075) * SampleType(parameters.envDecay)));
+
+    synth.envSustain = SampleType(parameters.envSustain) / 100.0f;
+
+    SampleType envRelease = SampleType(parameters.envRelease);
+    if (envRelease < 1.0f) {
+        synth.envRelease = 0.75f;
+    } else {
+        synth.envRelease = std::exp(-inverseSampleRate * std::exp(5.5f - SampleType(0.075) * envRelease));
+    }
+
+    SampleType noiseMix = SampleType(parameters.noise) / 100.0f;
+    noiseMix *= noiseMix;
+    synth.noiseMix = noiseMix * SampleType(0.1);
+
+    synth.oscMixSmoother.setTargetValue(SampleType(parameters.oscMix) / 100.0f);
+
+    SampleType semi = SampleType(parameters.oscTune);
+    SampleType cent = SampleType(parameters.oscFine) * SampleType(0.01);
+    synth.oscBTune = std::pow(SampleType(1.059463094359), semi + cent);
+
+    synth.masterTune = (SampleType(parameters.octave) * 12.0f) + (SampleType(parameters.tuning) / 100.0f);
+
+    synth.outputLevelSmoother.setTargetValue(juce::Decibels::decibelsToGain(SampleType(parameters.outputLevel)));
+
+    SampleType filterVelocity = SampleType(parameters.filterVelocity);
+    if (filterVelocity < -90.0f)
+    {
+        synth.velocitySensitivity = 0.0f;
+        synth.ignoreVelocity = true;
+    }
+    else
+    {
+        synth.velocitySensitivity = SampleType(0.0005) * filterVelocity;
+        synth.ignoreVelocity = false;
+    }
+
+    const SampleType inverseUpdateRate = inverseSampleRate * synth.LFO_MAX;
+    SampleType lfoRate = std::exp(7.0f * SampleType(parameters.lfoRate) - 4.0f);
+    synth.lfoInc = lfoRate * inverseUpdateRate * juce::MathConstants<SampleType>::twoPi;
+
+    SampleType vibrato = SampleType(parameters.vibrato) / 200.0f;
+    synth.vibrato = SampleType(0.2) * vibrato * vibrato;
+
+    synth.pwmDepth = synth.vibrato;
+    if (vibrato < 0.0f)
+    {
+        synth.vibrato = 0.0f;
+    }
+
+    synth.filterKeyTracking = SampleType(0.08) * SampleType(parameters.filterFreq) - 1.5f;
+
+    SampleType filterReso = SampleType(parameters.filterReso) / 100.0f;
+    synth.filterQ = std::exp(3.0f * filterReso);
+
+    SampleType filterLFO = SampleType(parameters.filterLFO) / 100.0f;
+    synth.filterLFODepth = 2.5f * filterLFO * filterLFO;
+
+    synth.filterAttack = std::exp(-inverseUpdateRate * std::exp(5.5f - SampleType(0.075) * SampleType(parameters.filterAttack)));
+    synth.filterDecay = std::exp(-inverseUpdateRate * std::exp(5.5f - SampleType(0.075) * SampleType(parameters.filterDecay)));
+    SampleType filterSustain = SampleType(parameters.filterSustain) / 100.0f;
+    synth.filterSustain = filterSustain * filterSustain;
+    synth.filterRelease = std::exp(-inverseUpdateRate * std::exp(5.5f - SampleType(0.075) * SampleType(parameters.filterRelease)));
+
+    synth.filterEnvDepth = SampleType(0.06) * SampleType(parameters.filterEnv);
+}
+
+template class Synth<float>;
+template class Synth<double>;
+template void applyParameters(Synth<float>&, const SynthParameters&, float);
+template void applyParameters(Synth<double>&, const SynthParameters&, double);
+
+}
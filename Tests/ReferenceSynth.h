@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+    ReferenceSynth.h
+    Created: 18 Oct 2026 9:40:12am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Source/SynthParameters.h"
+
+// Frozen copy of the original scalar engine (Oscillator, Envelope, Filter,
+// Voice and Synth as of v0.0.2). Optimised paths are checked against this by
+// the EquivalenceHarness, so nothing in here should ever be changed.
+//
+// It is templated on the sample type the same way the engine is, so the
+// double engine is checked against a double reference. The golden fixtures
+// pin the float instantiation to the original renders.
+namespace Reference
+{
+
+const float SILENCE = 0.0001f;
+
+template <typename SampleType>
+class Envelope {
+public:
+    SampleType level;
+
+    SampleType attackA;
+    SampleType decayA;
+    SampleType sustainLevel;
+    SampleType releaseA;
+
+    void reset()
+    {
+        level = 0.0f;
+        target = 0.0f;
+        a = 0.0f;
+    }
+
+    SampleType nextValue()
+    {
+        level = a * (level - target) + target;
+        if (level + target > 3.0f) {
+            target = sustainLevel;
+            a = decayA;
+        }
+        return level;
+    }
+
+    inline bool isActive() const
+    {
+        return level > SILENCE;
+    }
+
+    inline bool isInAttack() const
+    {
+        return target >= 2.0f;
+    }
+
+    void attack()
+    {
+        level += SILENCE + SILENCE;
+        target = 2.0f;
+        a = attackA;
+    }
+
+    void release()
+    {
+        target = 0.0f;
+        a = releaseA;
+    }
+
+private:
+    SampleType target;
+    SampleType a;
+};
+
+template <typename SampleType>
+class Oscillator
+{
+public:
+    SampleType amplitude;
+    SampleType sampleRate;
+    SampleType freq;
+    SampleType phase;
+
+    void setFrequency(SampleType freq)
+    {
+        this->freq = freq;
+        updateIncrement();
+    }
+
+    void setSampleRate(SampleType sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        this->nyquist = sampleRate / 2.0f;
+    }
+
+    void reset()
+    {
+        inc = 0.0f;
+        phase = 0.0f;
+        amplitude = 0.0f;
+    }
+
+    SampleType nextPolyBLEPSample()
+    {
+        SampleType t = phase;
+        SampleType value = 2.0f * t - 1.0f;
+
+        SampleType dt = inc;
+        if (t < dt)
+        {
+            t /= dt;
+            value -= (t + t - t * t - 1.0f);
+        }
+        else if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt;
+            value -= (t * t + t + t + 1.0f);
+        }
+
+        phase += inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+
+        return amplitude * value;
+    }
+
+    SampleType nextNaiveSample()
+    {
+        SampleType value = 2.0f * phase - 1.0f;
+
+        phase += inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+
+        return amplitude * value;
+    }
+
+    SampleType nextFourierSample()
+    {
+        SampleType value = 0.0f;
+        SampleType h = freq;
+        SampleType i = 1.0f;
+        SampleType m = SampleType(0.63661977236);
+
+        while (h < nyquist)
+        {
+            value += m * std::sin(juce::MathConstants<SampleType>::twoPi * phase * i) / i;
+            h += freq;
+            i += 1.0f;
+            m = -m;
+        }
+
+        phase += inc;
+        if (phase >= 1.0f) phase -= 1.0f;
+
+        return amplitude * value;
+    }
+
+private:
+    SampleType inc;
+    SampleType nyquist;
+
+    void updateIncrement()
+    {
+        inc = freq / sampleRate;
+    }
+};
+
+template <typename SampleType>
+class Filter : public juce::dsp::LadderFilter<SampleType>
+{
+public:
+    void updateCoefficients(SampleType cutoff, SampleType Q)
+    {
+        this->setCutoffFrequencyHz(cutoff);
+        this->setResonance(std::clamp(Q / SampleType(30), SampleType(0), SampleType(1)));
+    }
+
+    SampleType render(SampleType x)
+    {
+        this->updateSmoothers();
+        return this->processSample(x, 0);
+    }
+};
+
+template <typename SampleType>
+class NoiseGenerator
+{
+public:
+    void reset()
+    {
+        random.setSeed(2304);
+    }
+
+    SampleType nextValue()
+    {
+        return random.nextFloat() * 2 - 1;
+    }
+
+private:
+    juce::Random random;
+};
+
+template <typename SampleType>
+class Voice
+{
+public:
+    int note;
+    int velocity;
+    SampleType frequency;
+    Oscillator<SampleType> oscillatorA;
+    Oscillator<SampleType> oscillatorB;
+    Envelope<SampleType> envelope;
+    SampleType panLeft, panRight;
+    SampleType sawA = 0;
+    SampleType sawB = 0;
+    Filter<SampleType> filter;
+    SampleType cutoff;
+    SampleType filterMod;
+    SampleType filterQ;
+    SampleType pitchBend;
+    Envelope<SampleType> filterEnv;
+    SampleType filterEnvDepth;
+
+    void reset()
+    {
+        note = 0;
+
+        oscillatorA.reset();
+        oscillatorB.reset();
+        envelope.reset();
+
+        filter.reset();
+        filterEnv.reset();
+
+        panLeft = SampleType(0.707);
+        panRight = SampleType(0.707);
+    }
+
+    SampleType render(SampleType noise)
+    {
+        if (frequency < 40.0f)
+        {
+            sawA = oscillatorA.nextNaiveSample();
+            sawB = oscillatorB.nextNaiveSample();
+        }
+        else if (frequency < 1000.f)
+        {
+            sawA = oscillatorA.nextPolyBLEPSample();
+            sawB = oscillatorB.nextPolyBLEPSample();
+        }
+        else
+        {
+            sawA = oscillatorA.nextFourierSample();
+            sawB = oscillatorB.nextFourierSample();
+        }
+        return filter.render(sawA + sawB + (noise * (velocity / 127.0f))) * envelope.nextValue();
+    }
+
+    void updatePanning()
+    {
+        SampleType panning = std::clamp(SampleType(note - 60) / SampleType(96), SampleType(-0.3), SampleType(0.3));
+        panLeft = std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f - panning));
+        panRight = std::sin(juce::MathConstants<SampleType>::pi / 4 * (1.0f + panning));
+    }
+
+    void updateLFO()
+    {
+        SampleType fenv = filterEnv.nextValue();
+        SampleType modulatedCutoff = cutoff * std::exp(filterMod + filterEnvDepth * fenv) / pitchBend;
+        modulatedCutoff = std::clamp(modulatedCutoff, SampleType(20), SampleType(20000));
+        filter.updateCoefficients(modulatedCutoff, filterQ);
+    }
+};
+
+template <typename SampleType>
+class Synth
+{
+public:
+
+    Synth();
+
+    void allocateResources(double sampleRate, int samplesPerBlock);
+    void deallocateResources();
+
+    void reset();
+    void render(juce::AudioBuffer<SampleType>& buffer, int bufferOffset, int sampleCount, int numChannels);
+    void midiMessage(uint8_t data0, uint8_t data1, uint8_t data2);
+
+    SampleType noiseMix;
+    SampleType envAttack, envDecay, envSustain, envRelease;
+    SampleType oscBTune;
+    SampleType masterTune;
+
+    static constexpr int numVoices = 16;
+
+    juce::LinearSmoothedValue<SampleType> outputLevelSmoother;
+    juce::LinearSmoothedValue<SampleType> oscMixSmoother;
+
+    SampleType velocitySensitivity;
+    bool ignoreVelocity;
+
+    const int LFO_MAX = 32;
+    SampleType lfoInc;
+    SampleType vibrato;
+    SampleType pwmDepth;
+
+    SampleType filterKeyTracking;
+    SampleType filterQ;
+    SampleType filterLFODepth;
+
+    SampleType filterAttack, filterDecay, filterSustain, filterRelease;
+    SampleType filterEnvDepth;
+
+private:
+    void noteOn(int note, int velocity);
+    void noteOff(int note);
+
+    void controlChange(uint8_t data1, uint8_t data2);
+
+    SampleType sampleRate;
+
+    NoiseGenerator<SampleType> noiseGenerator;
+
+    SampleType pitchBend;
+
+    std::array<Voice<SampleType>, numVoices> voices;
+
+    bool sustainPedalPressed;
+
+    void updateLFO();
+    int lfoStep;
+    SampleType lfo;
+
+    SampleType modWheel;
+
+    SampleType resonanceCtl;
+    SampleType filterCtl;
+
+    SampleType aftertouch;
+
+    SampleType filterSmoother;
+};
+
+// The parameter mapping that SubSynthAudioProcessor::update() used for the
+// reference engine, frozen alongside it.
+template <typename SampleType>
+void applyParameters(Synth<SampleType>& synth, const SynthParameters& parameters, SampleType sampleRate);
+
+}
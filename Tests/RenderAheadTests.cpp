@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    RenderAheadTests.cpp
+    Created: 19 Oct 2026 6:40:15pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/RenderAhead.h"
+
+class RenderAheadTests : public juce::UnitTest
+{
+public:
+    RenderAheadTests() : juce::UnitTest("Render ahead", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("Host blocks of any size come out one maximum block late");
+        {
+            constexpr int maximumBlockSize = 1024;
+
+            // The render function writes the running sample count, so any
+            // gap, repeat or reordering shows up in the output.
+            double rendered = 0.0;
+            RenderAhead<float> renderAhead;
+            renderAhead.prepare(48000.0, maximumBlockSize, 2, [&rendered](juce::AudioBuffer<float>& block, juce::MidiBuffer&, bool)
+            {
+                for (int i = 0; i < block.getNumSamples(); ++i)
+                {
+                    for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                    {
+                        block.setSample(channel, i, float(rendered));
+                    }
+                    rendered += 1.0;
+                }
+            });
+            expectEquals(renderAhead.getLatencySamples(), maximumBlockSize);
+
+            // Mostly blocks far smaller than announced, which used to fill
+            // the job ring, and the odd one longer than announced.
+            juce::Random random(38);
+            juce::MidiBuffer midi;
+            int position = 0;
+            int errors = 0;
+            for (int block = 0; block < 2000; ++block)
+            {
+                const int numSamples = random.nextInt(10) == 0 ? 1 + random.nextInt(3 * maximumBlockSize)
+                                                               : 1 + random.nextInt(64);
+                juce::AudioBuffer<float> buffer(2, numSamples);
+                buffer.clear();
+                renderAhead.process(buffer, midi, block == 0);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float expected = float(std::max(position + i - maximumBlockSize, 0));
+                    if (buffer.getSample(0, i) != expected || buffer.getSample(1, i) != expected)
+                    {
+                        ++errors;
+                    }
+                }
+                position += numSamples;
+            }
+            expectEquals(errors, 0);
+            renderAhead.release();
+        }
+
+        beginTest("A MIDI flood is cut at the reserved size without allocating");
+        {
+            constexpr int maximumBlockSize = 256;
+            constexpr int eventsPerSample = RenderAhead<float>::maxEventsPerSample + 4;
+
+            // Counts the events each job gets and checks they are in order
+            // and inside it.
+            int received = 0;
+            int misplaced = 0;
+            RenderAhead<float> renderAhead;
+            renderAhead.prepare(48000.0, maximumBlockSize, 2, [&](juce::AudioBuffer<float>& block, juce::MidiBuffer& midi, bool)
+            {
+                int previous = 0;
+                for (const auto event : midi)
+                {
+                    if (event.samplePosition < previous || event.samplePosition >= block.getNumSamples())
+                    {
+                        ++misplaced;
+                    }
+                    previous = event.samplePosition;
+                    ++received;
+                }
+            });
+
+            juce::MidiBuffer midi;
+            midi.ensureSize(size_t(maximumBlockSize * eventsPerSample * 16));
+            const juce::uint8 noteOn[] = { 0x90, 60, 100 };
+            for (int sample = 0; sample < maximumBlockSize; ++sample)
+            {
+                for (int i = 0; i < eventsPerSample; ++i)
+                {
+                    midi.addEvent(noteOn, 3, sample);
+                }
+            }
+
+            const int before = RealtimeAudit::getViolationCount();
+            juce::AudioBuffer<float> buffer(2, maximumBlockSize);
+            constexpr int numBlocks = 8;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                SUBSYNTH_REALTIME_SCOPE;
+                renderAhead.process(buffer, midi, false);
+            }
+            renderAhead.release();
+
+            // The worker runs outside the audit's scope; only the audio
+            // thread's calls count.
+            expectEquals(RealtimeAudit::getViolationCount(), before);
+            expectEquals(misplaced, 0);
+
+            // Each block fills a job of its own. The audio thread has
+            // collected all but the last, which the worker may or may not
+            // have got to.
+            const int kept = maximumBlockSize * RenderAhead<float>::maxEventsPerSample;
+            expectEquals(renderAhead.getDroppedEventCount(), numBlocks * (maximumBlockSize * eventsPerSample - kept));
+            expect(received == (numBlocks - 1) * kept || received == numBlocks * kept, juce::String(received));
+        }
+    }
+};
+
+static RenderAheadTests renderAheadTests;
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    ReverbTests.cpp
+    Created: 19 Oct 2026 11:05:48am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/ConvolutionReverb.h"
+#include "TestOptions.h"
+
+class ReverbTests : public juce::UnitTest
+{
+public:
+    ReverbTests() : juce::UnitTest("Reverb", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("The partitioned room matches a direct convolution");
+        {
+            ConvolutionReverb reverb;
+            reverb.setDecay(decay);
+            reverb.setMix(1.0f);
+            reverb.prepare(sampleRate);
+
+            const auto impulseResponse = ConvolutionReverb::createImpulseResponse({}, decay, sampleRate);
+            expectWithinAbsoluteError(reverb.getLengthSeconds(), double(decay), 0.001);
+            expectConvolves(reverb, impulseResponse);
+        }
+
+        beginTest("An impulse response file is resampled and swapped in");
+        {
+            const juce::File file = TestOptions::get().fixtureDirectory.getChildFile("impulse-response-44k-mono.flac");
+            const auto impulseResponse = ConvolutionReverb::createImpulseResponse(file, decay, sampleRate);
+            expectEquals(impulseResponse.getNumChannels(), 1);
+            expectEquals(impulseResponse.getNumSamples(), int(0.4 * sampleRate));
+
+            ConvolutionReverb reverb;
+            reverb.setDecay(decay);
+            reverb.setMix(1.0f);
+            reverb.prepare(sampleRate);
+
+            // The file is read on the loader thread and picked up at the
+            // start of the next block.
+            reverb.loadImpulseResponse(file);
+            const double expectedLength = impulseResponse.getNumSamples() / sampleRate;
+            for (int attempt = 0; attempt < 500 && reverb.getLengthSeconds() != expectedLength; ++attempt)
+            {
+                juce::Thread::sleep(10);
+            }
+            expectEquals(reverb.getLengthSeconds(), expectedLength);
+            expect(reverb.getImpulseResponseFile() == file);
+
+            reverb.reset();
+            expectConvolves(reverb, impulseResponse);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr float decay = 0.5f;
+
+    // Feeds impulses on either side of head partition and tail block
+    // boundaries, in blocks of random sizes, and compares the result with
+    // the sum of scaled, shifted copies of the impulse response.
+    void expectConvolves(ConvolutionReverb& reverb, const juce::AudioBuffer<float>& impulseResponse)
+    {
+        const std::array<std::pair<int, float>, 6> impulses { {
+            { 0, 1.0f }, { 255, -0.5f }, { 4097, 0.25f }, { 8191, 0.75f }, { 8192, -0.25f }, { 20000, -1.0f }
+        } };
+        const int irLength = impulseResponse.getNumSamples();
+        const int length = 20000 + irLength + 4 * ConvolutionReverb::tailPartitionSize;
+
+        juce::AudioBuffer<float> output(2, length);
+        juce::AudioBuffer<float> expected(2, length);
+        output.clear();
+        expected.clear();
+        for (const auto& [position, gain] : impulses)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                output.setSample(channel, position, gain);
+                const int irChannel = std::min(channel, impulseResponse.getNumChannels() - 1);
+                expected.addFrom(channel, position, impulseResponse, irChannel, 0, std::min(irLength, length - position), gain);
+            }
+        }
+
+        juce::Random random(1);
+        for (int offset = 0; offset < length;)
+        {
+            const int numSamples = std::min(length - offset, 1 + random.nextInt(700));
+            float* channels[2] = { output.getWritePointer(0, offset), output.getWritePointer(1, offset) };
+            juce::AudioBuffer<float> block(channels, 2, numSamples);
+            reverb.process(block, true);
+            offset += numSamples;
+        }
+
+        float error = 0.0f;
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                error = std::max(error, std::abs(output.getSample(channel, i) - expected.getSample(channel, i)));
+            }
+        }
+        logMessage("max abs error " + juce::String(error));
+        expectLessThan(error, 1.0e-5f);
+        expectEquals(reverb.getTailOverruns(), 0);
+    }
+};
+
+static ReverbTests reverbTests;
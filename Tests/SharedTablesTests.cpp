@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SharedTablesTests.cpp
+    Created: 19 Oct 2026 8:12:37pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <thread>
+#include "../Source/SharedTables.h"
+
+class SharedTablesTests : public juce::UnitTest
+{
+public:
+    SharedTablesTests() : juce::UnitTest("Shared tables", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A slow build holds up only callers of the same table");
+        {
+            juce::WaitableEvent started, finish;
+            std::atomic<int> builds { 0 };
+            auto slowBuild = [&]
+            {
+                ++builds;
+                started.signal();
+                finish.wait();
+                return std::make_shared<const Table>(1.0, 0);
+            };
+
+            std::shared_ptr<const Table> first, second;
+            std::thread builder([&] { first = SharedTables::get<Table>("slow", 1.0, 0, slowBuild); });
+            expect(started.wait(5000));
+
+            // Used to wait behind the slow build for the registry's lock.
+            const auto other = SharedTables::get<Table>(2.0);
+            expect(other != nullptr);
+
+            std::thread waiter([&] { second = SharedTables::get<Table>("slow", 1.0, 0, slowBuild); });
+            juce::Thread::sleep(50);
+            finish.signal();
+            builder.join();
+            waiter.join();
+
+            expectEquals(builds.load(), 1);
+            expect(first != nullptr && first == second);
+        }
+
+        beginTest("A table that cannot be built is not kept");
+        {
+            auto failedBuild = [] { return std::shared_ptr<const Table>(); };
+            expect(SharedTables::get<Table>("missing", 1.0, 0, failedBuild) == nullptr);
+            expect(SharedTables::get<Table>("missing", 1.0, 0, [] { return std::make_shared<const Table>(1.0, 0); }) != nullptr);
+        }
+    }
+
+private:
+    struct Table
+    {
+        Table(double, int) {}
+    };
+};
+
+static SharedTablesTests sharedTablesTests;
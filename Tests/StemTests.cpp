@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    StemTests.cpp
+    Created: 20 Oct 2026 10:24:51am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class StemTests : public juce::UnitTest
+{
+public:
+    StemTests() : juce::UnitTest("Stems", "SubSynth") {}
+
+    void runTest() override
+    {
+        // At the host rate, oversampled (each stem through decimators of
+        // its own) and at a reduced internal rate (each stem through
+        // interpolators of its own).
+        const Setup setups[] = {
+            { "1x", sampleRate, 1, 0.0 },
+            { "2x oversampled", sampleRate, 2, 0.0 },
+            { "4x oversampled", sampleRate, 4, 0.0 },
+            { "reduced rate", sampleRate * 2, 1, 44100.0 },
+        };
+
+        for (const auto& setup : setups)
+        {
+            // The main output is what the plugin's dry bus carries.
+            beginTest(juce::String("Stems sum to the main output, ") + setup.name);
+            {
+                const auto both = render(setup, { 2, 4 }, 2);
+                expect(getMagnitude(both, 2) > 0.01f && getMagnitude(both, 4) > 0.01f);
+                expectLessThan(getSumDifference(both, 0, 2, 4), tolerance);
+                expectLessThan(getSumDifference(both, 1, 3, 5), tolerance);
+            }
+
+            beginTest(juce::String("A part without a stem only reaches the main output, ") + setup.name);
+            {
+                const auto both = render(setup, { 2, 4 }, 2);
+                const auto first = render(setup, { 2, -1 }, 2);
+
+                // Its stem channels are left alone, and the other part's
+                // stem is unchanged.
+                expectEquals(getMagnitude(first, 4), 0.0f);
+                expectEquals(getMagnitude(first, 5), 0.0f);
+                expectEquals(getDifference(first, 2, both, 2), 0.0f);
+                expectEquals(getDifference(first, 3, both, 3), 0.0f);
+
+                // The main output still carries it.
+                expectLessThan(getDifference(first, 0, both, 0), tolerance);
+                expectLessThan(getDifference(first, 1, both, 1), tolerance);
+                expectLessThan(getSumDifference(first, 0, 2, 4, &both), tolerance);
+            }
+
+            beginTest(juce::String("A mono output is half of left plus right, ") + setup.name);
+            {
+                const auto stereo = render(setup, { 2, 4 }, 2);
+                const auto mono = render(setup, { 2, 4 }, 1);
+
+                float difference = 0.0f;
+                for (int sample = 0; sample < stereo.getNumSamples(); ++sample)
+                {
+                    const float half = 0.5f * (stereo.getSample(0, sample) + stereo.getSample(1, sample));
+                    difference = std::max(difference, std::abs(mono.getSample(0, sample) - half));
+                }
+                expectLessThan(difference, tolerance);
+
+                // The stems stay stereo.
+                for (int channel = 2; channel < 6; ++channel)
+                {
+                    expectEquals(getDifference(mono, channel, stereo, channel), 0.0f);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numBlocks = 48;
+    static constexpr float tolerance = 1.0e-5f;
+
+    struct Setup
+    {
+        const char* name;
+        double hostRate;
+        int oversampling;
+        double minInternalRate;
+    };
+
+    // Two parts, each playing a chord of its own and with its stem in the
+    // given channel or none (-1). Returns the six channels: main, then the
+    // two stems' places.
+    static juce::AudioBuffer<float> render(const Setup& setup, std::array<int, 2> stems, int numChannels)
+    {
+        Synth<float> synth;
+        synth.multitimbral = true;
+        synth.oversampling = setup.oversampling;
+        synth.minInternalRate = setup.minInternalRate;
+        synth.stemChannels[0] = stems[0];
+        synth.stemChannels[1] = stems[1];
+        synth.allocateResources(setup.hostRate, blockSize);
+        synth.reset();
+
+        const double internalRate = setup.hostRate / synth.getRateDivisor();
+        SynthParameters parameters;
+        parameters.applyTo(synth, internalRate, 0);
+        parameters.filterFreq = 70.0f;
+        parameters.oscMix = 40.0f;
+        parameters.applyTo(synth, internalRate, 1);
+
+        for (const int note : { 48, 55, 64 })
+        {
+            synth.midiMessage(0x90, uint8_t(note), 100);
+        }
+        for (const int note : { 60, 67 })
+        {
+            synth.midiMessage(0x91, uint8_t(note), 90);
+        }
+
+        juce::AudioBuffer<float> output(6, blockSize * numBlocks);
+        output.clear();
+        juce::AudioBuffer<float> block(6, blockSize);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            block.clear();
+            synth.render(block, 0, blockSize, numChannels);
+            for (int channel = 0; channel < 6; ++channel)
+            {
+                output.copyFrom(channel, b * blockSize, block, channel, 0, blockSize);
+            }
+        }
+        return output;
+    }
+
+    static float getMagnitude(const juce::AudioBuffer<float>& buffer, int channel)
+    {
+        return buffer.getMagnitude(channel, 0, buffer.getNumSamples());
+    }
+
+    static float getDifference(const juce::AudioBuffer<float>& a, int channelA, const juce::AudioBuffer<float>& b, int channelB)
+    {
+        float difference = 0.0f;
+        for (int sample = 0; sample < a.getNumSamples(); ++sample)
+        {
+            difference = std::max(difference, std::abs(a.getSample(channelA, sample) - b.getSample(channelB, sample)));
+        }
+        return difference;
+    }
+
+    // How far the main channel is from the sum of the two stem channels,
+    // taking the second stem from other if given.
+    static float getSumDifference(const juce::AudioBuffer<float>& buffer, int main, int first, int second,
+                                  const juce::AudioBuffer<float>* other = nullptr)
+    {
+        const auto& secondBuffer = other != nullptr ? *other : buffer;
+        float difference = 0.0f;
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        {
+            const float sum = buffer.getSample(first, sample) + secondBuffer.getSample(second, sample);
+            difference = std::max(difference, std::abs(buffer.getSample(main, sample) - sum));
+        }
+        return difference;
+    }
+};
+
+static StemTests stemTests;
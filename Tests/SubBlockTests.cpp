@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    SubBlockTests.cpp
+    Created: 20 Oct 2026 1:14:22am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class SubBlockTests : public juce::UnitTest
+{
+public:
+    SubBlockTests() : juce::UnitTest("Sub-blocks", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A sub-block started by a MIDI message ends on a tick");
+        {
+            Synth<float> synth;
+            prepare(synth);
+            const int interval = synth.getControlInterval();
+            const int length = synth.getSubBlockLength();
+            expect(length > interval);
+
+            // Ticks fall on every interval from the reset; the note lands
+            // seven samples after one.
+            render(synth, 5 * interval + 7);
+            synth.midiMessage(0x90, 60, 100);
+            const int before = synth.getSubBlockCount();
+            render(synth, length - 7);
+            expectEquals(synth.getSubBlockCount(), before + 1);
+
+            // The next sub-block starts on the following tick and runs a
+            // full length.
+            render(synth, 1);
+            expectEquals(synth.getSubBlockCount(), before + 2);
+            render(synth, length - 1);
+            expectEquals(synth.getSubBlockCount(), before + 2);
+            render(synth, 1);
+            expectEquals(synth.getSubBlockCount(), before + 3);
+        }
+
+        beginTest("The output does not depend on the host block size");
+        {
+            const auto expected = renderPattern(8192);
+            for (int blockSize : { 3, 16, 64, 1024 })
+            {
+                const auto output = renderPattern(blockSize);
+                float difference = 0.0f;
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    difference = std::max(difference, std::abs(output[i] - expected[i]));
+                }
+                expectEquals(difference, 0.0f, juce::String(blockSize) + "-sample blocks");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int maxBlockSize = 8192;
+
+    static void prepare(Synth<float>& synth)
+    {
+        synth.subBlockSize = 64;
+        synth.allocateResources(sampleRate, maxBlockSize);
+        synth.reset();
+        SynthParameters().applyTo(synth, sampleRate, 0);
+    }
+
+    static void render(Synth<float>& synth, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer(2, numSamples);
+        buffer.clear();
+        synth.render(buffer, 0, numSamples, 2);
+    }
+
+    // Held notes starting and stopping off the tick grid, in host blocks
+    // of blockSize samples split at each message. Returns the left channel.
+    static std::vector<float> renderPattern(int blockSize)
+    {
+        struct Event
+        {
+            int sample;
+            uint8_t status;
+            uint8_t note;
+        };
+        const Event events[] = {
+            { 101, 0x90, 48 }, { 4013, 0x90, 55 }, { 9377, 0x80, 48 },
+            { 12001, 0x90, 62 }, { 20009, 0x80, 55 }, { 27113, 0x80, 62 },
+        };
+        const int length = 32768;
+
+        Synth<float> synth;
+        prepare(synth);
+        juce::AudioBuffer<float> buffer(2, maxBlockSize);
+        std::vector<float> output;
+        size_t next = 0;
+        for (int position = 0; position < length;)
+        {
+            while (next < std::size(events) && events[next].sample == position)
+            {
+                synth.midiMessage(events[next].status, events[next].note, 100);
+                ++next;
+            }
+            int end = std::min(position + blockSize - position % blockSize, length);
+            if (next < std::size(events))
+            {
+                end = std::min(end, events[next].sample);
+            }
+            buffer.clear();
+            synth.render(buffer, 0, end - position, 2);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + end - position);
+            position = end;
+        }
+        return output;
+    }
+};
+
+static SubBlockTests subBlockTests;
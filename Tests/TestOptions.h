@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    TestOptions.h
+    Created: 19 Oct 2026 9:40:12am
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Settings the test runner takes from its command line.
+struct TestOptions
+{
+    // Where the golden renders live; Tests/Fixtures under the working
+    // directory unless --fixtures says otherwise.
+    juce::File fixtureDirectory;
+
+    // Re-render the golden fixtures from the reference engine first.
+    bool writeFixtures = false;
+
+    static TestOptions& get()
+    {
+        static TestOptions options;
+        return options;
+    }
+};
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    TracerTests.cpp
+    Created: 19 Oct 2026 5:31:09pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Tracer.h"
+
+class TracerTests : public juce::UnitTest
+{
+public:
+    TracerTests() : juce::UnitTest("Tracer", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("A new trace drops events left over from the last one");
+        {
+            const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory);
+            const auto firstFile = directory.getNonexistentChildFile("subsynth-trace", ".json");
+            auto& tracer = Tracer::getInstance();
+
+            expect(tracer.start(firstFile));
+            expect(Tracer::isEnabled());
+            SUBSYNTH_TRACE_INSTANT("first", 1);
+            {
+                // Still open when the trace stops, so it lands in the ring
+                // after stop() has drained it.
+                SUBSYNTH_TRACE_SCOPE("stale", 2);
+                tracer.stop();
+            }
+            expect(!Tracer::isEnabled());
+
+            const auto secondFile = directory.getNonexistentChildFile("subsynth-trace", ".json");
+            expect(tracer.start(secondFile));
+            SUBSYNTH_TRACE_INSTANT("second", 3);
+            tracer.stop();
+
+            const auto first = firstFile.loadFileAsString();
+            const auto second = secondFile.loadFileAsString();
+            expect(first.contains("\"first\""));
+            expect(!first.contains("\"stale\""));
+            expect(second.contains("\"second\""));
+            expect(!second.contains("\"stale\""));
+            expect(second.startsWith("{\"traceEvents\":[") && second.trim().endsWith("]}"));
+
+            firstFile.deleteFile();
+            secondFile.deleteFile();
+        }
+    }
+};
+
+static TracerTests tracerTests;
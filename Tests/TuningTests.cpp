@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    TuningTests.cpp
+    Created: 19 Oct 2026 9:26:44pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class TuningTests : public juce::UnitTest
+{
+public:
+    TuningTests() : juce::UnitTest("Tuning", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("Tuning SysEx retunes the engine at its own sample");
+        {
+            // Real-time single note change: middle C to a quarter tone above
+            // C#.
+            const std::vector<uint8_t> sysEx { 0xf0, 0x7f, 0x7f, 0x08, 0x02, 0x00, 0x01,
+                                               60, 61, 0x20, 0x00, 0xf7 };
+
+            // One engine is retuned mid-block with no message thread
+            // involved, as in an offline bounce; the other plays a tuning
+            // built from the same message from the start.
+            Synth<float> retuned;
+            Synth<float> published;
+            prepare(retuned);
+            prepare(published);
+            published.tuning.publish(Tuning().withSysEx(sysEx.data(), int(sysEx.size())));
+
+            juce::AudioBuffer<float> outputA(2, blockSize);
+            juce::AudioBuffer<float> outputB(2, blockSize);
+            outputA.clear();
+            outputB.clear();
+            retuned.render(outputA, 0, 100, 2);
+            published.render(outputB, 0, 100, 2);
+
+            expect(retuned.retune(sysEx.data(), int(sysEx.size())));
+            expectEquals(retuned.getPart(0).noteFrequencies[60], published.getPart(0).noteFrequencies[60]);
+            expectEquals(retuned.getPart(0).noteFrequencies[61], published.getPart(0).noteFrequencies[61]);
+
+            retuned.midiMessage(0x90, 60, 100);
+            published.midiMessage(0x90, 60, 100);
+            retuned.render(outputA, 100, blockSize - 100, 2);
+            published.render(outputB, 100, blockSize - 100, 2);
+
+            float difference = 0.0f;
+            for (int block = 0; block < 16; ++block)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int sample = 0; sample < blockSize; ++sample)
+                    {
+                        difference = std::max(difference, std::abs(outputA.getSample(channel, sample)
+                                                                   - outputB.getSample(channel, sample)));
+                    }
+                }
+                outputA.clear();
+                outputB.clear();
+                retuned.render(outputA, 0, blockSize, 2);
+                published.render(outputB, 0, blockSize, 2);
+            }
+            expectEquals(difference, 0.0f);
+        }
+
+        beginTest("A malformed tuning message is ignored");
+        {
+            Synth<float> synth;
+            prepare(synth);
+            const float before = synth.getPart(0).noteFrequencies[60];
+
+            // The change count says two, but only one change follows.
+            const std::vector<uint8_t> sysEx { 0xf0, 0x7f, 0x7f, 0x08, 0x02, 0x00, 0x02,
+                                               60, 61, 0x20, 0x00, 0xf7 };
+            expect(!synth.retune(sysEx.data(), int(sysEx.size())));
+            expectEquals(synth.getPart(0).noteFrequencies[60], before);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    static void prepare(Synth<float>& synth)
+    {
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        SynthParameters().applyTo(synth, sampleRate, 0);
+    }
+};
+
+static TuningTests tuningTests;
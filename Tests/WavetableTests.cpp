@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    WavetableTests.cpp
+    Created: 19 Oct 2026 4:48:21pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+#include "TestOptions.h"
+
+class WavetableTests : public juce::UnitTest
+{
+public:
+    WavetableTests() : juce::UnitTest("Wavetable", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("Each part plays its own table");
+        {
+            const juce::File file = TestOptions::get().fixtureDirectory.getChildFile("wavetable-single-cycle.flac");
+
+            Synth<float> synth;
+            Synth<float> sawOnly;
+            prepare(synth);
+            prepare(sawOnly);
+
+            // The tables are loaded on the loader thread and picked up at the
+            // start of the next block.
+            synth.wavetables[1].load(file);
+            synth.wavetables[2].load(file);
+            juce::AudioBuffer<float> block(2, blockSize);
+            for (int attempt = 0; attempt < 500 && (synth.getPart(1).wavetable == nullptr
+                                                    || synth.getPart(2).wavetable == nullptr); ++attempt)
+            {
+                juce::Thread::sleep(10);
+                synth.render(block, 0, blockSize, 2);
+            }
+            expect(synth.getPart(1).wavetable != nullptr);
+            expect(synth.getPart(0).wavetable == nullptr);
+            expect(synth.getPart(1).wavetable == synth.getPart(2).wavetable);
+            expect(synth.wavetables[1].getFile() == file);
+
+            // Part 0 keeps the saw oscillators, part 1 does not.
+            synth.reset();
+            sawOnly.reset();
+            expectEquals(maxDifference(synth, sawOnly, 0), 0.0f);
+            expectGreaterThan(maxDifference(synth, sawOnly, 1), 1.0e-3f);
+
+            // Switching part 1 back to the saws releases its table.
+            synth.wavetables[1].load({});
+            for (int attempt = 0; attempt < 500 && synth.getPart(1).wavetable != nullptr; ++attempt)
+            {
+                juce::Thread::sleep(10);
+                synth.render(block, 0, blockSize, 2);
+                synth.wavetables[1].collectGarbage();
+            }
+            expect(synth.getPart(1).wavetable == nullptr);
+            expect(synth.getPart(2).wavetable != nullptr);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    static void prepare(Synth<float>& synth)
+    {
+        synth.multitimbral = true;
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        for (int part = 0; part < Synth<float>::numParts; ++part)
+        {
+            SynthParameters().applyTo(synth, sampleRate, part);
+        }
+    }
+
+    // Plays a note on one part of both synths and returns how far apart
+    // they end up.
+    static float maxDifference(Synth<float>& a, Synth<float>& b, int part)
+    {
+        juce::AudioBuffer<float> outputA(2, blockSize);
+        juce::AudioBuffer<float> outputB(2, blockSize);
+        const uint8_t noteOn = uint8_t(0x90 | part);
+        a.midiMessage(noteOn, 60, 100);
+        b.midiMessage(noteOn, 60, 100);
+
+        float difference = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            outputA.clear();
+            outputB.clear();
+            a.render(outputA, 0, blockSize, 2);
+            b.render(outputB, 0, blockSize, 2);
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int sample = 0; sample < blockSize; ++sample)
+                {
+                    difference = std::max(difference, std::abs(outputA.getSample(channel, sample)
+                                                               - outputB.getSample(channel, sample)));
+                }
+            }
+        }
+
+        a.midiMessage(uint8_t(0x80 | part), 60, 0);
+        b.midiMessage(uint8_t(0x80 | part), 60, 0);
+        return difference;
+    }
+};
+
+static WavetableTests wavetableTests;
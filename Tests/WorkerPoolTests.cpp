@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    WorkerPoolTests.cpp
+    Created: 19 Oct 2026 11:24:50pm
+    Author:  Sharavanan Balasundaravel
+
+  ==============================================================================
+*/
+
+#include <thread>
+#include "../Source/Synth.h"
+#include "../Source/SynthParameters.h"
+
+class WorkerPoolTests : public juce::UnitTest
+{
+public:
+    WorkerPoolTests() : juce::UnitTest("Worker pool", "SubSynth") {}
+
+    void runTest() override
+    {
+        beginTest("Every task of every batch runs once, with several submitters");
+        {
+            WorkerPool pool(3);
+
+            // More submitters than the pool has workers, so batches are
+            // run by their own thread, by workers and by each other.
+            std::atomic<int> errors { 0 };
+            std::vector<std::thread> submitters;
+            for (int s = 0; s < 4; ++s)
+            {
+                submitters.emplace_back([&pool, &errors, s]
+                {
+                    CountingBatch batch;
+                    for (int round = 0; round < 500; ++round)
+                    {
+                        const int numTasks = 2 + (round * 7 + s) % (CountingBatch::maxTasks - 1);
+                        batch.clear();
+                        pool.run(batch, numTasks);
+                        for (int task = 0; task < CountingBatch::maxTasks; ++task)
+                        {
+                            if (batch.counts[size_t(task)].load() != (task < numTasks ? 1 : 0))
+                            {
+                                ++errors;
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto& submitter : submitters)
+            {
+                submitter.join();
+            }
+            expectEquals(errors.load(), 0);
+        }
+
+        beginTest("A full chord at 1x renders in batches, the same as without the pool");
+        {
+            WorkerPool pool(3);
+            Synth<float> parallel;
+            Synth<float> serial;
+            parallel.workerPool = &pool;
+            prepare(parallel);
+            prepare(serial);
+
+            juce::AudioBuffer<float> outputA(2, blockSize);
+            juce::AudioBuffer<float> outputB(2, blockSize);
+            float difference = 0.0f;
+            for (int block = 0; block < 200; ++block)
+            {
+                if (block == 0)
+                {
+                    for (int note = 0; note < Synth<float>::numVoices; ++note)
+                    {
+                        parallel.midiMessage(0x90, uint8_t(36 + 3 * note), 100);
+                        serial.midiMessage(0x90, uint8_t(36 + 3 * note), 100);
+                    }
+                }
+                outputA.clear();
+                outputB.clear();
+                parallel.render(outputA, 0, blockSize, 2);
+                serial.render(outputB, 0, blockSize, 2);
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int sample = 0; sample < blockSize; ++sample)
+                    {
+                        difference = std::max(difference, std::abs(outputA.getSample(channel, sample)
+                                                                   - outputB.getSample(channel, sample)));
+                    }
+                }
+            }
+            expectEquals(difference, 0.0f);
+            expectGreaterThan(parallel.getParallelBatchCount(), 0);
+            expectEquals(serial.getParallelBatchCount(), 0);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    struct CountingBatch : WorkerPool::Batch
+    {
+        static constexpr int maxTasks = 40;
+        std::array<std::atomic<int>, maxTasks> counts;
+
+        void clear()
+        {
+            for (auto& count : counts)
+            {
+                count.store(0);
+            }
+        }
+
+        void runTask(int index) override
+        {
+            counts[size_t(index)].fetch_add(1);
+        }
+    };
+
+    static void prepare(Synth<float>& synth)
+    {
+        synth.allocateResources(sampleRate, blockSize);
+        synth.reset();
+        SynthParameters().applyTo(synth, sampleRate, 0);
+    }
+};
+
+static WorkerPoolTests workerPoolTests;